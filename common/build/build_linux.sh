@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# Builds a headless target with the system C++ compiler.
+# Usage: build_linux.sh <target_name> <debug|release> [extra cpp files...]
+
+my_dir=$(cd "$(dirname "$0")" && pwd)
+target_name=$1
+debug_mode=$2
+shift 2
+
+targets="$my_dir/unity_headless.cpp $my_dir/../../$target_name/build/unity_$target_name.cpp $*"
+out_dir="$my_dir/../../$target_name/build/linux_$debug_mode"
+
+echo "Building $target_name - Linux $debug_mode"
+
+# Create build output directory
+mkdir -p "$out_dir"
+
+optimization="-O2 -DNDEBUG"
+if [ "$debug_mode" = "debug" ]; then optimization="-O0"; fi
+
+# Invoke compiler, flags mirror build_win.bat (no exceptions or RTTI, fast floating point). Extra
+# flags such as -DALLOC_PROFILE=1 can be passed in CXXFLAGS. The malloc family is wrapped so the
+# allocation profiler sees it.
+${CXX:-c++} \
+	$optimization \
+	$CXXFLAGS \
+	-g \
+	-Wall -Wno-unused-function \
+	-std=c++17 \
+	-march=native -fno-exceptions -fno-rtti -ffast-math \
+	-pthread \
+	-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free \
+	$targets \
+	-o "$out_dir/$target_name"
@@ -1,6 +1,10 @@
 #include "../src/common.h"
 
 // Our cpp files to be compiled
+#include "../src/alloc_profile.cpp"
 #include "../src/app.cpp"
 #include "../src/debug.cpp"
+#include "../src/frame_arena.cpp"
+#include "../src/sprite_atlas.cpp"
+#include "../src/sprite_layer.cpp"
 #include "../src/sprite_batch.cpp"
\ No newline at end of file
@@ -0,0 +1,8 @@
+#include "../src/headless.h"
+
+// Our cpp files to be compiled
+#include "../src/alloc_profile.cpp"
+#include "../src/debug.cpp"
+#include "../src/frame_arena.cpp"
+#include "../src/sprite_atlas.cpp"
+#include "../src/sprite_layer.cpp"
\ No newline at end of file
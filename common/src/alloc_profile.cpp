@@ -0,0 +1,505 @@
+/*
+	Underlying allocator. On Linux the build wraps malloc, calloc, realloc and free so calls in our
+	code land in the __wrap_ functions below, and __real_ reaches the C runtime.
+*/
+#ifdef _MSC_VER
+	static void* alloc_raw_malloc(size_t size)					{ return malloc(size); }
+	static void alloc_raw_free(void* ptr)						{ free(ptr); }
+	static void* alloc_raw_aligned(size_t size, size_t align)	{ return _aligned_malloc(size, align); }
+	static void alloc_raw_aligned_free(void* ptr)				{ _aligned_free(ptr); }
+#else
+	extern "C" void* __real_malloc(size_t size);
+	extern "C" void* __real_calloc(size_t count, size_t size);
+	extern "C" void* __real_realloc(void* ptr, size_t size);
+	extern "C" void __real_free(void* ptr);
+
+	static void* alloc_raw_malloc(size_t size)					{ return __real_malloc(size); }
+	static void alloc_raw_free(void* ptr)						{ __real_free(ptr); }
+	static void alloc_raw_aligned_free(void* ptr)				{ __real_free(ptr); }
+
+	static void* alloc_raw_aligned(size_t size, size_t align)
+	{
+		void* ptr;
+		return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+	}
+#endif
+
+#if ALLOC_PROFILE
+
+struct alloc_live
+{
+	uintptr_t	ptr;	// Zero for an empty slot
+	size_t		size;
+	uint32_t	tag;
+	uint32_t	frame;
+};
+
+struct alloc_tag_stats
+{
+	const char*	name;
+	alloc_stats	frame;
+	alloc_stats	all;
+	uint64_t	live_allocs;
+	uint64_t	live_bytes;
+};
+
+/*
+	Everything is plain zero initialised data so the hooks work for allocations made by static
+	constructors that run before ours would.
+*/
+static std::atomic_flag		alloc_lock = ATOMIC_FLAG_INIT;
+static alloc_live*			alloc_table;			// Open addressing on the pointer, linear probing
+static size_t				alloc_table_capacity;	// Power of two, or zero before the first allocation
+static alloc_totals			alloc_state;
+static alloc_tag_stats		alloc_tags[alloc_profile_max_tags];
+static uint32_t				alloc_tag_count;
+static bool					alloc_budget_set;
+static uint64_t				alloc_budget_allocs;
+static uint64_t				alloc_budget_bytes;
+static bool					alloc_budget_break;
+
+static thread_local uint32_t	alloc_current_tag;
+static thread_local bool		alloc_busy;		// Set while the profiler itself runs, to ignore reentry
+
+static void alloc_lock_acquire()
+{
+	while (alloc_lock.test_and_set(std::memory_order_acquire))
+		;
+}
+
+static void alloc_lock_release()
+{
+	alloc_lock.clear(std::memory_order_release);
+}
+
+static void alloc_print(const char* fmt, ...)
+{
+	char buffer[1024];
+
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buffer, sizeof(buffer), fmt, args);
+	va_end(args);
+
+	fputs(buffer, stderr);
+#ifdef _WIN32
+	OutputDebugStringA(buffer);
+#endif
+}
+
+static size_t alloc_table_slot(uintptr_t ptr)
+{
+	return (size_t)(((ptr >> 4) * 0x9E3779B97F4A7C15ull) >> 32) & (alloc_table_capacity - 1);
+}
+
+static void alloc_table_insert(const alloc_live& live)
+{
+	// Grow at half full so probe runs stay short
+	if ((alloc_state.live_allocs + 1) * 2 > alloc_table_capacity)
+	{
+		alloc_live* old_table = alloc_table;
+		const size_t old_capacity = alloc_table_capacity;
+
+		alloc_table_capacity = old_capacity ? old_capacity * 2 : 4096;
+		alloc_table = (alloc_live*)alloc_raw_malloc(alloc_table_capacity * sizeof(alloc_live));
+		memset(alloc_table, 0, alloc_table_capacity * sizeof(alloc_live));
+
+		for (size_t i = 0; i < old_capacity; i++)
+		{
+			if (old_table[i].ptr)
+				alloc_table_insert(old_table[i]);
+		}
+		alloc_raw_free(old_table);
+	}
+
+	size_t slot = alloc_table_slot(live.ptr);
+	while (alloc_table[slot].ptr)
+		slot = (slot + 1) & (alloc_table_capacity - 1);
+
+	alloc_table[slot] = live;
+}
+
+static bool alloc_table_remove(uintptr_t ptr, alloc_live* removed)
+{
+	if (!alloc_table_capacity)
+		return false;
+
+	const size_t mask = alloc_table_capacity - 1;
+	size_t slot = alloc_table_slot(ptr);
+	while (alloc_table[slot].ptr != ptr)
+	{
+		if (!alloc_table[slot].ptr)
+			return false;
+		slot = (slot + 1) & mask;
+	}
+
+	*removed = alloc_table[slot];
+
+	/*
+		Backward shift deletion: pull later entries of the probe run into the hole whenever the hole
+		lies between their home slot and where they are now, so no tombstones are needed.
+	*/
+	size_t hole = slot;
+	for (size_t next = (hole + 1) & mask; alloc_table[next].ptr; next = (next + 1) & mask)
+	{
+		const size_t home = alloc_table_slot(alloc_table[next].ptr);
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			alloc_table[hole] = alloc_table[next];
+			hole = next;
+		}
+	}
+	alloc_table[hole] = {};
+
+	return true;
+}
+
+static void alloc_count(alloc_tag_stats* tag, size_t allocs, size_t frees, size_t bytes)
+{
+	alloc_stats* all_stats[4] = {&alloc_state.all, &alloc_state.this_frame, &tag->all, &tag->frame};
+	for (alloc_stats* stats : all_stats)
+	{
+		stats->allocs += allocs;
+		stats->frees += frees;
+		stats->bytes += bytes;
+	}
+}
+
+static void alloc_record_alloc(void* ptr, size_t size)
+{
+	if (!ptr || alloc_busy)
+		return;
+
+	alloc_busy = true;
+	alloc_lock_acquire();
+
+	alloc_table_insert({(uintptr_t)ptr, size, alloc_current_tag, (uint32_t)alloc_state.frame});
+
+	alloc_tag_stats* tag = &alloc_tags[alloc_current_tag];
+	alloc_count(tag, 1, 0, size);
+	tag->live_allocs++;
+	tag->live_bytes += size;
+
+	alloc_state.live_allocs++;
+	alloc_state.live_bytes += size;
+	if (alloc_state.live_bytes > alloc_state.peak_bytes)
+		alloc_state.peak_bytes = alloc_state.live_bytes;
+
+	alloc_lock_release();
+	alloc_busy = false;
+}
+
+// Counts the free of an entry already taken out of the table, with the lock held
+static void alloc_count_free(const alloc_live& live)
+{
+	alloc_tag_stats* tag = &alloc_tags[live.tag];
+	alloc_count(tag, 0, 1, 0);
+	tag->live_allocs--;
+	tag->live_bytes -= live.size;
+
+	alloc_state.live_allocs--;
+	alloc_state.live_bytes -= live.size;
+}
+
+static void alloc_record_free(void* ptr)
+{
+	if (!ptr || alloc_busy)
+		return;
+
+	alloc_busy = true;
+	alloc_lock_acquire();
+
+	// Pointers from before tracking or from untracked allocators are not in the table
+	alloc_live live;
+	if (alloc_table_remove((uintptr_t)ptr, &live))
+		alloc_count_free(live);
+
+	alloc_lock_release();
+	alloc_busy = false;
+}
+
+/*
+	realloc through the given raw function. The old block's entry is taken out of the table before
+	the call, as once realloc frees the block another thread may be handed the same address and
+	record it. The free is only counted once realloc succeeds; if it fails the old block is still
+	live and its entry goes back unchanged.
+*/
+static void* alloc_realloc(void* ptr, size_t size, void* (*raw_realloc)(void*, size_t))
+{
+	alloc_live live;
+	bool detached = false;
+	if (ptr && !alloc_busy)
+	{
+		alloc_busy = true;
+		alloc_lock_acquire();
+		detached = alloc_table_remove((uintptr_t)ptr, &live);
+		alloc_lock_release();
+		alloc_busy = false;
+	}
+
+	void* result = raw_realloc(ptr, size);
+
+	if (detached)
+	{
+		alloc_busy = true;
+		alloc_lock_acquire();
+		if (result)
+			alloc_count_free(live);
+		else
+			alloc_table_insert(live);
+		alloc_lock_release();
+		alloc_busy = false;
+	}
+
+	alloc_record_alloc(result, size);
+	return result;
+}
+
+alloc_tag_scope::alloc_tag_scope(const char* tag) : previous(alloc_current_tag)
+{
+	alloc_lock_acquire();
+
+	if (!alloc_tag_count)
+		alloc_tags[alloc_tag_count++].name = "untagged";
+
+	uint32_t index = 0;
+	while (index < alloc_tag_count && alloc_tags[index].name != tag)
+		index++;
+
+	// Out of tags, share the last one rather than fail
+	if (index == alloc_tag_count)
+	{
+		if (alloc_tag_count < alloc_profile_max_tags)
+			alloc_tags[alloc_tag_count++].name = tag;
+		else
+			index = alloc_profile_max_tags - 1;
+	}
+
+	alloc_lock_release();
+
+	alloc_current_tag = index;
+}
+
+alloc_tag_scope::~alloc_tag_scope()
+{
+	alloc_current_tag = previous;
+}
+
+void alloc_profile_set_budget(uint64_t max_allocs, uint64_t max_bytes, bool break_on_exceed)
+{
+	alloc_budget_set = true;
+	alloc_budget_allocs = max_allocs;
+	alloc_budget_bytes = max_bytes;
+	alloc_budget_break = break_on_exceed;
+}
+
+void alloc_profile_frame_end()
+{
+	alloc_busy = true;
+	alloc_lock_acquire();
+
+	const alloc_stats frame = alloc_state.this_frame;
+	const bool over_budget = alloc_budget_set && (frame.allocs > alloc_budget_allocs || frame.bytes > alloc_budget_bytes);
+
+	if (over_budget)
+	{
+		alloc_print("Frame %llu over allocation budget: %llu allocs, %llu bytes, %llu frees\n",
+			(unsigned long long)alloc_state.frame, (unsigned long long)frame.allocs, (unsigned long long)frame.bytes, (unsigned long long)frame.frees);
+
+		for (uint32_t i = 0; i < alloc_tag_count; i++)
+		{
+			const alloc_stats* stats = &alloc_tags[i].frame;
+			if (stats->allocs)
+				alloc_print("  %-24s %8llu allocs %12llu bytes\n", alloc_tags[i].name, (unsigned long long)stats->allocs, (unsigned long long)stats->bytes);
+		}
+	}
+
+	for (uint32_t i = 0; i < alloc_tag_count; i++)
+		alloc_tags[i].frame = {};
+	alloc_state.this_frame = {};
+	alloc_state.frame++;
+
+	alloc_lock_release();
+	alloc_busy = false;
+
+	if (over_budget && alloc_budget_break)
+		debug_break();
+}
+
+alloc_totals alloc_profile_totals()
+{
+	alloc_lock_acquire();
+	const alloc_totals totals = alloc_state;
+	alloc_lock_release();
+
+	return totals;
+}
+
+void alloc_profile_report_leaks()
+{
+	const uint32_t max_listed = 16;
+
+	alloc_busy = true;
+	alloc_lock_acquire();
+
+	if (!alloc_state.live_allocs)
+	{
+		alloc_print("No leaked allocations, peak %llu bytes\n", (unsigned long long)alloc_state.peak_bytes);
+	}
+	else
+	{
+		alloc_print("%llu allocations still live, %llu bytes, peak %llu bytes\n",
+			(unsigned long long)alloc_state.live_allocs, (unsigned long long)alloc_state.live_bytes, (unsigned long long)alloc_state.peak_bytes);
+
+		for (uint32_t i = 0; i < alloc_tag_count; i++)
+		{
+			const alloc_tag_stats* tag = &alloc_tags[i];
+			if (tag->live_allocs)
+				alloc_print("  %-24s %8llu allocs %12llu bytes\n", tag->name, (unsigned long long)tag->live_allocs, (unsigned long long)tag->live_bytes);
+		}
+
+		uint32_t listed = 0;
+		for (size_t i = 0; i < alloc_table_capacity && listed < max_listed; i++)
+		{
+			const alloc_live* live = &alloc_table[i];
+			if (!live->ptr)
+				continue;
+
+			alloc_print("  %p %10zu bytes, tag %s, frame %u\n", (void*)live->ptr, live->size, alloc_tags[live->tag].name, live->frame);
+			listed++;
+		}
+	}
+
+	alloc_lock_release();
+	alloc_busy = false;
+}
+
+/*
+	Global new and delete replacements. Builds have exceptions disabled, so running out of memory
+	ends the process instead of throwing std::bad_alloc. The nothrow forms return nullptr instead,
+	and only a successful allocation is recorded.
+*/
+static void* alloc_try_new(size_t size)
+{
+	void* ptr = alloc_raw_malloc(size ? size : 1);
+	if (ptr)
+		alloc_record_alloc(ptr, size);
+
+	return ptr;
+}
+
+static void* alloc_try_new_aligned(size_t size, std::align_val_t align)
+{
+	void* ptr = alloc_raw_aligned(size ? size : 1, (size_t)align);
+	if (ptr)
+		alloc_record_alloc(ptr, size);
+
+	return ptr;
+}
+
+static void* alloc_new(size_t size)
+{
+	void* ptr = alloc_try_new(size);
+	if (!ptr)
+		abort();
+
+	return ptr;
+}
+
+static void* alloc_new_aligned(size_t size, std::align_val_t align)
+{
+	void* ptr = alloc_try_new_aligned(size, align);
+	if (!ptr)
+		abort();
+
+	return ptr;
+}
+
+static void alloc_delete(void* ptr)
+{
+	alloc_record_free(ptr);
+	alloc_raw_free(ptr);
+}
+
+static void alloc_delete_aligned(void* ptr)
+{
+	alloc_record_free(ptr);
+	alloc_raw_aligned_free(ptr);
+}
+
+void* operator new(size_t size)																{ return alloc_new(size); }
+void* operator new[](size_t size)															{ return alloc_new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept								{ return alloc_try_new(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept							{ return alloc_try_new(size); }
+void* operator new(size_t size, std::align_val_t align)										{ return alloc_new_aligned(size, align); }
+void* operator new[](size_t size, std::align_val_t align)									{ return alloc_new_aligned(size, align); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept		{ return alloc_try_new_aligned(size, align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept	{ return alloc_try_new_aligned(size, align); }
+
+void operator delete(void* ptr) noexcept											{ alloc_delete(ptr); }
+void operator delete[](void* ptr) noexcept											{ alloc_delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept									{ alloc_delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept									{ alloc_delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept						{ alloc_delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept					{ alloc_delete(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept							{ alloc_delete_aligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept						{ alloc_delete_aligned(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept					{ alloc_delete_aligned(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept				{ alloc_delete_aligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept	{ alloc_delete_aligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept	{ alloc_delete_aligned(ptr); }
+
+#else
+
+static void alloc_record_alloc(void*, size_t) {}
+static void alloc_record_free(void*) {}
+static void* alloc_realloc(void* ptr, size_t size, void* (*raw_realloc)(void*, size_t)) { return raw_realloc(ptr, size); }
+
+alloc_tag_scope::alloc_tag_scope(const char*) : previous(0) {}
+alloc_tag_scope::~alloc_tag_scope() {}
+
+void alloc_profile_set_budget(uint64_t, uint64_t, bool) {}
+void alloc_profile_frame_end() {}
+alloc_totals alloc_profile_totals() { return {}; }
+void alloc_profile_report_leaks() {}
+
+#endif
+
+#ifndef _MSC_VER
+/*
+	malloc family hooks, reached through -Wl,--wrap in build_linux.sh. They are always defined so
+	the link succeeds with profiling off, in which case they only forward.
+*/
+extern "C" void* __wrap_malloc(size_t size)
+{
+	void* ptr = __real_malloc(size);
+	alloc_record_alloc(ptr, size);
+	return ptr;
+}
+
+extern "C" void* __wrap_calloc(size_t count, size_t size)
+{
+	void* ptr = __real_calloc(count, size);
+	alloc_record_alloc(ptr, count * size);
+	return ptr;
+}
+
+extern "C" void* __wrap_realloc(void* ptr, size_t size)
+{
+	// A zero size frees the block, as glibc does, rather than recording an empty allocation
+	if (ptr && !size)
+	{
+		alloc_record_free(ptr);
+		__real_free(ptr);
+		return nullptr;
+	}
+
+	return alloc_realloc(ptr, size, __real_realloc);
+}
+
+extern "C" void __wrap_free(void* ptr)
+{
+	alloc_record_free(ptr);
+	__real_free(ptr);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <atomic>
+#include <new>
+
+#ifdef _MSC_VER
+	#include <malloc.h>
+#endif
+
+/*
+	Allocation profiler.
+
+	When ALLOC_PROFILE is enabled every global operator new/delete (and on Linux every malloc,
+	calloc, realloc and free made by our own code, hooked with the linker's --wrap) is recorded with
+	its size and the tag of the innermost alloc_tag scope. The profiler keeps per-frame counts and
+	bytes, the live and peak totals, and a table of live allocations for the leak report.
+
+	ALLOC_PROFILE defaults to on in debug builds and off in release builds, define it to 0 or 1 to
+	override. When it is off nothing is hooked and every function here does nothing.
+
+	Call alloc_profile_frame_end once per frame. If a budget has been set, any frame that went over
+	it is reported, and in debug builds can also break into the debugger. Call
+	alloc_profile_report_leaks at shutdown, once everything has been released, to list whatever
+	is still allocated.
+
+	The malloc hooks only see calls compiled into our executable. Memory allocated inside the C
+	runtime or system libraries is not tracked, and neither is malloc on Windows, where there is no
+	linker wrap.
+*/
+#ifndef ALLOC_PROFILE
+	#ifdef NDEBUG
+		#define ALLOC_PROFILE 0
+	#else
+		#define ALLOC_PROFILE 1
+	#endif
+#endif
+
+constexpr uint32_t alloc_profile_max_tags = 64;
+
+struct alloc_stats
+{
+	uint64_t allocs;	// Allocation calls, including reallocs
+	uint64_t frees;
+	uint64_t bytes;		// Bytes requested by the allocations
+};
+
+struct alloc_totals
+{
+	uint64_t	frame;			// Frames ended so far
+	uint64_t	live_allocs;
+	uint64_t	live_bytes;
+	uint64_t	peak_bytes;		// Highest live_bytes seen
+	alloc_stats	all;			// Everything since startup
+	alloc_stats	this_frame;		// Since the last alloc_profile_frame_end
+};
+
+/*
+	Limits for a single frame, UINT64_MAX for no limit. There is no budget until this is called.
+	Frames over budget are reported on stderr and the debugger output window, and also break into
+	the debugger if break_on_exceed is set and asserts are enabled.
+*/
+void alloc_profile_set_budget(uint64_t max_allocs, uint64_t max_bytes, bool break_on_exceed);
+
+// Checks the budget, then resets the per-frame counters
+void alloc_profile_frame_end();
+
+alloc_totals alloc_profile_totals();
+
+// Prints live allocations grouped by tag, with the frame each of the first few was made on
+void alloc_profile_report_leaks();
+
+/*
+	Tags allocations made on this thread until the end of the enclosing scope, for example:
+
+		alloc_tag("path_schedule");
+
+	Tags must be string literals or otherwise live forever, they are matched by pointer.
+*/
+struct alloc_tag_scope
+{
+	uint32_t previous;
+
+	explicit alloc_tag_scope(const char* tag);
+	~alloc_tag_scope();
+};
+
+#if ALLOC_PROFILE
+	#define alloc_tag_join2(a, b) a##b
+	#define alloc_tag_join(a, b) alloc_tag_join2(a, b)
+	#define alloc_tag(name) alloc_tag_scope alloc_tag_join(alloc_tag_scope_, __LINE__)(name)
+#else
+	#define alloc_tag(name) macro_begin macro_end
+#endif
\ No newline at end of file
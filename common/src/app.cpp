@@ -312,8 +312,10 @@ void load_png(d3d_context* d3d, texture* t, void* data, size_t size)
 
 	check_hresult(frame->GetSize(&t->width, &t->height));
 
+	// The decoded pixels are only needed until the texture is created
+	frame_arena_scope scratch(frame_scratch());
 	const uint32_t mem_size = t->width * t->height * 4;
-	uint8_t* decoded_data = (uint8_t*)malloc(mem_size);
+	uint8_t* decoded_data = scratch.arena ? (uint8_t*)frame_arena_alloc(scratch.arena, mem_size) : (uint8_t*)malloc(mem_size);
 
 	check_hresult(frame->CopyPixels(nullptr, t->width * 4, mem_size, decoded_data));
 
@@ -336,7 +338,8 @@ void load_png(d3d_context* d3d, texture* t, void* data, size_t size)
 
 	check_hresult(d3d->device->CreateTexture2D(&texture_desc, &texture_data, &t->buffer));
 
-	free(decoded_data);
+	if (!scratch.arena)
+		free(decoded_data);
 
 	D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc = {};
 	srv_desc.Format = texture_desc.Format;
@@ -352,6 +355,10 @@ void load_png(d3d_context* d3d, texture* t, void* data, size_t size)
 */
 void begin_frame(d3d_context* d3d)
 {
+	// Scratch memory from the last frame is no longer in use
+	if (frame_arena* scratch = frame_scratch())
+		frame_arena_reset(scratch);
+
 	// Set the current render target to the back buffer
 	d3d->context->OMSetRenderTargets(1, &d3d->back_buffer, nullptr);
 
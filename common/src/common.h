@@ -5,6 +5,7 @@
 // C++ standard library includes
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
 // Windows includes
 #include <wincodec.h>
@@ -18,5 +19,10 @@ using namespace DirectX;
 
 #include "../src/app.h"
 #include "../src/debug.h"
+#include "../src/alloc_profile.h"
+#include "../src/handoff.h"
+#include "../src/frame_arena.h"
+#include "../src/sprite_atlas.h"
+#include "../src/sprite_layer.h"
 #include "../src/sprite_batch.h"
 #include "../src/util.h"
\ No newline at end of file
@@ -14,6 +14,10 @@ void debug_printf(const char* fmt, ...)
 	va_end(args);
 
 	// Display in debugger output window
+#ifdef _WIN32
 	OutputDebugStringA(buffer);
+#else
+	fputs(buffer, stderr);
+#endif
 #endif
 }
\ No newline at end of file
@@ -32,8 +32,15 @@
 		Forces the debugger to break on the line where this macro is called. This is useful in
 		situations where an error has occured and we want to print out custom debug information
 		before breaking in the debugger,
+
+		Headless tools are also built with GCC/Clang on Linux where __debugbreak does not exist, so
+		trap instead which stops in an attached debugger or aborts the process.
 	*/
-	#define debug_break() __debugbreak()
+	#ifdef _MSC_VER
+		#define debug_break() __debugbreak()
+	#else
+		#define debug_break() __builtin_trap()
+	#endif
 
 	/*
 		Custom assert macro which is a bit nicer to use than the standard Visual C++ version.
@@ -55,7 +62,7 @@
 		if (!(condition)) \
 		{ \
 			debug_printf("%s(%d): Assertion failed: %s\n", __FILE__, __LINE__, #condition); \
-			__debugbreak(); \
+			debug_break(); \
 		} \
 		macro_end
 
@@ -72,13 +79,14 @@
 		if (result != 0) \
 		{ \
 			debug_printf("%s(%d): HRESULT failure: 0x%08X\n", __FILE__, __LINE__, result); \
-			__debugbreak(); \
+			debug_break(); \
 		} \
 		macro_end
 #endif
 
 /*
-	Prints a formatted string to the debugger output window in debug builds. In release builds this
-	function does nothing and will be stripped entirely from the executable.
+	Prints a formatted string to the debugger output window in debug builds (stderr when built
+	without windows.h). In release builds this function does nothing and will be stripped entirely
+	from the executable.
 */
 void debug_printf(const char* fmt, ...);
\ No newline at end of file
@@ -0,0 +1,163 @@
+struct frame_arena_overflow
+{
+	frame_arena_overflow*	next;
+	size_t					size;
+};
+
+static thread_local frame_arena*	frame_arena_thread;
+
+static void frame_arena_print(const char* fmt, ...)
+{
+	char buffer[1024];
+
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buffer, sizeof(buffer), fmt, args);
+	va_end(args);
+
+	fputs(buffer, stderr);
+#ifdef _WIN32
+	OutputDebugStringA(buffer);
+#endif
+}
+
+static void frame_arena_poison_range(uint8_t* begin, size_t size)
+{
+#ifndef NDEBUG
+	memset(begin, frame_arena_poison, size);
+#else
+	(void)begin;
+	(void)size;
+#endif
+}
+
+static void frame_arena_track_peak(frame_arena* arena)
+{
+	const size_t total = arena->used + arena->overflow_bytes;
+	if (total > arena->peak)
+		arena->peak = total;
+}
+
+void frame_arena_init(frame_arena* arena, const char* name, size_t capacity)
+{
+	alloc_tag("frame_arena");
+
+	arena->name = name;
+	arena->base = (uint8_t*)malloc(capacity);
+	arena->capacity = capacity;
+	arena->used = 0;
+	arena->peak = 0;
+	arena->floor = 0;
+	arena->overflows = nullptr;
+	arena->overflow_bytes = 0;
+	arena->overflow_count = 0;
+
+	frame_arena_poison_range(arena->base, capacity);
+}
+
+void frame_arena_term(frame_arena* arena)
+{
+	frame_arena_reset(arena);
+
+	free(arena->base);
+	arena->base = nullptr;
+	arena->capacity = 0;
+}
+
+// Slow path, the block is full
+static void* frame_arena_overflow_alloc(frame_arena* arena, size_t size, size_t align)
+{
+	alloc_tag("frame_arena");
+
+	// The header is padded to the alignment so the allocation after it stays aligned
+	const size_t header = (sizeof(frame_arena_overflow) + align - 1) & ~(align - 1);
+	uint8_t* block = (uint8_t*)malloc(header + size + align);
+	uint8_t* ptr = (uint8_t*)(((uintptr_t)block + header + align - 1) & ~(uintptr_t)(align - 1));
+
+	// The link sits just before the returned pointer but the block starts at the malloc address
+	frame_arena_overflow* overflow = (frame_arena_overflow*)block;
+	overflow->next = arena->overflows;
+	overflow->size = header + size + align;
+	arena->overflows = overflow;
+	arena->overflow_bytes += overflow->size;
+	arena->overflow_count++;
+	frame_arena_track_peak(arena);
+
+	return ptr;
+}
+
+void* frame_arena_alloc(frame_arena* arena, size_t size, size_t align)
+{
+	assert(align && (align & (align - 1)) == 0);
+
+	const size_t begin = (((uintptr_t)arena->base + arena->used + align - 1) & ~(uintptr_t)(align - 1)) - (uintptr_t)arena->base;
+	if (begin + size > arena->capacity)
+		return frame_arena_overflow_alloc(arena, size, align);
+
+	arena->used = begin + size;
+	frame_arena_track_peak(arena);
+
+	return arena->base + begin;
+}
+
+void frame_arena_free(frame_arena* arena, void* ptr, size_t size)
+{
+	uint8_t* begin = (uint8_t*)ptr;
+	if (begin >= arena->base + arena->floor && begin + size == arena->base + arena->used)
+	{
+		arena->used = (size_t)(begin - arena->base);
+		frame_arena_poison_range(begin, size);
+	}
+}
+
+void frame_arena_rollback(frame_arena* arena, frame_arena_mark mark)
+{
+	assert(mark.used <= arena->used && mark.floor <= mark.used);
+
+	while (arena->overflows != mark.overflows)
+	{
+		frame_arena_overflow* overflow = arena->overflows;
+		arena->overflows = overflow->next;
+		arena->overflow_bytes -= overflow->size;
+		free(overflow);
+	}
+
+	frame_arena_poison_range(arena->base + mark.used, arena->used - mark.used);
+	arena->used = mark.used;
+	arena->floor = mark.floor;
+}
+
+void frame_arena_reset(frame_arena* arena)
+{
+	frame_arena_rollback(arena, {0, nullptr, 0});
+}
+
+void frame_arena_report(const frame_arena* arena)
+{
+	frame_arena_print("Frame arena %s: %llu of %llu bytes used at peak, %llu allocations overflowed to the heap\n",
+		arena->name, (unsigned long long)arena->peak, (unsigned long long)arena->capacity, (unsigned long long)arena->overflow_count);
+}
+
+void frame_arena_thread_init(const char* name, size_t capacity)
+{
+	alloc_tag("frame_arena");
+
+	assert(!frame_arena_thread);
+
+	frame_arena_thread = new frame_arena;
+	frame_arena_init(frame_arena_thread, name, capacity);
+}
+
+void frame_arena_thread_term()
+{
+	assert(frame_arena_thread);
+
+	frame_arena_term(frame_arena_thread);
+	delete frame_arena_thread;
+	frame_arena_thread = nullptr;
+}
+
+frame_arena* frame_scratch()
+{
+	return frame_arena_thread;
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include <vector>
+
+/*
+	Linear scratch arena for memory that only lives until the end of the frame.
+
+	Allocation bumps an offset into one block reserved up front, so it costs a few instructions and
+	never takes a lock or touches the heap. Nothing is freed individually: take a mark before a
+	batch of temporary work and roll back to it afterwards, or let the whole arena be reset once a
+	frame. Rolling back also frees anything allocated after the mark, so marks must be rolled back
+	in the reverse order they were taken.
+
+	Each thread has its own arena, set up with frame_arena_thread_init and found with
+	frame_scratch, so workers never share one. begin_frame resets the arena of the thread that
+	calls it, other threads reset theirs at the end of their own unit of work, for example a
+	simulation tick.
+
+	An allocation that does not fit in the block falls back to malloc and is released with the
+	next rollback or reset past it. These count as overflows and show in frame_arena_report, which
+	also reports the high water mark so the block can be sized. Debug builds fill released memory
+	with frame_arena_poison so reads of stale scratch memory stand out.
+*/
+constexpr size_t	frame_arena_default_align = 16;
+constexpr uint8_t	frame_arena_poison = 0xCD;
+
+struct frame_arena_overflow;
+
+struct frame_arena
+{
+	const char*				name;
+	uint8_t*				base;
+	size_t					capacity;
+	size_t					used;
+	size_t					peak;				// Highest used, plus overflow bytes live at the time
+	size_t					floor;				// used at the newest mark not yet rolled back
+	frame_arena_overflow*	overflows;			// Fallback blocks, newest first
+	size_t					overflow_bytes;		// Live fallback bytes
+	uint64_t				overflow_count;		// Fallback allocations since init
+};
+
+struct frame_arena_mark
+{
+	size_t					used;
+	frame_arena_overflow*	overflows;
+	size_t					floor;		// The arena's floor before the mark, restored by rolling back to it
+};
+
+void frame_arena_init(frame_arena* arena, const char* name, size_t capacity);
+void frame_arena_term(frame_arena* arena);
+
+// Size may be zero. Alignment must be a power of two
+void* frame_arena_alloc(frame_arena* arena, size_t size, size_t align = frame_arena_default_align);
+
+/*
+	Gives back the most recent allocation if ptr is still the top of the arena. Only that one can
+	be given back, anything else is left for the next rollback or reset. Nothing below the newest
+	mark is ever given back, as a later allocation would then sit under the mark and rolling back
+	to it would leave the arena below where the mark says it was.
+*/
+void frame_arena_free(frame_arena* arena, void* ptr, size_t size);
+
+inline frame_arena_mark frame_arena_get_mark(frame_arena* arena)
+{
+	const frame_arena_mark mark = {arena->used, arena->overflows, arena->floor};
+	arena->floor = arena->used;
+	return mark;
+}
+
+void frame_arena_rollback(frame_arena* arena, frame_arena_mark mark);
+void frame_arena_reset(frame_arena* arena);
+
+// Prints the capacity, high water mark and overflows
+void frame_arena_report(const frame_arena* arena);
+
+/*
+	Per-thread arenas. frame_scratch returns nullptr on threads that never called
+	frame_arena_thread_init, and everything below treats a null arena as plain heap memory, so
+	shared code can use scratch memory without knowing which thread it runs on.
+*/
+void frame_arena_thread_init(const char* name, size_t capacity);
+void frame_arena_thread_term();
+frame_arena* frame_scratch();
+
+// Rolls the arena back to where it was when the scope began
+struct frame_arena_scope
+{
+	frame_arena*		arena;
+	frame_arena_mark	mark;
+
+	explicit frame_arena_scope(frame_arena* arena) : arena(arena)
+	{
+		if (arena)
+			mark = frame_arena_get_mark(arena);
+	}
+
+	~frame_arena_scope()
+	{
+		if (arena)
+			frame_arena_rollback(arena, mark);
+	}
+};
+
+/*
+	Allocator for standard containers, for example:
+
+		frame_arena_scope scope(frame_scratch());
+		frame_vector<uint32_t> queue{frame_allocator<uint32_t>(frame_scratch())};
+
+	The container must be destroyed, or at least never touched again, before the arena is rolled
+	back past it. A null arena allocates from the heap.
+*/
+template<typename T>
+struct frame_allocator
+{
+	typedef T value_type;
+
+	frame_arena* arena;
+
+	explicit frame_allocator(frame_arena* arena) : arena(arena)
+	{
+	}
+
+	template<typename U>
+	frame_allocator(const frame_allocator<U>& other) : arena(other.arena)
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		if (!arena)
+			return (T*)::operator new(count * sizeof(T));
+
+		return (T*)frame_arena_alloc(arena, count * sizeof(T), alignof(T) > frame_arena_default_align ? alignof(T) : frame_arena_default_align);
+	}
+
+	void deallocate(T* ptr, size_t count)
+	{
+		if (!arena)
+			::operator delete(ptr);
+		else
+			frame_arena_free(arena, ptr, count * sizeof(T));
+	}
+};
+
+template<typename T, typename U>
+bool operator==(const frame_allocator<T>& a, const frame_allocator<U>& b)
+{
+	return a.arena == b.arena;
+}
+
+template<typename T, typename U>
+bool operator!=(const frame_allocator<T>& a, const frame_allocator<U>& b)
+{
+	return a.arena != b.arena;
+}
+
+template<typename T>
+using frame_vector = std::vector<T, frame_allocator<T>>;
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <atomic>
+
+/*
+	Lock-free handoff between exactly two threads, one writing and one reading.
+
+	triple_buffer passes whole state snapshots, such as the simulation state the renderer draws.
+	The writer fills its private back slot and publishes it by swapping it with the shared middle
+	slot. The reader swaps the middle slot with its private front slot whenever a newer snapshot
+	is there. Neither side ever waits: the reader always gets the latest complete snapshot, and
+	snapshots the reader was too slow to see are dropped.
+
+	spsc_queue is a bounded ring for small messages that must all arrive, such as input events.
+	Each side keeps a cached copy of the other side's index and only reloads it when the ring looks
+	full or empty, so the shared cache lines are not touched on every call.
+*/
+constexpr size_t handoff_cache_line = 64;
+
+template<typename T>
+struct triple_buffer
+{
+	// The shared index carries a fresh bit, set while the middle slot holds an unread snapshot
+	static constexpr uint32_t fresh_bit = 4;
+
+	struct alignas(handoff_cache_line) slot
+	{
+		T value;
+	};
+
+	slot									slots[3];
+	alignas(handoff_cache_line) std::atomic<uint32_t>	middle{1};
+	alignas(handoff_cache_line) uint32_t	back = 0;	// Writer only
+	alignas(handoff_cache_line) uint32_t	front = 2;	// Reader only
+};
+
+// Slot the writer fills next. Its contents are whatever snapshot last went through that slot
+template<typename T>
+T* triple_buffer_back(triple_buffer<T>* tb)
+{
+	return &tb->slots[tb->back].value;
+}
+
+template<typename T>
+void triple_buffer_publish(triple_buffer<T>* tb)
+{
+	// Release makes the snapshot visible before the index, acquire hands back a slot the reader has let go of
+	tb->back = tb->middle.exchange(tb->back | triple_buffer<T>::fresh_bit, std::memory_order_acq_rel) & 3;
+}
+
+/*
+	Latest published snapshot, or the one returned last time if nothing newer has been published.
+	The snapshot stays valid and unchanged until the next call. fresh is optional and set to whether
+	the snapshot is new since the last call.
+*/
+template<typename T>
+const T* triple_buffer_read(triple_buffer<T>* tb, bool* fresh = nullptr)
+{
+	const bool has_new = (tb->middle.load(std::memory_order_relaxed) & triple_buffer<T>::fresh_bit) != 0;
+	if (has_new)
+		tb->front = tb->middle.exchange(tb->front, std::memory_order_acq_rel) & 3;
+
+	if (fresh)
+		*fresh = has_new;
+
+	return &tb->slots[tb->front].value;
+}
+
+// Capacity must be a power of two, the ring holds at most Capacity messages
+template<typename T, uint32_t Capacity>
+struct spsc_queue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "spsc_queue capacity must be a power of two");
+
+	T											items[Capacity];
+	alignas(handoff_cache_line) std::atomic<uint32_t>	head{0};	// Next item to pop, written by the reader
+	alignas(handoff_cache_line) std::atomic<uint32_t>	tail{0};	// Next free item, written by the writer
+	alignas(handoff_cache_line) uint32_t		cached_head = 0;	// Writer's copy of head
+	alignas(handoff_cache_line) uint32_t		cached_tail = 0;	// Reader's copy of tail
+};
+
+// Returns false and drops the item if the queue is full
+template<typename T, uint32_t Capacity>
+bool spsc_queue_push(spsc_queue<T, Capacity>* q, const T& item)
+{
+	const uint32_t tail = q->tail.load(std::memory_order_relaxed);
+	if (tail - q->cached_head == Capacity)
+	{
+		q->cached_head = q->head.load(std::memory_order_acquire);
+		if (tail - q->cached_head == Capacity)
+			return false;
+	}
+
+	q->items[tail & (Capacity - 1)] = item;
+	q->tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+// Returns false if the queue is empty
+template<typename T, uint32_t Capacity>
+bool spsc_queue_pop(spsc_queue<T, Capacity>* q, T* item)
+{
+	const uint32_t head = q->head.load(std::memory_order_relaxed);
+	if (head == q->cached_tail)
+	{
+		q->cached_tail = q->tail.load(std::memory_order_acquire);
+		if (head == q->cached_tail)
+			return false;
+	}
+
+	*item = q->items[head & (Capacity - 1)];
+	q->head.store(head + 1, std::memory_order_release);
+	return true;
+}
\ No newline at end of file
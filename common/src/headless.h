@@ -0,0 +1,19 @@
+/*
+	Common header for headless tools (benchmarks, servers, scenario runners) that use the platform
+	independent parts of the engine. Unlike common.h this does not pull in windows.h or D3D, so the
+	same targets also build with GCC/Clang on Linux.
+*/
+
+// C++ standard library includes
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/debug.h"
+#include "../src/alloc_profile.h"
+#include "../src/handoff.h"
+#include "../src/frame_arena.h"
+#include "../src/sprite_atlas.h"
+#include "../src/sprite_layer.h"
\ No newline at end of file
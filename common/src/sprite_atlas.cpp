@@ -0,0 +1,74 @@
+void sprite_atlas_init(sprite_atlas* atlas, texture* sheet, uint32_t width, uint32_t height)
+{
+	assert(width > 0 && height > 0);
+
+	atlas->sheet = sheet;
+	atlas->width = width;
+	atlas->height = height;
+	atlas->region_count = 0;
+	atlas->sequence_count = 0;
+}
+
+sprite_id sprite_atlas_add(sprite_atlas* atlas, const char* name, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	assert(x >= 0 && y >= 0 && w > 0 && h > 0);
+	assert((uint32_t)(x + w) <= atlas->width && (uint32_t)(y + h) <= atlas->height);
+
+	if (atlas->region_count == sprite_atlas_max_regions)
+		return sprite_id_none;
+
+	const float texture_width = (float)atlas->width;
+	const float texture_height = (float)atlas->height;
+
+	const sprite_id id = (sprite_id)atlas->region_count++;
+	sprite_region* region = &atlas->regions[id];
+	region->u0 = (float)x / texture_width;
+	region->v0 = (float)y / texture_height;
+	region->u1 = region->u0 + ((float)w / texture_width);
+	region->v1 = region->v0 + ((float)h / texture_height);
+	region->width = (uint16_t)w;
+	region->height = (uint16_t)h;
+	atlas->region_names[id] = name;
+
+	return id;
+}
+
+sprite_sequence sprite_atlas_add_sequence(sprite_atlas* atlas, const char* name, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t frame_count, int32_t step_x)
+{
+	assert(frame_count > 0);
+
+	if (atlas->sequence_count == sprite_atlas_max_sequences || atlas->region_count + frame_count > sprite_atlas_max_regions)
+		return {sprite_id_none, 0};
+
+	const sprite_sequence sequence = {(sprite_id)atlas->region_count, (uint16_t)frame_count};
+	for (uint32_t i = 0; i < frame_count; i++)
+		sprite_atlas_add(atlas, nullptr, x + ((int32_t)i * step_x), y, w, h);
+
+	atlas->sequences[atlas->sequence_count] = sequence;
+	atlas->sequence_names[atlas->sequence_count] = name;
+	atlas->sequence_count++;
+
+	return sequence;
+}
+
+sprite_id sprite_atlas_find(const sprite_atlas* atlas, const char* name)
+{
+	for (uint32_t i = 0; i < atlas->region_count; i++)
+	{
+		if (atlas->region_names[i] && strcmp(atlas->region_names[i], name) == 0)
+			return (sprite_id)i;
+	}
+
+	return sprite_id_none;
+}
+
+sprite_sequence sprite_atlas_find_sequence(const sprite_atlas* atlas, const char* name)
+{
+	for (uint32_t i = 0; i < atlas->sequence_count; i++)
+	{
+		if (strcmp(atlas->sequence_names[i], name) == 0)
+			return atlas->sequences[i];
+	}
+
+	return {sprite_id_none, 0};
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+struct texture;
+
+/*
+	Sprite sheet regions, registered once when the sheet is loaded.
+
+	Each region keeps its texture coordinates already divided by the sheet size, so drawing one is
+	a table load plus a few multiply-adds instead of the four divisions per sprite it takes to
+	normalise a pixel rect. Draw calls name a region by its sprite_id, an index into the atlas.
+
+	Animations are sequences of regions with consecutive ids, so frame n of a sequence is just
+	first + n and animation state never needs to know where the frames are on the sheet.
+
+	The atlas is a fixed size table and never allocates. Names are not copied and must outlive the
+	atlas, string literals in practice.
+*/
+typedef uint16_t sprite_id;
+
+constexpr sprite_id sprite_id_none = UINT16_MAX;
+constexpr uint32_t sprite_atlas_max_regions = 256;
+constexpr uint32_t sprite_atlas_max_sequences = 64;
+
+// One sprite as the sprite batch shader reads it, corners in clip space and normalised UVs
+struct sprite
+{
+	float x0;
+	float y0;
+	float x1;
+	float y1;
+	float u0;
+	float v0;
+	float u1;
+	float v1;
+};
+
+struct sprite_region
+{
+	float		u0;
+	float		v0;
+	float		u1;
+	float		v1;
+	uint16_t	width;	// Size in sheet pixels
+	uint16_t	height;
+};
+
+struct sprite_sequence
+{
+	sprite_id	first;
+	uint16_t	frame_count;
+};
+
+struct sprite_atlas
+{
+	texture*		sheet;
+	uint32_t		width;
+	uint32_t		height;
+	uint32_t		region_count;
+	uint32_t		sequence_count;
+	sprite_region	regions[sprite_atlas_max_regions];
+	const char*		region_names[sprite_atlas_max_regions];		// nullptr for sequence frames
+	sprite_sequence	sequences[sprite_atlas_max_sequences];
+	const char*		sequence_names[sprite_atlas_max_sequences];
+};
+
+void sprite_atlas_init(sprite_atlas* atlas, texture* sheet, uint32_t width, uint32_t height);
+
+// Adds one region, returns its id or sprite_id_none if the atlas is full
+sprite_id sprite_atlas_add(sprite_atlas* atlas, const char* name, int32_t x, int32_t y, int32_t w, int32_t h);
+
+/*
+	Adds frame_count regions of the same size, each step_x pixels right of the last, as a sequence.
+	Returns a sequence with no frames if the atlas is full.
+*/
+sprite_sequence sprite_atlas_add_sequence(sprite_atlas* atlas, const char* name, int32_t x, int32_t y, int32_t w, int32_t h, uint32_t frame_count, int32_t step_x);
+
+// Lookups by name are linear scans, meant for load time rather than every frame
+sprite_id sprite_atlas_find(const sprite_atlas* atlas, const char* name);
+sprite_sequence sprite_atlas_find_sequence(const sprite_atlas* atlas, const char* name);
+
+inline const sprite_region* sprite_atlas_region(const sprite_atlas* atlas, sprite_id id)
+{
+	assert(id < atlas->region_count);
+	return &atlas->regions[id];
+}
+
+inline sprite_id sprite_sequence_frame(sprite_sequence sequence, uint32_t frame)
+{
+	assert(frame < sequence.frame_count);
+	return (sprite_id)(sequence.first + frame);
+}
+
+/*
+	Clip space units per display pixel, worked out once per batch rather than per sprite.
+*/
+struct sprite_screen
+{
+	float x_scale;
+	float y_scale;
+};
+
+inline sprite_screen sprite_screen_make(int32_t display_width, int32_t display_height)
+{
+	return {2.0f / (float)display_width, 2.0f / (float)display_height};
+}
+
+// Fills a sprite from pixel rects on the display and sheet, normalising both
+inline void sprite_set_pixels(sprite* s, int32_t display_width, int32_t display_height, uint32_t sheet_width, uint32_t sheet_height,
+	int32_t dst_x, int32_t dst_y, int32_t dst_w, int32_t dst_h, int32_t src_x, int32_t src_y, int32_t src_w, int32_t src_h)
+{
+	const float half_width = (float)display_width / 2;
+	const float half_height = (float)display_height / 2;
+	const float texture_width = (float)sheet_width;
+	const float texture_height = (float)sheet_height;
+
+	s->x0 = ((float)dst_x / half_width) - 1.0f;
+	s->y0 = (((float)dst_y / half_height) * -1.0f) + 1.0f;
+	s->x1 = s->x0 + ((float)dst_w / half_width);
+	s->y1 = s->y0 - ((float)dst_h / half_height);
+	s->u0 = (float)src_x / texture_width;
+	s->v0 = (float)src_y / texture_height;
+	s->u1 = s->u0 + ((float)src_w / texture_width);
+	s->v1 = s->v0 + ((float)src_h / texture_height);
+}
+
+// Fills a sprite from a registered region drawn at dst, scaled by a whole number of pixels
+inline void sprite_set_region(sprite* s, sprite_screen screen, const sprite_region* region, int32_t dst_x, int32_t dst_y, int32_t scale)
+{
+	s->x0 = ((float)dst_x * screen.x_scale) - 1.0f;
+	s->y0 = 1.0f - ((float)dst_y * screen.y_scale);
+	s->x1 = s->x0 + ((float)(region->width * scale) * screen.x_scale);
+	s->y1 = s->y0 - ((float)(region->height * scale) * screen.y_scale);
+	s->u0 = region->u0;
+	s->v0 = region->v0;
+	s->u1 = region->u1;
+	s->v1 = region->v1;
+}
\ No newline at end of file
@@ -65,18 +65,6 @@ float4 mainPS(vertex_output input) : SV_TARGET
 }
 )";
 
-struct sprite
-{
-	float x0;
-	float y0;
-	float x1;
-	float y1;
-	float u0;
-	float v0;
-	float u1;
-	float v1;
-};
-
 constexpr size_t sprite_buffer_size		= 64 * 1024;
 constexpr size_t sprite_buffer_count	= sprite_buffer_size / sizeof(sprite);
 
@@ -114,6 +102,26 @@ static void sprite_batch_flush(sprite_batch* sb)
 	}
 }
 
+// Display sized texture the batch can draw into and copy from
+static void sprite_batch_create_target(sprite_batch* sb, ID3D11Texture2D** texture, ID3D11RenderTargetView** target)
+{
+	D3D11_TEXTURE2D_DESC texture_desc = {};
+	texture_desc.Width = (uint32_t)sb->d3d->display->width;
+	texture_desc.Height = (uint32_t)sb->d3d->display->height;
+	texture_desc.MipLevels = 1;
+	texture_desc.ArraySize = 1;
+	texture_desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+	texture_desc.SampleDesc.Count = 1;
+	texture_desc.SampleDesc.Quality = 0;
+	texture_desc.Usage = D3D11_USAGE_DEFAULT;
+	texture_desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+	texture_desc.CPUAccessFlags = 0;
+	texture_desc.MiscFlags = 0;
+
+	check_hresult(sb->d3d->device->CreateTexture2D(&texture_desc, nullptr, texture));
+	check_hresult(sb->d3d->device->CreateRenderTargetView(*texture, nullptr, target));
+}
+
 void sprite_batch_init(sprite_batch* sb, d3d_context* d3d)
 {
 	sb->d3d = {d3d};
@@ -155,6 +163,12 @@ void sprite_batch_init(sprite_batch* sb, d3d_context* d3d)
 	sampler_desc.MaxLOD = 1;
 
 	check_hresult(d3d->device->CreateSamplerState(&sampler_desc, &sb->sampler));
+
+	sprite_batch_create_target(sb, &sb->layer_texture, &sb->layer_target);
+	sprite_batch_create_target(sb, &sb->frame_texture, &sb->frame_target);
+
+	sprite_layer_init(&sb->static_layer);
+	sprite_dirty_init(&sb->dirty, d3d->display->width, d3d->display->height);
 }
 
 void sprite_batch_term(sprite_batch* sb)
@@ -164,11 +178,19 @@ void sprite_batch_term(sprite_batch* sb)
 	sb->sprite_buffer->Release();
 	sb->srv->Release();
 	sb->sampler->Release();
+	sb->layer_texture->Release();
+	sb->layer_target->Release();
+	sb->frame_texture->Release();
+	sb->frame_target->Release();
+
+	sprite_layer_term(&sb->static_layer);
+	sprite_dirty_term(&sb->dirty);
 }
 
 void sprite_batch_begin(sprite_batch* sb)
 {
 	sprite_batch_map(sb);
+	sb->screen = sprite_screen_make(sb->d3d->display->width, sb->d3d->display->height);
 
 	// Bind the shaders to the Direct3D context
 	sb->d3d->context->VSSetShader(sb->vertex_shader, 0, 0);
@@ -193,20 +215,75 @@ void sprite_batch_draw(sprite_batch* sb, texture* t, int32_t dst_x, int32_t dst_
 
 	sb->current_texture = t;
 
-	const float display_width = (float)sb->d3d->display->width;
-	const float display_height = (float)sb->d3d->display->height;
-	const float half_width = display_width / 2;
-	const float half_height = display_height / 2;
-	const float texture_width = (float)t->width;
-	const float texture_height = (float)t->height;
-
-	sprite* new_sprite = sb->mapped_current++;
-	new_sprite->x0 = ((float)dst_x / half_width) - 1.0f;
-	new_sprite->y0 = (((float)dst_y / half_height) * -1.0f) + 1.0f;
-	new_sprite->x1 = new_sprite->x0 + ((float)dst_w / half_width);
-	new_sprite->y1 = new_sprite->y0 - ((float)dst_h / half_height);
-	new_sprite->u0 = (float)src_x / texture_width;
-	new_sprite->v0 = (float)src_y / texture_height;
-	new_sprite->u1 = new_sprite->u0 + ((float)src_w / texture_width);
-	new_sprite->v1 = new_sprite->v0 + ((float)src_h / texture_height);
+	sprite_set_pixels(sb->mapped_current++, sb->d3d->display->width, sb->d3d->display->height, t->width, t->height, dst_x, dst_y, dst_w, dst_h, src_x, src_y, src_w, src_h);
+}
+
+void sprite_batch_draw_region(sprite_batch* sb, const sprite_atlas* atlas, sprite_id id, int32_t dst_x, int32_t dst_y, int32_t scale)
+{
+	if (sb->mapped_current == sb->mapped_end || atlas->sheet != sb->current_texture)
+	{
+		sprite_batch_flush(sb);
+		sprite_batch_map(sb);
+	}
+
+	sb->current_texture = atlas->sheet;
+
+	sprite_set_region(sb->mapped_current++, sb->screen, sprite_atlas_region(atlas, id), dst_x, dst_y, scale);
+}
+
+void sprite_batch_compose(sprite_batch* sb, const sprite_atlas* atlas, const sprite_instance* sprites, uint32_t count)
+{
+	ID3D11DeviceContext4* context = sb->d3d->context;
+
+	sprite_batch_flush(sb);
+
+	if (sb->static_layer.invalid)
+	{
+		const float clear_colour[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+		context->OMSetRenderTargets(1, &sb->layer_target, nullptr);
+		context->ClearRenderTargetView(sb->layer_target, clear_colour);
+
+		for (const sprite_instance& s : sb->static_layer.sprites)
+			sprite_batch_draw_region(sb, atlas, s.id, s.x, s.y, s.scale);
+		sprite_batch_flush(sb);
+
+		sb->static_layer.invalid = false;
+		sprite_dirty_mark_all(&sb->dirty);
+	}
+
+	sprite_dirty_track(&sb->dirty, atlas, sprites, count);
+	sprite_dirty_collect(&sb->dirty, atlas, sprites, count);
+
+	// Put the static image back under every dirty rect, then draw each rect's sprites clipped to it in one batch
+	for (const sprite_rect& rect : sb->dirty.rects)
+	{
+		const D3D11_BOX box = {(uint32_t)rect.x0, (uint32_t)rect.y0, 0, (uint32_t)rect.x1, (uint32_t)rect.y1, 1};
+		context->CopySubresourceRegion(sb->frame_texture, 0, (uint32_t)rect.x0, (uint32_t)rect.y0, 0, sb->layer_texture, 0, &box);
+	}
+
+	context->OMSetRenderTargets(1, &sb->frame_target, nullptr);
+
+	for (uint32_t i = 0; i < sb->dirty.rects.size(); i++)
+	{
+		for (uint32_t j = sb->dirty.rect_offsets[i]; j < sb->dirty.rect_offsets[i + 1]; j++)
+		{
+			if (sb->mapped_current == sb->mapped_end || atlas->sheet != sb->current_texture)
+			{
+				sprite_batch_flush(sb);
+				sprite_batch_map(sb);
+			}
+
+			sb->current_texture = atlas->sheet;
+			sprite_set_clipped(sb->mapped_current++, sb->screen, atlas, sprites[sb->dirty.rect_sprites[j]], sb->dirty.rects[i]);
+		}
+	}
+	sprite_batch_flush(sb);
+
+	// Flip model back buffers do not keep their contents between frames, so the whole frame is copied
+	ID3D11Resource* back_buffer;
+	sb->d3d->back_buffer->GetResource(&back_buffer);
+	context->CopyResource(back_buffer, sb->frame_texture);
+	back_buffer->Release();
+
+	context->OMSetRenderTargets(1, &sb->d3d->back_buffer, nullptr);
 }
\ No newline at end of file
@@ -1,5 +1,3 @@
-struct sprite;
-
 struct sprite_batch
 {
 	d3d_context*				d3d;
@@ -12,10 +10,30 @@ struct sprite_batch
 	sprite*						mapped_end;
 	sprite*						mapped_current;
 	texture*					current_texture;
+	sprite_screen				screen;				// Display pixel scale, refreshed by sprite_batch_begin
+
+	// Retained rendering, see sprite_layer.h
+	sprite_layer				static_layer;		// Static content, drawn into layer_texture when invalidated
+	sprite_dirty				dirty;
+	ID3D11Texture2D*			layer_texture;
+	ID3D11RenderTargetView*		layer_target;
+	ID3D11Texture2D*			frame_texture;		// Last composed frame, kept so only dirty rects need drawing
+	ID3D11RenderTargetView*		frame_target;
 };
 
 void sprite_batch_init(sprite_batch* sb, d3d_context* d3d);
 void sprite_batch_term(sprite_batch* sb);
 void sprite_batch_begin(sprite_batch* sb);
 void sprite_batch_end(sprite_batch* sb);
-void sprite_batch_draw(sprite_batch* sb, texture* t, int32_t dst_x, int32_t dst_y, int32_t dst_w, int32_t dst_h, int32_t src_x, int32_t src_y, int32_t src_w, int32_t src_h);
\ No newline at end of file
+void sprite_batch_draw(sprite_batch* sb, texture* t, int32_t dst_x, int32_t dst_y, int32_t dst_w, int32_t dst_h, int32_t src_x, int32_t src_y, int32_t src_w, int32_t src_h);
+
+// Draws a region registered in the atlas, at its sheet size times scale, on the atlas's sheet
+void sprite_batch_draw_region(sprite_batch* sb, const sprite_atlas* atlas, sprite_id id, int32_t dst_x, int32_t dst_y, int32_t scale);
+
+/*
+	Composes the frame from the static layer and this frame's dynamic sprites, redrawing only what
+	changed since the last compose, and copies it to the back buffer. Static content is added to
+	sb->static_layer once and drawn again only after it is changed. Anything drawn before this in
+	the frame is covered, sprites drawn after it go on top. The atlas must not change between frames.
+*/
+void sprite_batch_compose(sprite_batch* sb, const sprite_atlas* atlas, const sprite_instance* sprites, uint32_t count);
\ No newline at end of file
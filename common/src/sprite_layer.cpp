@@ -0,0 +1,283 @@
+void sprite_layer_init(sprite_layer* layer)
+{
+	layer->sprites.clear();
+	layer->invalid = true;
+}
+
+void sprite_layer_term(sprite_layer* layer)
+{
+	std::vector<sprite_instance>().swap(layer->sprites);
+}
+
+void sprite_layer_clear(sprite_layer* layer)
+{
+	layer->sprites.clear();
+	layer->invalid = true;
+}
+
+void sprite_layer_add(sprite_layer* layer, sprite_id id, int32_t x, int32_t y, int32_t scale)
+{
+	alloc_tag("sprite_layer");
+
+	assert(scale > 0 && scale <= UINT16_MAX);
+
+	layer->sprites.push_back({x, y, id, (uint16_t)scale});
+	layer->invalid = true;
+}
+
+void sprite_dirty_init(sprite_dirty* dirty, int32_t width, int32_t height)
+{
+	alloc_tag("sprite_dirty");
+
+	const int32_t cell_size = 1 << sprite_dirty_cell_shift;
+
+	dirty->width = width;
+	dirty->height = height;
+	dirty->cells_x = (width + cell_size - 1) >> sprite_dirty_cell_shift;
+	dirty->cells_y = (height + cell_size - 1) >> sprite_dirty_cell_shift;
+	dirty->marks.assign((size_t)dirty->cells_x * dirty->cells_y, 1);
+	dirty->owners.assign(dirty->marks.size(), sprite_dirty_none);
+	dirty->previous.clear();
+
+	// Rect lists never outgrow the fallback limit, so they are sized once here
+	dirty->rects.reserve(sprite_dirty_max_rects + 1);
+	dirty->rect_offsets.reserve(sprite_dirty_max_rects + 2);
+	dirty->rect_stamps.reserve(sprite_dirty_max_rects + 1);
+	dirty->rects.clear();
+	dirty->rect_offsets.assign(1, 0);
+	dirty->rect_sprites.clear();
+}
+
+void sprite_dirty_term(sprite_dirty* dirty)
+{
+	std::vector<uint8_t>().swap(dirty->marks);
+	std::vector<uint32_t>().swap(dirty->owners);
+	std::vector<sprite_instance>().swap(dirty->previous);
+	std::vector<sprite_rect>().swap(dirty->rects);
+	std::vector<uint32_t>().swap(dirty->rect_offsets);
+	std::vector<uint32_t>().swap(dirty->rect_sprites);
+	std::vector<uint32_t>().swap(dirty->rect_stamps);
+}
+
+void sprite_dirty_mark(sprite_dirty* dirty, sprite_rect rect)
+{
+	rect = sprite_rect_intersect(rect, {0, 0, dirty->width, dirty->height});
+	if (sprite_rect_empty(rect))
+		return;
+
+	const int32_t cx0 = rect.x0 >> sprite_dirty_cell_shift, cx1 = (rect.x1 - 1) >> sprite_dirty_cell_shift;
+	const int32_t cy0 = rect.y0 >> sprite_dirty_cell_shift, cy1 = (rect.y1 - 1) >> sprite_dirty_cell_shift;
+	for (int32_t cy = cy0; cy <= cy1; cy++)
+		memset(&dirty->marks[((size_t)cy * dirty->cells_x) + cx0], 1, (size_t)(cx1 - cx0 + 1));
+}
+
+void sprite_dirty_mark_all(sprite_dirty* dirty)
+{
+	std::fill(dirty->marks.begin(), dirty->marks.end(), (uint8_t)1);
+}
+
+void sprite_dirty_track(sprite_dirty* dirty, const sprite_atlas* atlas, const sprite_instance* sprites, uint32_t count)
+{
+	alloc_tag("sprite_dirty");
+
+	const uint32_t previous_count = (uint32_t)dirty->previous.size();
+	for (uint32_t i = 0; i < std::max(count, previous_count); i++)
+	{
+		const bool was = i < previous_count;
+		const bool is = i < count;
+		if (was && is && sprite_instance_equal(dirty->previous[i], sprites[i]))
+			continue;
+
+		if (was)
+			sprite_dirty_mark(dirty, sprite_instance_rect(atlas, dirty->previous[i]));
+		if (is)
+			sprite_dirty_mark(dirty, sprite_instance_rect(atlas, sprites[i]));
+	}
+
+	dirty->previous.assign(sprites, sprites + count);
+}
+
+/*
+	Calls visit(rect) once for every rect the sprite overlaps, found through the owners of the
+	cells under it. Stamps keep a sprite spanning several cells of one rect from being counted twice.
+*/
+template<typename Visit>
+static void sprite_dirty_visit_rects(sprite_dirty* dirty, sprite_rect rect, uint32_t sprite, Visit visit)
+{
+	rect = sprite_rect_intersect(rect, {0, 0, dirty->width, dirty->height});
+	if (sprite_rect_empty(rect))
+		return;
+
+	const int32_t cx0 = rect.x0 >> sprite_dirty_cell_shift, cx1 = (rect.x1 - 1) >> sprite_dirty_cell_shift;
+	const int32_t cy0 = rect.y0 >> sprite_dirty_cell_shift, cy1 = (rect.y1 - 1) >> sprite_dirty_cell_shift;
+	for (int32_t cy = cy0; cy <= cy1; cy++)
+	{
+		const uint32_t* owners = &dirty->owners[(size_t)cy * dirty->cells_x];
+		for (int32_t cx = cx0; cx <= cx1; cx++)
+		{
+			const uint32_t owner = owners[cx];
+			if (owner != sprite_dirty_none && dirty->rect_stamps[owner] != sprite)
+			{
+				dirty->rect_stamps[owner] = sprite;
+				visit(owner);
+			}
+		}
+	}
+}
+
+uint64_t sprite_dirty_collect(sprite_dirty* dirty, const sprite_atlas* atlas, const sprite_instance* sprites, uint32_t count)
+{
+	alloc_tag("sprite_dirty");
+
+	const int32_t cell_size = 1 << sprite_dirty_cell_shift;
+
+	dirty->rects.clear();
+	size_t dirty_cells = 0;
+	bool whole_screen = false;
+
+	for (int32_t cy = 0; cy < dirty->cells_y; cy++)
+	{
+		uint8_t* marks = &dirty->marks[(size_t)cy * dirty->cells_x];
+		uint32_t* owners = &dirty->owners[(size_t)cy * dirty->cells_x];
+		const uint32_t* owners_above = cy ? owners - dirty->cells_x : nullptr;
+
+		for (int32_t cx = 0; cx < dirty->cells_x;)
+		{
+			if (!marks[cx])
+			{
+				owners[cx++] = sprite_dirty_none;
+				continue;
+			}
+
+			int32_t end = cx;
+			while (end < dirty->cells_x && marks[end])
+				marks[end++] = 0;
+			dirty_cells += (size_t)(end - cx);
+
+			const int32_t x0 = cx * cell_size;
+			const int32_t x1 = std::min(end * cell_size, dirty->width);
+			const int32_t y1 = std::min((cy + 1) * cell_size, dirty->height);
+
+			// A rect over the same span of the row above grows down, anything else starts a new rect
+			uint32_t owner = owners_above ? owners_above[cx] : sprite_dirty_none;
+			if (owner != sprite_dirty_none && dirty->rects[owner].x0 == x0 && dirty->rects[owner].x1 == x1)
+				dirty->rects[owner].y1 = y1;
+			else if (dirty->rects.size() < sprite_dirty_max_rects)
+			{
+				owner = (uint32_t)dirty->rects.size();
+				dirty->rects.push_back({x0, cy * cell_size, x1, y1});
+			}
+			else
+			{
+				// Keep going only to clear the marks, the whole screen is redrawn
+				owner = 0;
+				whole_screen = true;
+			}
+
+			for (; cx < end; cx++)
+				owners[cx] = owner;
+		}
+	}
+
+	// Past half the screen one big copy and draw beats many small ones
+	if (whole_screen || dirty_cells * 2 > dirty->marks.size())
+	{
+		dirty->rects.assign(1, {0, 0, dirty->width, dirty->height});
+		std::fill(dirty->owners.begin(), dirty->owners.end(), 0u);
+	}
+
+	// Counting sort of sprites into rects: count each rect's sprites, turn the counts into the ends
+	// of each rect's list, then fill backwards from the last sprite so each list is in order
+	const uint32_t rect_count = (uint32_t)dirty->rects.size();
+	dirty->rect_offsets.assign(rect_count + 1, 0);
+	dirty->rect_stamps.assign(rect_count, sprite_dirty_none);
+
+	for (uint32_t i = 0; i < count; i++)
+		sprite_dirty_visit_rects(dirty, sprite_instance_rect(atlas, sprites[i]), i, [dirty](uint32_t rect) { dirty->rect_offsets[rect]++; });
+
+	for (uint32_t rect = 1; rect <= rect_count; rect++)
+		dirty->rect_offsets[rect] += dirty->rect_offsets[rect - 1];
+
+	dirty->rect_sprites.resize(dirty->rect_offsets[rect_count]);
+	dirty->rect_stamps.assign(rect_count, sprite_dirty_none);
+
+	for (uint32_t i = count; i-- > 0;)
+		sprite_dirty_visit_rects(dirty, sprite_instance_rect(atlas, sprites[i]), i, [dirty, i](uint32_t rect) { dirty->rect_sprites[--dirty->rect_offsets[rect]] = i; });
+
+	uint64_t pixels = 0;
+	for (const sprite_rect& rect : dirty->rects)
+		pixels += sprite_rect_area(rect);
+
+	return pixels;
+}
+
+void sprite_raster_init(sprite_raster* raster, int32_t width, int32_t height)
+{
+	alloc_tag("sprite_raster");
+
+	raster->width = width;
+	raster->height = height;
+	raster->pixels.assign((size_t)width * height, sprite_raster_clear);
+}
+
+void sprite_raster_term(sprite_raster* raster)
+{
+	std::vector<uint32_t>().swap(raster->pixels);
+}
+
+uint64_t sprite_raster_draw(sprite_raster* raster, const sprite_atlas* atlas, const uint32_t* sheet, const sprite_instance& s, sprite_rect clip)
+{
+	const sprite_rect rect = sprite_rect_intersect(sprite_rect_intersect(sprite_instance_rect(atlas, s), clip), {0, 0, raster->width, raster->height});
+	if (sprite_rect_empty(rect))
+		return 0;
+
+	// Pixel rect of the region on the sheet, recovered from its UVs
+	const sprite_region* region = sprite_atlas_region(atlas, s.id);
+	const int32_t src_x = (int32_t)((region->u0 * (float)atlas->width) + 0.5f);
+	const int32_t src_y = (int32_t)((region->v0 * (float)atlas->height) + 0.5f);
+
+	// Pixel centres sampled at the nearest texel, which for whole number scales is a division
+	for (int32_t y = rect.y0; y < rect.y1; y++)
+	{
+		const uint32_t* src = sheet + ((size_t)(src_y + ((y - s.y) / s.scale)) * atlas->width) + src_x;
+		uint32_t* dst = &raster->pixels[(size_t)y * raster->width];
+		for (int32_t x = rect.x0; x < rect.x1; x++)
+			dst[x] = src[(x - s.x) / s.scale];
+	}
+
+	return sprite_rect_area(rect);
+}
+
+uint64_t sprite_raster_draw_layer(sprite_raster* raster, const sprite_layer* layer, const sprite_atlas* atlas, const uint32_t* sheet)
+{
+	std::fill(raster->pixels.begin(), raster->pixels.end(), sprite_raster_clear);
+
+	uint64_t pixels = raster->pixels.size();
+	for (const sprite_instance& s : layer->sprites)
+		pixels += sprite_raster_draw(raster, atlas, sheet, s, {0, 0, raster->width, raster->height});
+
+	return pixels;
+}
+
+uint64_t sprite_raster_compose(sprite_raster* frame, const sprite_raster* layer, const sprite_dirty* dirty, const sprite_atlas* atlas, const uint32_t* sheet,
+	const sprite_instance* sprites)
+{
+	assert(frame->width == layer->width && frame->height == layer->height);
+
+	uint64_t pixels = 0;
+	for (uint32_t i = 0; i < dirty->rects.size(); i++)
+	{
+		const sprite_rect rect = dirty->rects[i];
+		for (int32_t y = rect.y0; y < rect.y1; y++)
+		{
+			const size_t row = ((size_t)y * frame->width) + rect.x0;
+			memcpy(&frame->pixels[row], &layer->pixels[row], (size_t)(rect.x1 - rect.x0) * sizeof(uint32_t));
+		}
+		pixels += sprite_rect_area(rect);
+
+		for (uint32_t j = dirty->rect_offsets[i]; j < dirty->rect_offsets[i + 1]; j++)
+			pixels += sprite_raster_draw(frame, atlas, sheet, sprites[dirty->rect_sprites[j]], rect);
+	}
+
+	return pixels;
+}
\ No newline at end of file
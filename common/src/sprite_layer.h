@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <vector>
+
+/*
+	Retained sprite layers and dirty rectangles.
+
+	Most of a frame is the same as the last: the maze never changes and only the few sprites that
+	moved or changed frame need drawing again. A sprite_layer holds static content, submitted once
+	and kept, which the renderer draws into a cached image only when the layer is invalidated.
+	Dynamic sprites are still submitted every frame, and sprite_dirty compares them with the last
+	frame's to find the parts of the screen that changed: where a sprite was and where it is now,
+	for each sprite whose position or frame differs. Dynamic sprites are matched between frames by
+	their place in the submitted list.
+
+	Only the changed parts are composed, by copying the cached static image back over each dirty
+	rect and drawing the dynamic sprites that overlap it clipped to the rect, in submission order.
+	Clipping cuts the sprite's quad and texture coordinates down to the rect, so every rect's
+	sprites go in one batch without changing state between rects. Changes are marked on a grid of
+	16x16 pixel cells, which keeps the cost per sprite fixed however many overlap, and collected
+	into disjoint rects, each run of dirty cells along a row joining the rect above when it spans
+	the same cells. When the rects would cover most of the screen, or there are so many that the
+	copies cost more than one whole copy, the whole screen is one rect instead.
+
+	sprite_raster is a CPU reference compositor doing the same composition into a pixel buffer,
+	so the tracking can be checked against drawing whole frames on machines without a GPU.
+*/
+constexpr int32_t sprite_dirty_cell_shift = 4;
+constexpr uint32_t sprite_dirty_max_rects = 1024;
+constexpr uint32_t sprite_dirty_none = UINT32_MAX;
+
+// Display pixels, x1 and y1 exclusive
+struct sprite_rect
+{
+	int32_t x0;
+	int32_t y0;
+	int32_t x1;
+	int32_t y1;
+};
+
+// A region of the atlas drawn at a display position, scaled by a whole number of pixels
+struct sprite_instance
+{
+	int32_t		x;
+	int32_t		y;
+	sprite_id	id;
+	uint16_t	scale;
+};
+
+inline bool sprite_instance_equal(const sprite_instance& a, const sprite_instance& b)
+{
+	return a.x == b.x && a.y == b.y && a.id == b.id && a.scale == b.scale;
+}
+
+inline sprite_rect sprite_instance_rect(const sprite_atlas* atlas, const sprite_instance& s)
+{
+	const sprite_region* region = sprite_atlas_region(atlas, s.id);
+	return {s.x, s.y, s.x + (region->width * s.scale), s.y + (region->height * s.scale)};
+}
+
+inline sprite_rect sprite_rect_intersect(sprite_rect a, sprite_rect b)
+{
+	return {std::max(a.x0, b.x0), std::max(a.y0, b.y0), std::min(a.x1, b.x1), std::min(a.y1, b.y1)};
+}
+
+inline bool sprite_rect_empty(sprite_rect r)
+{
+	return r.x0 >= r.x1 || r.y0 >= r.y1;
+}
+
+inline uint64_t sprite_rect_area(sprite_rect r)
+{
+	return sprite_rect_empty(r) ? 0 : (uint64_t)(r.x1 - r.x0) * (uint64_t)(r.y1 - r.y0);
+}
+
+// Fills a sprite with the part of s inside clip, which must overlap it, texture coordinates cut to match
+inline void sprite_set_clipped(sprite* out, sprite_screen screen, const sprite_atlas* atlas, const sprite_instance& s, sprite_rect clip)
+{
+	const sprite_region* region = sprite_atlas_region(atlas, s.id);
+	const sprite_rect full = sprite_instance_rect(atlas, s);
+	const sprite_rect rect = sprite_rect_intersect(full, clip);
+	const float u_scale = (region->u1 - region->u0) / (float)(full.x1 - full.x0);
+	const float v_scale = (region->v1 - region->v0) / (float)(full.y1 - full.y0);
+
+	out->x0 = ((float)rect.x0 * screen.x_scale) - 1.0f;
+	out->y0 = 1.0f - ((float)rect.y0 * screen.y_scale);
+	out->x1 = ((float)rect.x1 * screen.x_scale) - 1.0f;
+	out->y1 = 1.0f - ((float)rect.y1 * screen.y_scale);
+	out->u0 = region->u0 + ((float)(rect.x0 - full.x0) * u_scale);
+	out->v0 = region->v0 + ((float)(rect.y0 - full.y0) * v_scale);
+	out->u1 = region->u0 + ((float)(rect.x1 - full.x0) * u_scale);
+	out->v1 = region->v0 + ((float)(rect.y1 - full.y0) * v_scale);
+}
+
+struct sprite_layer
+{
+	std::vector<sprite_instance>	sprites;	// Drawn in order
+	bool							invalid;	// The cached image no longer matches the sprites
+};
+
+void sprite_layer_init(sprite_layer* layer);
+void sprite_layer_term(sprite_layer* layer);
+
+// Empties the layer, invalidating it
+void sprite_layer_clear(sprite_layer* layer);
+
+// Adds a sprite on top of the layer's content, invalidating it
+void sprite_layer_add(sprite_layer* layer, sprite_id id, int32_t x, int32_t y, int32_t scale);
+
+struct sprite_dirty
+{
+	int32_t							width;			// Display size
+	int32_t							height;
+	int32_t							cells_x;
+	int32_t							cells_y;
+	std::vector<uint8_t>			marks;			// Cells changed since the last collect
+	std::vector<uint32_t>			owners;			// Rect covering each cell after collect, or sprite_dirty_none
+	std::vector<sprite_instance>	previous;		// Dynamic sprites of the last frame
+	std::vector<sprite_rect>		rects;			// Dirty rects found by the last collect
+	std::vector<uint32_t>			rect_offsets;	// First of each rect's sprites in rect_sprites, plus one past the end
+	std::vector<uint32_t>			rect_sprites;	// Dynamic sprites overlapping each rect, in submission order
+	std::vector<uint32_t>			rect_stamps;	// Last sprite listed for each rect while collecting
+};
+
+// Starts with the whole display dirty, as nothing has been composed yet
+void sprite_dirty_init(sprite_dirty* dirty, int32_t width, int32_t height);
+void sprite_dirty_term(sprite_dirty* dirty);
+
+void sprite_dirty_mark(sprite_dirty* dirty, sprite_rect rect);
+void sprite_dirty_mark_all(sprite_dirty* dirty);
+
+// Marks the dynamic sprites that differ from the last frame's, where they were and where they are
+void sprite_dirty_track(sprite_dirty* dirty, const sprite_atlas* atlas, const sprite_instance* sprites, uint32_t count);
+
+/*
+	Turns the marked cells into disjoint rects clipped to the display and lists which sprites
+	overlap each rect, ready to compose. Clears the marks for the next frame. Returns the pixels
+	the rects cover.
+*/
+uint64_t sprite_dirty_collect(sprite_dirty* dirty, const sprite_atlas* atlas, const sprite_instance* sprites, uint32_t count);
+
+// Opaque black, what sprite_batch clears the static image to
+constexpr uint32_t sprite_raster_clear = 0xFF000000;
+
+// 32 bit pixels, the CPU reference for what sprite_batch draws
+struct sprite_raster
+{
+	int32_t					width;
+	int32_t					height;
+	std::vector<uint32_t>	pixels;
+};
+
+void sprite_raster_init(sprite_raster* raster, int32_t width, int32_t height);
+void sprite_raster_term(sprite_raster* raster);
+
+/*
+	Draws a sprite from the sheet's pixels, atlas->width by atlas->height, clipped to the rect.
+	Sampling is nearest neighbour without blending, as sprite_batch's point sampler and default
+	blend state draw. Returns the pixels written.
+*/
+uint64_t sprite_raster_draw(sprite_raster* raster, const sprite_atlas* atlas, const uint32_t* sheet, const sprite_instance& s, sprite_rect clip);
+
+// Clears the raster and draws every sprite of the layer
+uint64_t sprite_raster_draw_layer(sprite_raster* raster, const sprite_layer* layer, const sprite_atlas* atlas, const uint32_t* sheet);
+
+/*
+	Composes the dirty rects of the last sprite_dirty_collect into frame, which holds the last
+	composed frame: each rect is copied from the cached static image and then its sprites are
+	drawn over it. Returns the pixels written.
+*/
+uint64_t sprite_raster_compose(sprite_raster* frame, const sprite_raster* layer, const sprite_dirty* dirty, const sprite_atlas* atlas, const uint32_t* sheet,
+	const sprite_instance* sprites);
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "../../common/src/headless.h"
+
+// Pathfinding headers shared with pathman
+#include "../../pathman/src/path_find.h"
+#include "../../pathman/src/path_packed.h"
+#include "../../pathman/src/path_landmarks.h"
+#include "../../pathman/src/path_search.h"
+#include "../../pathman/src/grid_layout.h"
+#include "../../pathman/src/path_prune.h"
+#include "../../pathman/src/path_first_moves.h"
+#include "../../pathman/src/path_bounds.h"
+#include "../../pathman/src/path_schedule.h"
+#include "../../pathman/src/path_nearest.h"
+#include "../../pathman/src/path_cooperative.h"
+#include "../../pathman/src/path_parallel.h"
+#include "../../pathman/src/path_database.h"
+#include "../../pathman/src/path_sparse.h"
+#include "../../pathman/src/spatial_hash.h"
+#include "../../pathman/src/entity.h"
+#include "../../pathman/src/maze.h"
+#include "../../pathman/src/maze_gen.h"
+#include "../../pathman/src/movingai.h"
+
+// Our cpp files to be compiled
+#include "../../pathman/src/path_find.cpp"
+#include "../../pathman/src/grid_layout.cpp"
+#include "../../pathman/src/path_packed.cpp"
+#include "../../pathman/src/path_landmarks.cpp"
+#include "../../pathman/src/path_prune.cpp"
+#include "../../pathman/src/path_first_moves.cpp"
+#include "../../pathman/src/path_bounds.cpp"
+#include "../../pathman/src/path_schedule.cpp"
+#include "../../pathman/src/path_nearest.cpp"
+#include "../../pathman/src/path_cooperative.cpp"
+#include "../../pathman/src/path_parallel.cpp"
+#include "../../pathman/src/path_database.cpp"
+#include "../../pathman/src/path_sparse.cpp"
+#include "../../pathman/src/spatial_hash.cpp"
+#include "../../pathman/src/entity.cpp"
+#include "../../pathman/src/maze_gen.cpp"
+#include "../../pathman/src/movingai.cpp"
+#include "../../pathbench/src/pathbench.cpp"
\ No newline at end of file
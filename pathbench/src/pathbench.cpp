@@ -0,0 +1,3052 @@
+#include <chrono>
+#include <float.h>
+#include <math.h>
+
+#ifdef __linux__
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#endif
+
+/*
+	Headless pathfinding benchmarks. Run with the name of the benchmark to execute:
+
+		pathbench bidirectional
+		pathbench landmarks
+		pathbench specialised
+		pathbench sliced
+		pathbench scaling [max size]
+		pathbench allocations
+		pathbench nearest
+		pathbench cooperative
+		pathbench parallel [size]
+		pathbench database [size]
+		pathbench spatial
+		pathbench entities [count]
+		pathbench handoff
+		pathbench packed
+		pathbench prune
+		pathbench scen <file.scen> [map directory]
+		pathbench sprites [count]
+		pathbench arena
+		pathbench suboptimal
+		pathbench layouts [size]
+		pathbench sparse
+		pathbench bounds [size]
+		pathbench compose [n]
+
+	A leak report is printed on exit in builds with ALLOC_PROFILE enabled.
+*/
+
+static uint64_t bench_random_state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t bench_random(uint32_t range)
+{
+	// xorshift64* is plenty for picking query endpoints and carving test mazes
+	bench_random_state ^= bench_random_state >> 12;
+	bench_random_state ^= bench_random_state << 25;
+	bench_random_state ^= bench_random_state >> 27;
+
+	return (uint32_t)(((bench_random_state * 0x2545F4914F6CDD1Dull) >> 32) % range);
+}
+
+static double bench_time_us()
+{
+	using namespace std::chrono;
+	return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct bench_map
+{
+	const char*				name;
+	tile_grid				grid;
+	std::vector<uint8_t>	tiles;
+};
+
+static void bench_map_finish(bench_map* map, const char* name, int32_t width, int32_t height)
+{
+	tile_flags_from_walkable(map->tiles.data(), width, height);
+	map->name = name;
+	map->grid = {width, height, map->tiles.data()};
+}
+
+// Single room with a wall around the edge
+static void bench_make_open(bench_map* map, const char* name, int32_t width, int32_t height)
+{
+	map->tiles.assign((size_t)width * height, 0);
+	for (int32_t y = 1; y < height - 1; y++)
+		memset(&map->tiles[(size_t)y * width + 1], 1, width - 2);
+
+	bench_map_finish(map, name, width, height);
+}
+
+// Generated maze of any kind, perfect by default
+static void bench_make_maze(bench_map* map, const char* name, int32_t width, int32_t height, maze_kind kind = maze_kind_perfect, uint64_t seed = 1)
+{
+	maze_generate(&map->tiles, width, height, kind, seed);
+	map->name = name;
+	map->grid = {width, height, map->tiles.data()};
+}
+
+static std::vector<tile_pos> bench_open_tiles(const tile_grid* grid)
+{
+	std::vector<tile_pos> open_tiles;
+	for (int32_t y = 0; y < grid->height; y++)
+	{
+		for (int32_t x = 0; x < grid->width; x++)
+		{
+			if (tile_grid_get(grid, x, y) != tile_flags_wall)
+				open_tiles.push_back({x, y});
+		}
+	}
+
+	return open_tiles;
+}
+
+static std::vector<path_query> bench_random_queries(const tile_grid* grid, uint32_t count)
+{
+	const std::vector<tile_pos> open_tiles = bench_open_tiles(grid);
+
+	std::vector<path_query> queries;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const tile_pos start = open_tiles[bench_random((uint32_t)open_tiles.size())];
+		const tile_pos goal = open_tiles[bench_random((uint32_t)open_tiles.size())];
+		queries.push_back({start, goal, path_mode_astar});
+	}
+
+	return queries;
+}
+
+static std::vector<path_query> bench_all_pairs_queries(const tile_grid* grid)
+{
+	const std::vector<tile_pos> open_tiles = bench_open_tiles(grid);
+
+	std::vector<path_query> queries;
+	for (tile_pos start : open_tiles)
+	{
+		for (tile_pos goal : open_tiles)
+			queries.push_back({start, goal, path_mode_astar});
+	}
+
+	return queries;
+}
+
+struct bench_mode_result
+{
+	uint64_t	nodes_expanded;
+	uint64_t	cost;
+	double		time_us;
+};
+
+static bench_mode_result bench_run_queries(path_finder* pf, std::vector<path_query> queries, path_mode mode)
+{
+	bench_mode_result result = {};
+	std::vector<tile_pos> path;
+
+	for (path_query& query : queries)
+	{
+		query.mode = mode;
+
+		path_stats stats;
+		const double begin = bench_time_us();
+		path_find(pf, &query, &path, &stats);
+		result.time_us += bench_time_us() - begin;
+
+		result.nodes_expanded += stats.nodes_expanded;
+		result.cost += stats.cost;
+	}
+
+	return result;
+}
+
+static const uint32_t bench_standard_map_count = 3;
+
+// Shipped maze plus a large open and a large maze-like grid
+static void bench_make_standard_maps(bench_map* maps)
+{
+	maps[0].name = "shipped maze 28x31";
+	maps[0].grid = maze_grid;
+	bench_make_open(&maps[1], "open room 512x512", 512, 512);
+	bench_make_maze(&maps[2], "perfect maze 511x511", 511, 511);
+}
+
+// Every pair of open tiles on the shipped maze, a fixed random sample on larger maps
+static std::vector<path_query> bench_standard_queries(const bench_map* map)
+{
+	if (map->grid.tiles == maze_grid.tiles)
+		return bench_all_pairs_queries(&map->grid);
+
+	return bench_random_queries(&map->grid, 1000);
+}
+
+/*
+	Compares nodes expanded by plain and bidirectional A* over the same queries. Both searches are
+	optimal so the summed path costs must match exactly.
+*/
+static void bench_bidirectional()
+{
+	bench_map maps[bench_standard_map_count];
+	bench_make_standard_maps(maps);
+
+	printf("%-22s %8s %14s %14s %10s %12s %12s\n", "map", "queries", "astar exp", "bidir exp", "reduction", "astar us", "bidir us");
+
+	for (bench_map& map : maps)
+	{
+		const std::vector<path_query> queries = bench_standard_queries(&map);
+
+		path_finder pf;
+		path_finder_init(&pf, &map.grid);
+
+		const bench_mode_result astar = bench_run_queries(&pf, queries, path_mode_astar);
+		const bench_mode_result bidirectional = bench_run_queries(&pf, queries, path_mode_bidirectional);
+
+		path_finder_term(&pf);
+
+		if (astar.cost != bidirectional.cost)
+			printf("%s: path cost mismatch, astar %llu bidirectional %llu\n", map.name, (unsigned long long)astar.cost, (unsigned long long)bidirectional.cost);
+
+		const double count = (double)queries.size();
+		printf("%-22s %8zu %14.1f %14.1f %9.1f%% %12.2f %12.2f\n",
+			map.name,
+			queries.size(),
+			astar.nodes_expanded / count,
+			bidirectional.nodes_expanded / count,
+			100.0 * (1.0 - ((double)bidirectional.nodes_expanded / astar.nodes_expanded)),
+			astar.time_us / count,
+			bidirectional.time_us / count);
+	}
+}
+
+/*
+	Compares A* with plain Manhattan distance against the ALT landmark bound, including the cost of
+	building the landmark tables.
+*/
+static void bench_landmarks()
+{
+	bench_map maps[bench_standard_map_count];
+	bench_make_standard_maps(maps);
+
+	printf("%-22s %9s %12s %14s %14s %14s %10s %12s %12s\n", "map", "landmarks", "build ms", "bytes/lmark", "manhattan exp", "alt exp", "reduction", "manhattan us", "alt us");
+
+	for (bench_map& map : maps)
+	{
+		const std::vector<path_query> queries = bench_standard_queries(&map);
+		const double count = (double)queries.size();
+
+		path_finder pf;
+		path_finder_init(&pf, &map.grid);
+
+		const bench_mode_result manhattan = bench_run_queries(&pf, queries, path_mode_astar);
+
+		for (uint32_t landmark_count : {4u, 8u})
+		{
+			path_landmarks lm;
+			const double begin = bench_time_us();
+			path_landmarks_build(&lm, &map.grid, landmark_count);
+			const double build_us = bench_time_us() - begin;
+
+			pf.landmarks = &lm;
+			const bench_mode_result alt = bench_run_queries(&pf, queries, path_mode_astar);
+			pf.landmarks = nullptr;
+
+			if (alt.cost != manhattan.cost)
+				printf("%s: path cost mismatch, manhattan %llu alt %llu\n", map.name, (unsigned long long)manhattan.cost, (unsigned long long)alt.cost);
+
+			// Tables are padded to the SIMD stride, spread that over the landmarks in use
+			const double table_bytes = (double)map.grid.width * map.grid.height * lm.stride * sizeof(uint16_t);
+
+			printf("%-22s %9u %12.2f %14.0f %14.1f %14.1f %9.1f%% %12.2f %12.2f\n",
+				map.name,
+				lm.count,
+				build_us / 1000.0,
+				table_bytes / lm.count,
+				manhattan.nodes_expanded / count,
+				alt.nodes_expanded / count,
+				100.0 * (1.0 - ((double)alt.nodes_expanded / manhattan.nodes_expanded)),
+				manhattan.time_us / count,
+				alt.time_us / count);
+
+			path_landmarks_term(&lm);
+		}
+
+		path_finder_term(&pf);
+	}
+}
+
+template<typename Grid>
+static double bench_specialised_run(path_finder* pf, const Grid& grid, const std::vector<path_query>& queries, uint64_t* cost)
+{
+	std::vector<tile_pos> path;
+	path_stats stats;
+
+	*cost = 0;
+	const double begin = bench_time_us();
+	for (const path_query& query : queries)
+	{
+		path_search(pf, grid, &query, heuristic_manhattan{query.goal}, &path, &stats);
+		*cost += stats.cost;
+	}
+
+	return (bench_time_us() - begin) / queries.size();
+}
+
+template<int32_t Width, int32_t Height>
+static void bench_specialised_map(const char* name, const tile_grid* grid)
+{
+	const std::vector<path_query> queries = (grid->tiles == maze_grid.tiles) ? bench_all_pairs_queries(grid) : bench_random_queries(grid, 1000);
+
+	path_finder pf;
+	path_finder_init(&pf, grid);
+
+	// Best of several interleaved rounds, the first of which also warms up node arrays and heaps
+	uint64_t runtime_cost = 0, dynamic_cost = 0, static_cost = 0;
+	double runtime_us = DBL_MAX, dynamic_us = DBL_MAX, static_us = DBL_MAX;
+	for (uint32_t round = 0; round < 5; round++)
+	{
+		const bench_mode_result runtime = bench_run_queries(&pf, queries, path_mode_astar);
+		runtime_us = std::min(runtime_us, runtime.time_us / queries.size());
+		runtime_cost = runtime.cost;
+		dynamic_us = std::min(dynamic_us, bench_specialised_run(&pf, grid_dynamic(grid), queries, &dynamic_cost));
+		static_us = std::min(static_us, bench_specialised_run(&pf, grid_static<Width, Height>(grid), queries, &static_cost));
+	}
+
+	path_finder_term(&pf);
+
+	if (runtime_cost != dynamic_cost || runtime_cost != static_cost)
+		printf("%s: path cost mismatch\n", name);
+
+	printf("%-22s %8zu %12.2f %12.2f %12.2f %9.2fx\n", name, queries.size(), runtime_us, dynamic_us, static_us, runtime_us / static_us);
+}
+
+/*
+	Compares the runtime dimension search behind path_find against path_search instantiated with
+	the same Manhattan heuristic on grid_dynamic and on grid_static for each map size.
+*/
+static void bench_specialised()
+{
+	bench_map open_512, maze_511, maze_512;
+	bench_make_open(&open_512, "open room 512x512", 512, 512);
+	bench_make_maze(&maze_511, "perfect maze 511x511", 511, 511);
+	bench_make_maze(&maze_512, "perfect maze 512x512", 512, 512);
+
+	printf("%-22s %8s %12s %12s %12s %10s\n", "map", "queries", "path_find us", "dynamic us", "static us", "speedup");
+
+	bench_specialised_map<tile_map_width, tile_map_height>("shipped maze 28x31", &maze_grid);
+	bench_specialised_map<512, 512>(open_512.name, &open_512.grid);
+	bench_specialised_map<511, 511>(maze_511.name, &maze_511.grid);
+	bench_specialised_map<512, 512>(maze_512.name, &maze_512.grid);
+}
+
+// Value below which the given fraction of the samples fall, sorting the samples in place
+static double bench_percentile(std::vector<double>* samples, double fraction)
+{
+	if (samples->empty())
+		return 0.0;
+
+	std::sort(samples->begin(), samples->end());
+	const size_t rank = (size_t)(fraction * samples->size());
+	return (*samples)[std::min(rank, samples->size() - 1)];
+}
+
+struct bench_sliced_request
+{
+	uint32_t	agent;
+	path_query	query;
+};
+
+/*
+	Simulates a game issuing a steady stream of path requests from many agents. Without slicing
+	every request is searched to completion on the frame it arrives, with slicing the scheduler
+	spends at most the budget per frame and the rest carries over. Frame time here is the time
+	spent pathfinding each frame, latency is frames from request to completed path.
+*/
+static void bench_sliced()
+{
+	const uint32_t agent_count = 64;
+	const uint32_t slot_count = 8;
+	const uint32_t frame_count = 1200;
+	const uint32_t requests_per_frame = 2;
+
+	bench_map maze;
+	bench_make_maze(&maze, "perfect maze 511x511", 511, 511);
+
+	path_landmarks lm;
+	path_landmarks_build(&lm, &maze.grid, path_landmark_max);
+
+	// Same request stream for every run, agents asking in turn
+	const std::vector<path_query> queries = bench_random_queries(&maze.grid, frame_count * requests_per_frame);
+	std::vector<bench_sliced_request> requests;
+	for (uint32_t i = 0; i < queries.size(); i++)
+		requests.push_back({i % agent_count, queries[i]});
+
+	printf("%s, %u agents, %u requests per frame, %u frames\n", maze.name, agent_count, requests_per_frame, frame_count);
+	printf("%-16s %10s %10s %10s %10s %12s %12s %10s %10s\n", "mode", "budget us", "mean us", "p50 us", "p99 us", "max us", "latency avg", "p99", "completed");
+
+	std::vector<double> frame_us;
+	std::vector<double> latency;
+
+	// Unsliced, everything requested this frame is searched this frame
+	{
+		path_finder pf;
+		path_finder_init(&pf, &maze.grid);
+		pf.landmarks = &lm;
+
+		std::vector<tile_pos> path;
+		double total_us = 0.0;
+		frame_us.clear();
+
+		for (uint32_t frame = 0; frame < frame_count; frame++)
+		{
+			const double begin = bench_time_us();
+			for (uint32_t i = 0; i < requests_per_frame; i++)
+				path_find(&pf, &requests[(frame * requests_per_frame) + i].query, &path, nullptr);
+			frame_us.push_back(bench_time_us() - begin);
+			total_us += frame_us.back();
+		}
+
+		path_finder_term(&pf);
+
+		const double max_us = bench_percentile(&frame_us, 1.0);
+		printf("%-16s %10s %10.0f %10.0f %10.0f %12.0f %12.2f %10.0f %10u\n", "unsliced", "-", total_us / frame_count,
+			bench_percentile(&frame_us, 0.5), bench_percentile(&frame_us, 0.99), max_us, 0.0, 0.0, frame_count * requests_per_frame);
+	}
+
+	for (double budget_us : {2000.0, 4000.0, 8000.0})
+	{
+		path_schedule ps;
+		path_schedule_init(&ps, &maze.grid, &lm, slot_count, agent_count, 256);
+
+		// Tracks which agents are waiting on a search, to catch each one as it completes
+		std::vector<uint8_t> was_pending(agent_count, 0);
+		uint32_t completed = 0;
+		double total_us = 0.0;
+		frame_us.clear();
+		latency.clear();
+
+		for (uint32_t frame = 0; frame < frame_count; frame++)
+		{
+			const double begin = bench_time_us();
+			for (uint32_t i = 0; i < requests_per_frame; i++)
+			{
+				const bench_sliced_request& request = requests[(frame * requests_per_frame) + i];
+				path_schedule_request(&ps, request.agent, &request.query);
+				was_pending[request.agent] = 1;
+			}
+			path_schedule_update(&ps, UINT32_MAX, budget_us);
+			frame_us.push_back(bench_time_us() - begin);
+			total_us += frame_us.back();
+
+			for (uint32_t agent = 0; agent < agent_count; agent++)
+			{
+				const bool pending = path_schedule_pending(&ps, agent);
+				if (was_pending[agent] && !pending)
+				{
+					latency.push_back(ps.agents[agent].latency);
+					completed++;
+				}
+				was_pending[agent] = pending;
+			}
+		}
+
+		path_schedule_term(&ps);
+
+		double latency_total = 0.0;
+		for (double frames : latency)
+			latency_total += frames;
+
+		const double latency_avg = latency.empty() ? 0.0 : latency_total / latency.size();
+		printf("%-16s %10.0f %10.0f %10.0f %10.0f %12.0f %12.2f %10.0f %10u\n", "sliced", budget_us, total_us / frame_count,
+			bench_percentile(&frame_us, 0.5), bench_percentile(&frame_us, 0.99), bench_percentile(&frame_us, 1.0),
+			latency_avg, bench_percentile(&latency, 0.99), completed);
+	}
+
+	path_landmarks_term(&lm);
+}
+
+/*
+	Sweeps every generated map kind from 32x32 up to the given size, doubling each time, and reports
+	how search time, finder memory and node expansions grow. Queries come with their optimal costs
+	from maze_generate_queries, so every result is also checked for optimality. Large maps get fewer
+	queries to keep the sweep practical.
+*/
+static void bench_scaling(int32_t max_size)
+{
+	printf("%-6s %-10s %6s %10s %8s %12s %10s %12s %10s %12s\n", "size", "kind", "open%", "gen ms", "queries", "expanded", "exp/cost", "us/query", "ns/exp", "finder KB");
+
+	for (int32_t size = 32; size <= max_size; size *= 2)
+	{
+		const size_t tile_count = (size_t)size * size;
+		const uint32_t query_count = (uint32_t)std::max<size_t>(8, std::min<size_t>(1000, ((size_t)1 << 26) / tile_count));
+
+		for (uint32_t kind = 0; kind < maze_kind_count; kind++)
+		{
+			bench_map map;
+			double begin = bench_time_us();
+			bench_make_maze(&map, maze_kind_names[kind], size, size, (maze_kind)kind, size + kind);
+			const double gen_us = bench_time_us() - begin;
+
+			size_t open_count = 0;
+			for (uint8_t tile : map.tiles)
+				open_count += tile != tile_flags_wall;
+
+			std::vector<path_query> queries;
+			std::vector<uint32_t> distances;
+			maze_generate_queries(&map.grid, query_count, 8, kind, &queries, &distances);
+
+			path_finder pf;
+			path_finder_init(&pf, &map.grid);
+
+			std::vector<tile_pos> path;
+			uint64_t expanded = 0, cost = 0;
+			uint32_t wrong = 0;
+			begin = bench_time_us();
+			for (uint32_t i = 0; i < queries.size(); i++)
+			{
+				path_stats stats;
+				if (!path_find(&pf, &queries[i], &path, &stats) || stats.cost != distances[i])
+					wrong++;
+				expanded += stats.nodes_expanded;
+				cost += stats.cost;
+			}
+			const double search_us = bench_time_us() - begin;
+
+			// Node array plus the open list at its high water mark
+			const size_t finder_bytes = (tile_count * sizeof(path_node)) + (pf.open[0].capacity() * sizeof(path_open_entry));
+			path_finder_term(&pf);
+
+			if (wrong)
+				printf("%dx%d %s: %u queries did not match their optimal cost\n", size, size, map.name, wrong);
+
+			printf("%-6d %-10s %5.1f%% %10.2f %8zu %12.1f %10.2f %12.2f %10.1f %12.0f\n",
+				size,
+				map.name,
+				100.0 * open_count / tile_count,
+				gen_us / 1000.0,
+				queries.size(),
+				(double)expanded / queries.size(),
+				cost ? (double)expanded / cost : 0.0,
+				search_us / queries.size(),
+				expanded ? (search_us * 1000.0) / expanded : 0.0,
+				finder_bytes / 1024.0);
+		}
+	}
+}
+
+/*
+	Finds the nearest of 10, 100 and 1000 random goals from a set of starts three ways: one A* per
+	goal keeping the cheapest, a single nearest goal search, and a multi-source distance field
+	built once for the goal set and then walked downhill from each start. All three must agree on
+	the distance.
+*/
+static void bench_nearest()
+{
+	const uint32_t start_count = 20;
+
+	bench_map maps[2];
+	bench_make_maze(&maps[0], "corridors 256x256", 256, 256, maze_kind_corridors, 3);
+	bench_make_maze(&maps[1], "rooms 256x256", 256, 256, maze_kind_rooms, 3);
+
+	printf("%-18s %7s %14s %14s %12s %12s %12s %10s\n", "map", "goals", "repeated us", "nearest us", "nearest exp", "field us", "walk us", "speedup");
+
+	for (bench_map& map : maps)
+	{
+		const std::vector<tile_pos> open_tiles = bench_open_tiles(&map.grid);
+
+		std::vector<tile_pos> starts;
+		for (uint32_t i = 0; i < start_count; i++)
+			starts.push_back(open_tiles[bench_random((uint32_t)open_tiles.size())]);
+
+		path_finder pf;
+		path_finder_init(&pf, &map.grid);
+
+		for (uint32_t goal_count : {10u, 100u, 1000u})
+		{
+			path_goal_set goals;
+			path_goal_set_init(&goals, &map.grid);
+
+			std::vector<tile_pos> goal_tiles;
+			while (goals.count < goal_count)
+			{
+				const tile_pos goal = open_tiles[bench_random((uint32_t)open_tiles.size())];
+				if (!path_goal_set_contains(&goals, (uint32_t)((goal.y * map.grid.width) + goal.x)))
+					goal_tiles.push_back(goal);
+				path_goal_set_add(&goals, goal);
+			}
+
+			std::vector<tile_pos> path;
+			std::vector<uint32_t> repeated_cost, nearest_cost, walk_cost;
+			uint64_t nearest_expanded = 0;
+
+			double begin = bench_time_us();
+			for (tile_pos start : starts)
+			{
+				uint32_t best = UINT32_MAX;
+				for (tile_pos goal : goal_tiles)
+				{
+					path_stats stats;
+					const path_query query = {start, goal, path_mode_astar};
+					if (path_find(&pf, &query, &path, &stats))
+						best = std::min(best, stats.cost);
+				}
+				repeated_cost.push_back(best);
+			}
+			const double repeated_us = (bench_time_us() - begin) / start_count;
+
+			begin = bench_time_us();
+			for (tile_pos start : starts)
+			{
+				path_stats stats;
+				nearest_cost.push_back(path_find_nearest(&pf, start, &goals, &path, &stats) ? stats.cost : UINT32_MAX);
+				nearest_expanded += stats.nodes_expanded;
+			}
+			const double nearest_us = (bench_time_us() - begin) / start_count;
+
+			std::vector<uint32_t> distances;
+			begin = bench_time_us();
+			path_goal_distances(&goals, &distances);
+			const double field_us = bench_time_us() - begin;
+
+			begin = bench_time_us();
+			for (tile_pos start : starts)
+				walk_cost.push_back(path_goal_distances_path(&map.grid, distances, start, &path) ? (uint32_t)path.size() - 1 : UINT32_MAX);
+			const double walk_us = (bench_time_us() - begin) / start_count;
+
+			if (repeated_cost != nearest_cost || repeated_cost != walk_cost)
+				printf("%s: nearest goal distance mismatch with %u goals\n", map.name, goal_count);
+
+			printf("%-18s %7u %14.1f %14.2f %12.1f %12.1f %12.2f %9.0fx\n",
+				map.name,
+				goal_count,
+				repeated_us,
+				nearest_us,
+				(double)nearest_expanded / start_count,
+				field_us,
+				walk_us,
+				repeated_us / nearest_us);
+
+			path_goal_set_term(&goals);
+		}
+
+		path_finder_term(&pf);
+	}
+}
+
+/*
+	Lifelong multi-agent pathfinding: agents start on distinct random tiles and are given a new
+	random goal each time they reach one. Cooperative runs use the WHCA* planner under a fixed per
+	tick budget. Independent runs give each agent its own shortest path ignoring the others, as
+	separate path_find calls would, and show how often agents collide without cooperation.
+*/
+static void bench_cooperative_run(const bench_map* map, uint32_t agent_count, bool cooperative)
+{
+	const uint32_t tick_count = 200;
+	const path_coop_config config = {16, 8, 512, 400000};
+
+	std::vector<tile_pos> open_tiles = bench_open_tiles(&map->grid);
+	for (size_t i = open_tiles.size() - 1; i > 0; i--)
+		std::swap(open_tiles[i], open_tiles[bench_random((uint32_t)i + 1)]);
+
+	std::vector<tile_pos> before(agent_count), after(agent_count), goals(agent_count);
+	for (uint32_t i = 0; i < agent_count; i++)
+	{
+		after[i] = open_tiles[i];
+		goals[i] = open_tiles[bench_random((uint32_t)open_tiles.size())];
+	}
+
+	path_coop coop;
+	path_finder pf;
+	std::vector<std::vector<tile_pos>> paths(agent_count);
+	std::vector<uint32_t> steps(agent_count, 0);
+
+	if (cooperative)
+	{
+		path_coop_init(&coop, &map->grid, agent_count, &config);
+		for (uint32_t i = 0; i < agent_count; i++)
+			path_coop_place(&coop, i, after[i], goals[i]);
+	}
+	else
+		path_finder_init(&pf, &map->grid);
+
+	std::vector<uint32_t> scratch((size_t)map->grid.width * map->grid.height, path_coop_no_agent);
+	uint64_t conflicts = 0, reached = 0;
+	double total_us = 0.0, worst_us = 0.0;
+
+	for (uint32_t tick = 0; tick < tick_count; tick++)
+	{
+		before = after;
+
+		const double begin = bench_time_us();
+		if (cooperative)
+		{
+			path_coop_tick(&coop);
+			for (uint32_t i = 0; i < agent_count; i++)
+				after[i] = coop.agents[i].pos;
+		}
+		else
+		{
+			for (uint32_t i = 0; i < agent_count; i++)
+			{
+				if (steps[i] == 0)
+				{
+					const path_query query = {after[i], goals[i], path_mode_astar};
+					path_find(&pf, &query, &paths[i], nullptr);
+				}
+				if (steps[i] + 1 < paths[i].size())
+					after[i] = paths[i][++steps[i]];
+			}
+		}
+		const double tick_us = bench_time_us() - begin;
+		total_us += tick_us;
+		worst_us = std::max(worst_us, tick_us);
+
+		conflicts += path_coop_count_conflicts(&map->grid, before.data(), after.data(), agent_count, &scratch);
+
+		for (uint32_t i = 0; i < agent_count; i++)
+		{
+			if (after[i].x != goals[i].x || after[i].y != goals[i].y)
+				continue;
+
+			reached++;
+			goals[i] = open_tiles[bench_random((uint32_t)open_tiles.size())];
+			steps[i] = 0;
+			if (cooperative)
+				path_coop_set_goal(&coop, i, goals[i]);
+		}
+	}
+
+	printf("%-18s %7u %-12s %10.3f %10.3f %12.0f %10.1f %10.2f %10.2f %10.2f %10.3f %9llu\n",
+		map->name,
+		agent_count,
+		cooperative ? "whca*" : "independent",
+		total_us / tick_count / 1000.0,
+		worst_us / 1000.0,
+		agent_count / (total_us / tick_count / 1000.0),
+		cooperative ? (double)coop.stats.replans / tick_count : 0.0,
+		cooperative ? (double)coop.stats.bumps / tick_count : 0.0,
+		cooperative ? (double)coop.stats.deferred / tick_count : 0.0,
+		cooperative ? (double)coop.stats.failed / tick_count : 0.0,
+		1000.0 * conflicts / ((double)agent_count * tick_count),
+		(unsigned long long)reached);
+
+	if (cooperative)
+		path_coop_term(&coop);
+	else
+		path_finder_term(&pf);
+}
+
+static void bench_cooperative()
+{
+	bench_map maps[2];
+	bench_make_maze(&maps[0], "rooms 256x256", 256, 256, maze_kind_rooms, 5);
+	bench_make_maze(&maps[1], "braided 256x256", 256, 256, maze_kind_braided, 5);
+
+	printf("%-18s %7s %-12s %10s %10s %12s %10s %10s %10s %10s %10s %9s\n", "map", "agents", "planner", "ms/tick", "worst ms", "agents/ms", "replans", "bumps", "deferred", "failed", "conf/1k", "goals");
+
+	for (const bench_map& map : maps)
+	{
+		for (uint32_t agent_count : {256u, 1024u, 4096u})
+		{
+			bench_cooperative_run(&map, agent_count, false);
+			bench_cooperative_run(&map, agent_count, true);
+		}
+	}
+}
+
+/*
+	Single query speedup of the parallel breadth first search against its thread count, on maps of
+	the given size and larger. Each query runs from the first open tile to the last, across the
+	whole map, and its cost is checked against A*.
+*/
+static void bench_parallel(int32_t size)
+{
+	const uint32_t thread_counts[] = {1, 2, 4, 8, 16};
+	const uint32_t repeats = 3;
+
+	printf("%u hardware threads\n", std::thread::hardware_concurrency());
+	printf("%-22s %8s %10s %10s %8s %10s %10s %10s %10s\n", "map", "threads", "ms/query", "speedup", "levels", "parallel", "bottom-up", "visited", "A* ms");
+
+	for (int32_t map_size = size; map_size <= size * 2; map_size *= 2)
+	{
+		bench_map maps[3];
+		bench_make_open(&maps[0], "open", map_size, map_size);
+		bench_make_maze(&maps[1], "rooms", map_size, map_size, maze_kind_rooms, 7);
+		bench_make_maze(&maps[2], "braided", map_size, map_size, maze_kind_braided, 7);
+
+		for (bench_map& map : maps)
+		{
+			const std::vector<tile_pos> open_tiles = bench_open_tiles(&map.grid);
+			const path_query query = {open_tiles.front(), open_tiles.back(), path_mode_astar};
+
+			char name[64];
+			snprintf(name, sizeof(name), "%s %dx%d", map.name, map_size, map_size);
+
+			std::vector<tile_pos> path;
+			path_stats astar_stats;
+			path_finder pf;
+			path_finder_init(&pf, &map.grid);
+			double begin = bench_time_us();
+			path_find(&pf, &query, &path, &astar_stats);
+			const double astar_us = bench_time_us() - begin;
+			path_finder_term(&pf);
+
+			double single_us = 0.0;
+			for (uint32_t threads : thread_counts)
+			{
+				path_parallel pp;
+				path_parallel_init(&pp, &map.grid, threads);
+
+				path_stats stats;
+				double best_us = DBL_MAX;
+				for (uint32_t i = 0; i < repeats; i++)
+				{
+					begin = bench_time_us();
+					const bool found = path_parallel_find(&pp, &query, &path, &stats);
+					best_us = std::min(best_us, bench_time_us() - begin);
+
+					if (!found || stats.cost != astar_stats.cost || path.size() != stats.cost + 1)
+						printf("%s: parallel search cost %u does not match A* cost %u\n", name, stats.cost, astar_stats.cost);
+				}
+
+				if (threads == 1)
+					single_us = best_us;
+
+				printf("%-22s %8u %10.2f %9.2fx %8u %10u %10u %10u %10.2f\n",
+					name,
+					threads,
+					best_us / 1000.0,
+					single_us / best_us,
+					pp.levels,
+					pp.parallel_levels,
+					pp.bottom_up_levels,
+					stats.nodes_generated,
+					astar_us / 1000.0);
+
+				path_parallel_term(&pp);
+			}
+		}
+	}
+}
+
+/*
+	Builds a compressed path database for a rooms map of the given size, saves it and maps it back
+	from the file, then compares first move and whole path lookups against A* on random queries.
+	Every database path must be as short as the A* path.
+*/
+static void bench_database(int32_t size)
+{
+	const char* filename = "pathbench.pdb";
+	const uint32_t query_count = 10000;
+	const uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+	bench_map map;
+	bench_make_maze(&map, "rooms", size, size, maze_kind_rooms, 11);
+
+	path_database built;
+	double begin = bench_time_us();
+	path_database_build(&built, &map.grid, threads);
+	const double build_us = bench_time_us() - begin;
+
+	const bool saved = path_database_save(&built, filename);
+	path_database_close(&built);
+
+	path_database db;
+	if (!saved || !path_database_open(&db, filename))
+	{
+		printf("could not save and map %s\n", filename);
+		return;
+	}
+
+	const double raw_bytes = (double)db.open_count * db.open_count / 4.0;
+	printf("%s %dx%d, %u walkable tiles, built on %u threads in %.1f s\n", map.name, size, size, db.open_count, threads, build_us / 1000000.0);
+	printf("%u runs, %.2f per source, %.1f MB on disk, %.1fx smaller than a 2 bit all-pairs table\n",
+		db.run_count, (double)db.run_count / db.open_count, path_database_size(&db) / (1024.0 * 1024.0), raw_bytes / path_database_size(&db));
+
+	const std::vector<path_query> queries = bench_random_queries(&map.grid, query_count);
+
+	// Touch every run once so the first-move timing is not page faults of the fresh mapping
+	uint64_t checksum = 0;
+	for (uint32_t i = 0; i < db.run_count; i++)
+		checksum += db.runs[i];
+
+	begin = bench_time_us();
+	for (const path_query& query : queries)
+		checksum += path_database_first_move(&db, query.start, query.goal);
+	const double first_move_us = (bench_time_us() - begin) / query_count;
+
+	std::vector<tile_pos> path;
+	uint64_t moves = 0;
+	std::vector<uint32_t> database_cost;
+	begin = bench_time_us();
+	for (const path_query& query : queries)
+	{
+		database_cost.push_back(path_database_path(&db, query.start, query.goal, &path) ? (uint32_t)path.size() - 1 : UINT32_MAX);
+		moves += path.size() - 1;
+	}
+	const double path_us = (bench_time_us() - begin) / query_count;
+
+	path_finder pf;
+	path_finder_init(&pf, &map.grid);
+
+	uint32_t mismatches = 0;
+	begin = bench_time_us();
+	for (uint32_t i = 0; i < query_count; i++)
+	{
+		path_stats stats;
+		const bool found = path_find(&pf, &queries[i], &path, &stats);
+		mismatches += (found ? stats.cost : UINT32_MAX) != database_cost[i];
+	}
+	const double astar_us = (bench_time_us() - begin) / query_count;
+	path_finder_term(&pf);
+
+	printf("first move %.3f us, whole path %.2f us (%.3f us per move), A* %.2f us, %.0fx faster (checksum %llu)\n",
+		first_move_us, path_us, path_us * query_count / moves, astar_us, astar_us / path_us, (unsigned long long)checksum);
+	if (mismatches)
+		printf("%u database paths did not match the A* cost\n", mismatches);
+
+	path_database_close(&db);
+	remove(filename);
+}
+
+/*
+	Random walks count entities on an open map, then finds every pair within one move of each other
+	as a collision pass would. The spatial hash is kept up to date either with incremental moves,
+	sorted again once a quarter of the entities have changed bucket, or with a full counting sort
+	rebuild each tick. Up to 10k entities both are checked against the
+	pairwise test.
+*/
+static void bench_spatial_run(const bench_map* map, uint32_t count)
+{
+	const uint32_t ticks = 20;
+	const int32_t radius = 1;
+
+	const std::vector<tile_pos> open_tiles = bench_open_tiles(&map->grid);
+	const grid_dynamic grid(&map->grid);
+
+	std::vector<tile_pos> positions(count);
+	for (tile_pos& pos : positions)
+		pos = open_tiles[bench_random((uint32_t)open_tiles.size())];
+
+	spatial_hash incremental, rebuilt;
+	spatial_hash_init(&incremental, map->grid.width, map->grid.height, 3, count);
+	spatial_hash_init(&rebuilt, map->grid.width, map->grid.height, 3, count);
+	for (uint32_t id = 0; id < count; id++)
+	{
+		spatial_hash_insert(&incremental, id, positions[id]);
+		spatial_hash_insert(&rebuilt, id, positions[id]);
+	}
+	spatial_hash_rebuild(&incremental);
+
+	double incremental_update_us = 0.0, rebuild_update_us = 0.0, incremental_query_us = 0.0, rebuild_query_us = 0.0, pairwise_us = 0.0;
+	uint64_t pairs[3] = {};
+	std::vector<uint32_t> ids;
+
+	for (uint32_t tick = 0; tick < ticks; tick++)
+	{
+		for (tile_pos& pos : positions)
+		{
+			const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[grid.index(pos)]);
+			const uint32_t direction = neighbours.directions[bench_random(neighbours.count)];
+			pos.x += tile_direction_dx[direction];
+			pos.y += tile_direction_dy[direction];
+		}
+
+		double begin = bench_time_us();
+		for (uint32_t id = 0; id < count; id++)
+			spatial_hash_move(&incremental, id, positions[id]);
+		if (incremental.moved > count / 4)
+			spatial_hash_rebuild(&incremental);
+		incremental_update_us += bench_time_us() - begin;
+
+		begin = bench_time_us();
+		rebuilt.positions = positions;
+		for (uint32_t id = 0; id < count; id++)
+			rebuilt.cells[id] = spatial_hash_cell(&rebuilt, positions[id]);
+		spatial_hash_rebuild(&rebuilt);
+		rebuild_update_us += bench_time_us() - begin;
+
+		spatial_hash* hashes[2] = {&incremental, &rebuilt};
+		double* query_us[2] = {&incremental_query_us, &rebuild_query_us};
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			begin = bench_time_us();
+			for (uint32_t id = 0; id < count; id++)
+			{
+				ids.clear();
+				spatial_hash_query_radius(hashes[i], positions[id], radius, &ids);
+				pairs[i] += ids.size() - 1;
+			}
+			*query_us[i] += bench_time_us() - begin;
+		}
+
+		if (count <= 10000)
+		{
+			begin = bench_time_us();
+			for (uint32_t a = 0; a < count; a++)
+			{
+				for (uint32_t b = a + 1; b < count; b++)
+					pairs[2] += manhattan_distance(positions[a], positions[b]) <= radius ? 2 : 0;
+			}
+			pairwise_us += bench_time_us() - begin;
+		}
+	}
+
+	printf("%7u entities: moves %8.1f us + queries %8.1f us, rebuild %8.1f us + queries %8.1f us",
+		count, incremental_update_us / ticks, incremental_query_us / ticks, rebuild_update_us / ticks, rebuild_query_us / ticks);
+	if (count <= 10000)
+		printf(", pairwise %10.1f us", pairwise_us / ticks);
+	printf(", %.2f neighbours each\n", (double)pairs[0] / ((double)count * ticks));
+
+	if (pairs[0] != pairs[1] || (count <= 10000 && pairs[0] != pairs[2]))
+		printf("pair counts differ: %llu incremental, %llu rebuilt, %llu pairwise\n", (unsigned long long)pairs[0], (unsigned long long)pairs[1], (unsigned long long)pairs[2]);
+
+	spatial_hash_term(&incremental);
+	spatial_hash_term(&rebuilt);
+}
+
+static void bench_spatial()
+{
+	bench_map map;
+	bench_make_open(&map, "open", 1024, 1024);
+
+	printf("%s %dx%d, radius 1 collision queries for every entity, per tick:\n", map.name, map.grid.width, map.grid.height);
+	for (uint32_t count : {1000u, 10000u, 100000u})
+		bench_spatial_run(&map, count);
+}
+
+/*
+	Ticks count animated agents walking random paths: movement, animation and sprite emission into
+	a plain array standing in for the sprite batch. The same work is timed over an array of
+	structs holding every agent's state in one record, the layout pathman's globals grow into.
+*/
+struct bench_entity_aos
+{
+	tile_pos				pos;
+	uint16_t				anim_counter;
+	uint16_t				anim_length;
+	uint8_t					frame_ticks;
+	sprite_id				sprite_first;
+	sprite_id				sprite;
+	uint16_t				move_period;
+	uint16_t				move_timer;
+	uint32_t				path_step;
+	std::vector<tile_pos>	path;
+	char					other_state[64];	// Health, AI state and so on that these systems never read
+};
+
+struct bench_sprite_out
+{
+	int32_t		x, y;
+	sprite_id	sprite;
+};
+
+static void bench_entities(uint32_t count)
+{
+	const uint32_t ticks = 100;
+
+	bench_map map;
+	bench_make_open(&map, "open", 1024, 1024);
+	const std::vector<tile_pos> open_tiles = bench_open_tiles(&map.grid);
+	const grid_dynamic grid(&map.grid);
+
+	// Sprite ids only, no texture is needed to run the systems
+	sprite_atlas atlas;
+	sprite_atlas_init(&atlas, nullptr, 1024, 512);
+	const sprite_sequence pathman_animation = sprite_atlas_add_sequence(&atlas, "pathman", 457, 1, 14, 14, 3, 16);
+	const sprite_sequence ghost_animation = sprite_atlas_add_sequence(&atlas, "ghost", 585, 65, 14, 14, 2, 16);
+
+	entity_store es;
+	entity_store_init(&es, count);
+	std::vector<bench_entity_aos> aos(count);
+	std::vector<tile_pos> path;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const bool ghost = bench_random(2) == 0;
+		const entity_desc desc = {
+			open_tiles[bench_random((uint32_t)open_tiles.size())],
+			ghost ? ghost_animation : pathman_animation, 8, (uint16_t)(1 + bench_random(20))
+		};
+		const entity_handle handle = entity_create(&es, &desc);
+
+		// Random walk of 64 tiles from the entity's tile
+		path.assign(1, desc.pos);
+		for (uint32_t step = 0; step < 64; step++)
+		{
+			const tile_pos pos = path.back();
+			const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[grid.index(pos)]);
+			const uint32_t direction = neighbours.directions[bench_random(neighbours.count)];
+			path.push_back({pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]});
+		}
+		path_packed packed;
+		path_packed_from_tiles(&packed, path.data(), (uint32_t)path.size());
+		entity_set_path(&es, handle, &packed);
+
+		bench_entity_aos* a = &aos[i];
+		a->pos = desc.pos;
+		a->anim_counter = 0;
+		a->anim_length = (uint16_t)(desc.animation.frame_count * desc.frame_ticks);
+		a->frame_ticks = desc.frame_ticks;
+		a->sprite_first = a->sprite = desc.animation.first;
+		a->move_period = a->move_timer = desc.move_period;
+		a->path_step = 1;
+		a->path = path;
+	}
+
+	std::vector<bench_sprite_out> sprites(count);
+	uint64_t checksum[2] = {};
+
+	double begin = bench_time_us();
+	for (uint32_t tick = 0; tick < ticks; tick++)
+	{
+		for (uint32_t i = 0; i < es.count; i++)
+			sprites[i] = {es.positions[i].x, es.positions[i].y, es.sprite_ids[i]};
+
+		entity_update_movement(&es);
+		entity_update_animation(&es);
+		checksum[0] += (uint32_t)sprites[tick % count].x + (uint32_t)sprites[tick % count].sprite;
+	}
+	const double soa_us = (bench_time_us() - begin) / ticks;
+
+	begin = bench_time_us();
+	for (uint32_t tick = 0; tick < ticks; tick++)
+	{
+		for (uint32_t i = 0; i < count; i++)
+			sprites[i] = {aos[i].pos.x, aos[i].pos.y, aos[i].sprite};
+
+		for (bench_entity_aos& a : aos)
+		{
+			if (--a.move_timer == 0)
+			{
+				a.move_timer = a.move_period;
+				if (a.path_step < a.path.size())
+					a.pos = a.path[a.path_step++];
+			}
+		}
+
+		for (bench_entity_aos& a : aos)
+		{
+			a.anim_counter = a.anim_counter + 1u == a.anim_length ? 0 : (uint16_t)(a.anim_counter + 1u);
+			a.sprite = (sprite_id)(a.sprite_first + (a.anim_counter / a.frame_ticks));
+		}
+		checksum[1] += (uint32_t)sprites[tick % count].x + (uint32_t)sprites[tick % count].sprite;
+	}
+	const double aos_us = (bench_time_us() - begin) / ticks;
+
+	// Churn: destroy a random half and create them again, then check every handle still resolves
+	std::vector<entity_handle> handles;
+	for (uint32_t i = 0; i < es.count; i++)
+		handles.push_back({es.slots[i], es.slot_generations[es.slots[i]]});
+
+	begin = bench_time_us();
+	uint32_t stale = 0;
+	for (uint32_t i = 0; i < count; i += 2)
+	{
+		const entity_handle old = handles[i];
+		entity_destroy(&es, old);
+		const entity_desc desc = {open_tiles[bench_random((uint32_t)open_tiles.size())], pathman_animation, 8, 20};
+		handles[i] = entity_create(&es, &desc);
+		stale += entity_index(&es, old) != entity_none;
+	}
+	const double churn_us = bench_time_us() - begin;
+
+	uint32_t lost = 0;
+	for (const entity_handle handle : handles)
+		lost += entity_index(&es, handle) == entity_none;
+
+	printf("%u agents, per tick: structure of arrays %.1f us (%.2f ns per agent), array of structs %.1f us (%.2f ns per agent)\n",
+		count, soa_us, soa_us * 1000.0 / count, aos_us, aos_us * 1000.0 / count);
+	printf("destroy and create %u agents: %.1f us, %u stale handles resolved, %u handles lost\n", (count + 1) / 2, churn_us, stale, lost);
+	if (checksum[0] != checksum[1])
+		printf("layouts disagree: checksums %llu and %llu\n", (unsigned long long)checksum[0], (unsigned long long)checksum[1]);
+
+	entity_store_term(&es);
+}
+
+/*
+	Checks and times the lock-free handoff between a simulation and a render thread. A writer
+	publishes numbered snapshots through the triple buffer while a reader keeps picking up the
+	latest. Every snapshot the reader sees must be complete (every word carries the same number),
+	numbers must never go backwards and the last one read once the writer is done must be the last
+	published. A reader slower than the writer must drop snapshots rather than hold the writer up.
+	Latency is the time from publish to the reader first seeing the snapshot. The SPSC queue is
+	then run with one thread pushing a sequence of numbers that the other must pop in order with
+	none missing. Returns 1 if any check fails, so the run can gate a build.
+*/
+struct bench_snapshot
+{
+	uint32_t	sequence;
+	double		published_us;
+	uint32_t	payload[254];
+};
+
+// Spin rather than sleep, sleeps are far coarser than the shorter intervals
+static void bench_spin_until(double until_us)
+{
+	while (bench_time_us() < until_us)
+		std::this_thread::yield();
+}
+
+static bool bench_handoff_snapshots(double publish_interval_us, double read_interval_us, uint32_t count)
+{
+	static triple_buffer<bench_snapshot> tb;
+	std::atomic<bool> done{false};
+	std::vector<double> latencies;
+	latencies.reserve(count);
+	uint32_t torn = 0, backwards = 0, seen = 0, last = 0;
+
+	std::thread reader([&]()
+	{
+		while (!done.load(std::memory_order_acquire))
+		{
+			bool fresh;
+			const bench_snapshot* snapshot = triple_buffer_read(&tb, &fresh);
+			if (!fresh)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			const double read_us = bench_time_us();
+			latencies.push_back(read_us - snapshot->published_us);
+			seen++;
+
+			for (uint32_t word : snapshot->payload)
+				torn += word != snapshot->sequence;
+			backwards += snapshot->sequence < last;
+			last = snapshot->sequence;
+
+			// A slow reader holds on to its snapshot, which must stay intact while the writer carries on
+			bench_spin_until(read_us + read_interval_us);
+			for (uint32_t word : snapshot->payload)
+				torn += word != snapshot->sequence;
+		}
+	});
+
+	const double begin = bench_time_us();
+	for (uint32_t sequence = 1; sequence <= count; sequence++)
+	{
+		bench_snapshot* snapshot = triple_buffer_back(&tb);
+		snapshot->sequence = sequence;
+		for (uint32_t& word : snapshot->payload)
+			word = sequence;
+		snapshot->published_us = bench_time_us();
+		triple_buffer_publish(&tb);
+
+		bench_spin_until(begin + publish_interval_us * sequence);
+	}
+
+	done.store(true, std::memory_order_release);
+	reader.join();
+
+	// Everything was published before done, so one more read must give the final snapshot. It also
+	// clears the fresh bit so the next run starts with nothing waiting
+	const uint32_t final_sequence = triple_buffer_read(&tb)->sequence;
+
+	const uint32_t dropped = count - seen;
+	const bool must_drop = read_interval_us > publish_interval_us;
+	const bool passed = torn == 0 && backwards == 0 && final_sequence == count && (!must_drop || dropped > 0);
+
+	printf("publish every %6.0f us, read every %6.0f us: %u of %u snapshots seen, latency p50 %.1f us, p99 %.1f us, max %.1f us, %u torn words, %u out of order, last read %u%s\n",
+		publish_interval_us, read_interval_us, seen, count, bench_percentile(&latencies, 0.5), bench_percentile(&latencies, 0.99), bench_percentile(&latencies, 1.0),
+		torn, backwards, final_sequence, passed ? "" : " FAILED");
+	return passed;
+}
+
+static bool bench_handoff_queue(uint32_t count)
+{
+	static spsc_queue<uint32_t, 1024> q;
+	uint32_t missing = 0, full = 0, popped = 0;
+
+	const double begin = bench_time_us();
+	std::thread reader([&]()
+	{
+		uint32_t value;
+		for (uint32_t expected = 0; expected < count;)
+		{
+			if (!spsc_queue_pop(&q, &value))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			popped++;
+			missing += value != expected;
+			expected = value + 1;
+		}
+	});
+
+	for (uint32_t value = 0; value < count;)
+	{
+		if (spsc_queue_push(&q, value))
+			value++;
+		else
+		{
+			full++;
+			std::this_thread::yield();
+		}
+	}
+
+	reader.join();
+	const double elapsed_us = bench_time_us() - begin;
+
+	uint32_t leftover;
+	const bool passed = missing == 0 && popped == count && !spsc_queue_pop(&q, &leftover);
+
+	printf("spsc queue: %u items in %.1f ms (%.1f ns each), writer found it full %u times, %u popped, %u out of sequence%s\n",
+		count, elapsed_us / 1000.0, elapsed_us * 1000.0 / count, full, popped, missing, passed ? "" : " FAILED");
+	return passed;
+}
+
+static int bench_handoff()
+{
+	printf("triple buffer, %u byte snapshots, %u hardware threads:\n", (uint32_t)sizeof(bench_snapshot), std::thread::hardware_concurrency());
+	bool passed = bench_handoff_snapshots(16667.0, 0.0, 120);
+	passed &= bench_handoff_snapshots(1000.0, 0.0, 2000);
+	passed &= bench_handoff_snapshots(0.0, 0.0, 200000);
+	passed &= bench_handoff_snapshots(100.0, 1000.0, 2000);
+	passed &= bench_handoff_queue(10000000);
+
+	return passed ? 0 : 1;
+}
+
+/*
+	Gives thousands of agents a live path each, stored as a std::vector of tiles per agent or as a
+	path_packed, then plans every path again as agents would when their goals change. Reports the
+	memory held per path, allocations made by each round (only counted in ALLOC_PROFILE builds),
+	search time and the time to walk every path. Packed paths must match the tile paths move for
+	move, up to the packed capacity.
+*/
+static uint64_t bench_packed_allocs()
+{
+	return alloc_profile_totals().all.allocs;
+}
+
+static void bench_packed()
+{
+	const uint32_t agent_count = 10000;
+	const uint32_t rounds = 2;
+
+	bench_map map;
+	bench_make_maze(&map, "rooms", 128, 128, maze_kind_rooms, 5);
+
+	path_finder pf;
+	path_finder_init(&pf, &map.grid);
+
+	std::vector<std::vector<tile_pos>> tile_paths(agent_count);
+	std::vector<path_packed> packed_paths(agent_count);
+	std::vector<tile_pos> decoded;
+
+	// Warm the finder so its open list growth is not counted against either layout
+	for (const path_query& query : bench_random_queries(&map.grid, 100))
+		path_find(&pf, &query, &decoded, nullptr);
+
+	printf("%s %dx%d, %u agents, packed capacity %u moves in %u bytes%s\n", map.name, map.grid.width, map.grid.height, agent_count,
+		path_packed_capacity, (uint32_t)sizeof(path_packed), ALLOC_PROFILE ? "" : ", allocations not counted without ALLOC_PROFILE");
+
+	uint32_t mismatches = 0;
+	for (uint32_t round = 0; round < rounds; round++)
+	{
+		const std::vector<path_query> queries = bench_random_queries(&map.grid, agent_count);
+
+		uint64_t allocs = bench_packed_allocs();
+		double begin = bench_time_us();
+		for (uint32_t i = 0; i < agent_count; i++)
+			path_find(&pf, &queries[i], &tile_paths[i], nullptr);
+		const double tile_us = bench_time_us() - begin;
+		const uint64_t tile_allocs = bench_packed_allocs() - allocs;
+
+		allocs = bench_packed_allocs();
+		begin = bench_time_us();
+		for (uint32_t i = 0; i < agent_count; i++)
+			path_find(&pf, &queries[i], &packed_paths[i], nullptr);
+		const double packed_us = bench_time_us() - begin;
+		const uint64_t packed_allocs = bench_packed_allocs() - allocs;
+
+		size_t tile_bytes = 0;
+		uint64_t moves = 0;
+		uint32_t truncated = 0;
+		for (uint32_t i = 0; i < agent_count; i++)
+		{
+			const std::vector<tile_pos>& tiles = tile_paths[i];
+			tile_bytes += sizeof(tiles) + (tiles.capacity() * sizeof(tile_pos));
+			moves += tiles.size() - 1;
+			truncated += packed_paths[i].truncated;
+
+			path_packed_to_tiles(&packed_paths[i], &decoded);
+			const size_t kept = std::min(tiles.size(), (size_t)path_packed_capacity + 1);
+			mismatches += decoded.size() != kept || !std::equal(decoded.begin(), decoded.end(), tiles.begin(), [](tile_pos a, tile_pos b) { return a.x == b.x && a.y == b.y; });
+			mismatches += packed_paths[i].truncated != (tiles.size() > kept);
+		}
+
+		// Walk every path to its end, summing tiles so the loops are not optimised away
+		int64_t checksum[2] = {};
+		begin = bench_time_us();
+		for (const std::vector<tile_pos>& tiles : tile_paths)
+		{
+			for (size_t step = 1; step < tiles.size(); step++)
+				checksum[0] += tiles[step].x + tiles[step].y;
+		}
+		const double tile_walk_us = bench_time_us() - begin;
+
+		begin = bench_time_us();
+		for (const path_packed& packed : packed_paths)
+		{
+			path_cursor cursor = path_cursor_begin(&packed);
+			while (path_cursor_next(&packed, &cursor))
+				checksum[1] += cursor.pos.x + cursor.pos.y;
+		}
+		const double packed_walk_us = bench_time_us() - begin;
+
+		printf("round %u, %.0f moves per path, %u truncated:\n", round + 1, (double)moves / agent_count, truncated);
+		printf("  tiles   %6.1f bytes per path, %6llu allocations, search %6.1f ms, walk %7.1f us\n",
+			(double)tile_bytes / agent_count, (unsigned long long)tile_allocs, tile_us / 1000.0, tile_walk_us);
+		printf("  packed  %6.1f bytes per path, %6llu allocations, search %6.1f ms, walk %7.1f us%s\n",
+			(double)sizeof(path_packed), (unsigned long long)packed_allocs, packed_us / 1000.0, packed_walk_us, truncated ? " (truncated paths end early)" : "");
+		if (!truncated && checksum[0] != checksum[1])
+			printf("walk checksums differ\n");
+	}
+
+	if (mismatches)
+		printf("%u packed paths did not match the tile paths\n", mismatches);
+
+	path_finder_term(&pf);
+}
+
+/*
+	Prunes dead ends and swamps on the shipped maze and each generated layout, then runs the same
+	random A* queries with and without pruning. Costs must match. A second pass toggles random
+	walls on a map, updating the pruning incrementally after each change, and checks queries
+	against unpruned searches of the changed map as it goes.
+*/
+static void bench_prune_map(const char* name, const tile_grid* grid)
+{
+	const uint32_t query_count = 2000;
+
+	path_prune prune = {};
+	double begin = bench_time_us();
+	path_prune_build(&prune, grid);
+	const double build_us = bench_time_us() - begin;
+
+	const uint32_t open_count = (uint32_t)bench_open_tiles(grid).size();
+	const std::vector<path_query> queries = bench_random_queries(grid, query_count);
+
+	path_finder pf;
+	path_finder_init(&pf, grid);
+
+	std::vector<tile_pos> path;
+	std::vector<uint32_t> costs(query_count);
+	uint64_t expanded[2] = {};
+	double search_us[2] = {};
+	uint32_t mismatches = 0;
+
+	for (uint32_t pruned = 0; pruned < 2; pruned++)
+	{
+		path_finder_set_prune(&pf, pruned ? &prune : nullptr);
+
+		begin = bench_time_us();
+		for (uint32_t i = 0; i < query_count; i++)
+		{
+			path_stats stats;
+			const uint32_t cost = path_find(&pf, &queries[i], &path, &stats) ? stats.cost : UINT32_MAX;
+			expanded[pruned] += stats.nodes_expanded;
+			if (!pruned)
+				costs[i] = cost;
+			else
+				mismatches += cost != costs[i];
+		}
+		search_us[pruned] = bench_time_us() - begin;
+	}
+
+	printf("%-10s %5.1f%% pruned (%4.1f%% dead ends, %4.1f%% swamps) in %7.0f us, expanded %6.0f -> %6.0f, search %7.2f -> %7.2f us, %.2fx\n",
+		name, 100.0 * path_prune_count(&prune) / open_count, 100.0 * prune.dead_end_count / open_count, 100.0 * prune.swamp_count / open_count,
+		build_us, (double)expanded[0] / query_count, (double)expanded[1] / query_count, search_us[0] / query_count, search_us[1] / query_count, search_us[0] / search_us[1]);
+	if (mismatches)
+		printf("%u pruned searches did not match the full grid\n", mismatches);
+
+	path_finder_term(&pf);
+	path_prune_term(&prune);
+}
+
+static void bench_prune_updates(maze_kind kind)
+{
+	const uint32_t changes = 200;
+	const uint32_t checks_per_change = 20;
+
+	bench_map map;
+	bench_make_maze(&map, maze_kind_names[kind], 256, 256, kind, 9);
+
+	path_prune prune = {};
+	path_prune_build(&prune, &map.grid);
+
+	path_finder plain, pruned;
+	path_finder_init(&plain, &map.grid);
+	path_finder_init(&pruned, &map.grid);
+	path_finder_set_prune(&pruned, &prune);
+
+	std::vector<tile_pos> path;
+	double update_us = 0.0;
+	uint32_t mismatches = 0;
+
+	for (uint32_t change = 0; change < changes; change++)
+	{
+		const int32_t x = 1 + (int32_t)bench_random(map.grid.width - 2);
+		const int32_t y = 1 + (int32_t)bench_random(map.grid.height - 2);
+		uint8_t* tile = &map.tiles[(size_t)y * map.grid.width + x];
+		*tile = *tile == tile_flags_wall ? 1 : tile_flags_wall;
+
+		// Rebuilding every tile's flags is simpler than patching the neighbours, and is not timed
+		for (int32_t ny = y - 1; ny <= y + 1; ny++)
+		{
+			for (int32_t nx = x - 1; nx <= x + 1; nx++)
+			{
+				uint8_t* neighbour = &map.tiles[(size_t)ny * map.grid.width + nx];
+				if (*neighbour != tile_flags_wall)
+					*neighbour = 1;
+			}
+		}
+		tile_flags_from_walkable(map.tiles.data(), map.grid.width, map.grid.height);
+
+		const double begin = bench_time_us();
+		path_prune_update(&prune, x, y, x, y);
+		update_us += bench_time_us() - begin;
+
+		for (const path_query& query : bench_random_queries(&map.grid, checks_per_change))
+		{
+			path_stats stats[2];
+			const uint32_t plain_cost = path_find(&plain, &query, &path, &stats[0]) ? stats[0].cost : UINT32_MAX;
+			const uint32_t pruned_cost = path_find(&pruned, &query, &path, &stats[1]) ? stats[1].cost : UINT32_MAX;
+			mismatches += plain_cost != pruned_cost;
+		}
+	}
+
+	const uint32_t incremental_count = path_prune_count(&prune);
+	const double begin = bench_time_us();
+	path_prune_build(&prune, &map.grid);
+	const double build_us = bench_time_us() - begin;
+
+	printf("%-10s %u wall toggles: update %.1f us each vs %.0f us full build, %u tiles pruned incrementally vs %u rebuilt, %u of %u checks mismatched\n",
+		map.name, changes, update_us / changes, build_us, incremental_count, path_prune_count(&prune), mismatches, changes * checks_per_change);
+
+	path_finder_term(&plain);
+	path_finder_term(&pruned);
+	path_prune_term(&prune);
+}
+
+static void bench_prune()
+{
+	bench_prune_map("shipped", &maze_grid);
+	for (uint32_t kind = 0; kind < maze_kind_count; kind++)
+	{
+		bench_map map;
+		bench_make_maze(&map, maze_kind_names[kind], 256, 256, (maze_kind)kind, 9);
+		bench_prune_map(map.name, &map.grid);
+	}
+
+	bench_map open;
+	bench_make_open(&open, "open", 256, 256);
+	bench_prune_map(open.name, &open.grid);
+
+	for (maze_kind kind : {maze_kind_perfect, maze_kind_rooms})
+		bench_prune_updates(kind);
+}
+
+/*
+	Runs every scenario of a MovingAI .scen file with A* and prints the results as JSON. Maps are
+	looked up in map_dir (by default the .scen file's directory), first by the path written in the
+	scenario and then by its file name alone.
+
+	Searches are 4-connected, so costs are checked two ways: a breadth first search from each goal
+	gives the exact 4-connected optimum, which every cost must equal, and the 8-connected reference
+	length must never be longer. Latency is timed per query, and the BFS check is not timed. A
+	scenario whose start or goal is off its map or on a wall is an error, as a malformed line is.
+	Expansion and cost means only cover the scenarios whose path was found.
+*/
+struct bench_scen_bucket
+{
+	std::vector<double>	latencies;
+	uint32_t			found;
+	uint64_t			expanded;
+	uint32_t			max_expanded;
+	double				cost;
+	double				reference;
+};
+
+static void bench_json_string(const char* s)
+{
+	putchar('"');
+	for (; *s; s++)
+	{
+		if (*s == '"' || *s == '\\')
+			putchar('\\');
+		putchar(*s);
+	}
+	putchar('"');
+}
+
+static bool bench_scen_load_map(const char* map_dir, const char* name, movingai_map* map)
+{
+	char path[1024];
+	snprintf(path, sizeof(path), "%s/%s", map_dir, name);
+
+	FILE* file = fopen(path, "r");
+	if (!file)
+	{
+		const char* base = strrchr(name, '/');
+		snprintf(path, sizeof(path), "%s/%s", map_dir, base ? base + 1 : name);
+	}
+	else
+		fclose(file);
+
+	return movingai_load_map(path, map);
+}
+
+static int bench_scenarios(const char* scen_file, const char* map_dir)
+{
+	std::vector<movingai_scenario> scenarios;
+	if (!movingai_load_scenarios(scen_file, &scenarios))
+		return 1;
+
+	char scen_dir[1024];
+	if (!map_dir)
+	{
+		snprintf(scen_dir, sizeof(scen_dir), "%s", scen_file);
+		char* slash = strrchr(scen_dir, '/');
+		if (slash)
+			*slash = 0;
+		else
+			strcpy(scen_dir, ".");
+		map_dir = scen_dir;
+	}
+
+	movingai_map map;
+	char map_name[movingai_max_name] = "";
+	path_finder pf = {};
+	path_goal_set goals = {};
+	std::vector<uint32_t> distances;
+	std::vector<tile_pos> path;
+	std::vector<bench_scen_bucket> buckets;
+	uint32_t failed = 0, mismatched = 0, below_reference = 0;
+
+	for (const movingai_scenario& scenario : scenarios)
+	{
+		// Scenario files are grouped by map, so a map is usually only loaded once
+		if (strcmp(scenario.map, map_name) != 0)
+		{
+			if (map_name[0])
+			{
+				path_finder_term(&pf);
+				path_goal_set_term(&goals);
+			}
+
+			if (!bench_scen_load_map(map_dir, scenario.map, &map))
+				return 1;
+
+			if (map.grid.width != scenario.map_width || map.grid.height != scenario.map_height)
+			{
+				fprintf(stderr, "%s: map is %dx%d but the scenarios expect %dx%d\n", scenario.map, map.grid.width, map.grid.height, scenario.map_width, scenario.map_height);
+				return 1;
+			}
+
+			snprintf(map_name, sizeof(map_name), "%s", scenario.map);
+			path_finder_init(&pf, &map.grid);
+			path_goal_set_init(&goals, &map.grid);
+		}
+
+		if (tile_grid_get(&map.grid, scenario.start.x, scenario.start.y) == tile_flags_wall ||
+			tile_grid_get(&map.grid, scenario.goal.x, scenario.goal.y) == tile_flags_wall)
+		{
+			fprintf(stderr, "%s: scenario on line %u goes from (%d, %d) to (%d, %d), off the %dx%d map or on a wall\n", scen_file,
+				(uint32_t)(&scenario - scenarios.data()) + 2, scenario.start.x, scenario.start.y, scenario.goal.x, scenario.goal.y, map.grid.width, map.grid.height);
+			path_finder_term(&pf);
+			path_goal_set_term(&goals);
+			return 1;
+		}
+
+		if (scenario.bucket >= buckets.size())
+			buckets.resize(scenario.bucket + 1);
+		bench_scen_bucket* bucket = &buckets[scenario.bucket];
+
+		const path_query query = {scenario.start, scenario.goal, path_mode_astar};
+		path_stats stats;
+		const double begin = bench_time_us();
+		const bool found = path_find(&pf, &query, &path, &stats);
+		bucket->latencies.push_back(bench_time_us() - begin);
+
+		path_goal_set_clear(&goals);
+		path_goal_set_add(&goals, scenario.goal);
+		path_goal_distances(&goals, &distances);
+		const uint32_t exact = distances[(size_t)scenario.start.y * map.grid.width + scenario.start.x];
+
+		if (!found)
+		{
+			failed++;
+			mismatched += exact != path_goal_unreachable;
+			continue;
+		}
+
+		bucket->found++;
+		mismatched += stats.cost != exact;
+		below_reference += stats.cost + 1e-3 < scenario.optimal;
+		bucket->expanded += stats.nodes_expanded;
+		bucket->max_expanded = std::max(bucket->max_expanded, stats.nodes_expanded);
+		bucket->cost += stats.cost;
+		bucket->reference += scenario.optimal;
+	}
+
+	if (map_name[0])
+	{
+		path_finder_term(&pf);
+		path_goal_set_term(&goals);
+	}
+
+	printf("{\n\t\"scenario_file\": ");
+	bench_json_string(scen_file);
+	printf(",\n\t\"search\": \"astar\",\n\t\"connectivity\": 4,\n");
+	printf("\t\"scenarios\": %u,\n\t\"failed\": %u,\n\t\"mismatched\": %u,\n\t\"below_reference\": %u,\n\t\"buckets\": [", (uint32_t)scenarios.size(), failed, mismatched, below_reference);
+
+	bool first = true;
+	for (uint32_t i = 0; i < buckets.size(); i++)
+	{
+		bench_scen_bucket* bucket = &buckets[i];
+		const uint32_t count = (uint32_t)bucket->latencies.size();
+		if (count == 0)
+			continue;
+
+		double total_us = 0.0;
+		for (double latency : bucket->latencies)
+			total_us += latency;
+
+		// Failed scenarios add nothing to the sums, so they are left out of the means
+		const double found = std::max(bucket->found, 1u);
+		printf("%s\n\t\t{\"bucket\": %u, \"count\": %u, \"found\": %u, \"mean_us\": %.3f, \"p99_us\": %.3f, \"mean_expanded\": %.1f, \"max_expanded\": %u, \"mean_cost\": %.2f, \"mean_reference\": %.2f}",
+			first ? "" : ",", i, count, bucket->found, total_us / count, bench_percentile(&bucket->latencies, 0.99), (double)bucket->expanded / found, bucket->max_expanded,
+			bucket->cost / found, bucket->reference / found);
+		first = false;
+	}
+	printf("\n\t]\n}\n");
+
+	return mismatched || below_reference ? 1 : 0;
+}
+
+/*
+	CPU cost of filling the sprite buffer for a scene of count sprites, the way sprite_batch_draw
+	does from pixel rects against sprite_batch_draw_region with atlas ids. Both write into a plain
+	64KB array standing in for the mapped D3D buffer, starting over when it fills as the batch
+	does when it flushes.
+*/
+struct bench_sprite_pixels
+{
+	int32_t x, y, src_x, src_y, src_w, src_h;
+};
+
+struct bench_sprite_region
+{
+	int32_t		x, y;
+	sprite_id	sprite;
+};
+
+static void bench_sprites(uint32_t count)
+{
+	const uint32_t frames = 100;
+	const int32_t display_width = 896, display_height = 992, scale = 4;
+
+	sprite_atlas atlas;
+	sprite_atlas_init(&atlas, nullptr, 1024, 512);
+	const sprite_sequence animations[] = {
+		sprite_atlas_add_sequence(&atlas, "pathman", 457, 1, 14, 14, 3, 16),
+		sprite_atlas_add_sequence(&atlas, "ghost", 585, 65, 14, 14, 2, 16)
+	};
+
+	// Same scene both ways, each sprite showing a random frame of one of the animations
+	std::vector<bench_sprite_pixels> pixel_scene(count);
+	std::vector<bench_sprite_region> region_scene(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const sprite_sequence animation = animations[bench_random(2)];
+		const sprite_id id = sprite_sequence_frame(animation, bench_random(animation.frame_count));
+		const int32_t x = (int32_t)bench_random(display_width), y = (int32_t)bench_random(display_height);
+
+		// Pixel rects as the caller had to keep them before the atlas, recovered from the UVs
+		const sprite_region* region = sprite_atlas_region(&atlas, id);
+		const int32_t src_x = (int32_t)(region->u0 * atlas.width + 0.5f), src_y = (int32_t)(region->v0 * atlas.height + 0.5f);
+		pixel_scene[i] = {x, y, src_x, src_y, region->width, region->height};
+		region_scene[i] = {x, y, id};
+	}
+
+	const uint32_t buffer_count = (64 * 1024) / sizeof(sprite);
+	std::vector<sprite> buffer(buffer_count);
+	double begin = bench_time_us();
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		uint32_t mapped = 0;
+		for (const bench_sprite_pixels& s : pixel_scene)
+		{
+			mapped = mapped == buffer_count ? 0 : mapped;
+			sprite_set_pixels(&buffer[mapped++], display_width, display_height, atlas.width, atlas.height, s.x, s.y, s.src_w * scale, s.src_h * scale, s.src_x, s.src_y, s.src_w, s.src_h);
+		}
+	}
+	const double pixels_us = (bench_time_us() - begin) / frames;
+
+	begin = bench_time_us();
+	for (uint32_t frame = 0; frame < frames; frame++)
+	{
+		const sprite_screen screen = sprite_screen_make(display_width, display_height);
+		uint32_t mapped = 0;
+		for (const bench_sprite_region& s : region_scene)
+		{
+			mapped = mapped == buffer_count ? 0 : mapped;
+			sprite_set_region(&buffer[mapped++], screen, sprite_atlas_region(&atlas, s.sprite), s.x, s.y, scale);
+		}
+	}
+	const double regions_us = (bench_time_us() - begin) / frames;
+
+	// Reciprocals round differently to divisions, so compare to within a thousandth of a pixel
+	const float tolerance = 0.001f * 2.0f / 1024.0f;
+	const sprite_screen screen = sprite_screen_make(display_width, display_height);
+	uint32_t mismatches = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const bench_sprite_pixels& p = pixel_scene[i];
+		sprite a, b;
+		sprite_set_pixels(&a, display_width, display_height, atlas.width, atlas.height, p.x, p.y, p.src_w * scale, p.src_h * scale, p.src_x, p.src_y, p.src_w, p.src_h);
+		sprite_set_region(&b, screen, sprite_atlas_region(&atlas, region_scene[i].sprite), region_scene[i].x, region_scene[i].y, scale);
+		for (uint32_t j = 0; j < 8; j++)
+			mismatches += fabsf((&a.x0)[j] - (&b.x0)[j]) > tolerance;
+	}
+
+	printf("%u sprites, %u regions in %u sequences, %u byte atlas\n", count, atlas.region_count, atlas.sequence_count, (uint32_t)sizeof(sprite_atlas));
+	printf("pixel rects:   %8.1f us per frame, %.2f ns per sprite, %u bytes of input per sprite\n",
+		pixels_us, pixels_us * 1000.0 / count, (uint32_t)sizeof(bench_sprite_pixels));
+	printf("atlas regions: %8.1f us per frame, %.2f ns per sprite, %u bytes of input per sprite\n",
+		regions_us, regions_us * 1000.0 / count, (uint32_t)sizeof(bench_sprite_region));
+	printf("speedup %.2fx, %u mismatched sprite values\n", pixels_us / regions_us, mismatches);
+}
+
+/*
+	Frame scratch arena against the heap, first on a synthetic frame of the temporaries the
+	pathfinding code makes (path vectors grown a tile at a time, reserved search queues and small
+	lists), then on path_goal_distances and path_prune_update run with and without a thread arena.
+*/
+struct bench_arena_frame
+{
+	std::vector<uint32_t> path_lengths;
+	std::vector<uint32_t> queue_sizes;
+	std::vector<uint32_t> list_bytes;
+};
+
+template<typename Vector>
+static uint64_t bench_arena_frame_run(const bench_arena_frame& frame, const Vector& empty)
+{
+	uint64_t checksum = 0;
+
+	for (uint32_t length : frame.path_lengths)
+	{
+		Vector path(empty);
+		for (uint32_t i = 0; i < length; i++)
+			path.push_back(i);
+		checksum += path[length / 2];
+	}
+
+	for (uint32_t size : frame.queue_sizes)
+	{
+		Vector queue(empty);
+		queue.reserve(size);
+		for (uint32_t i = 0; i < size; i++)
+			queue.push_back(i * 3);
+		checksum += queue.back();
+	}
+
+	return checksum;
+}
+
+static void bench_arena_synthetic(uint32_t frames)
+{
+	std::vector<bench_arena_frame> scripts(16);
+	for (bench_arena_frame& frame : scripts)
+	{
+		for (uint32_t i = 0; i < 64; i++)
+			frame.path_lengths.push_back(20 + bench_random(280));
+		for (uint32_t i = 0; i < 8; i++)
+			frame.queue_sizes.push_back(64 + bench_random(4096));
+		for (uint32_t i = 0; i < 256; i++)
+			frame.list_bytes.push_back(16 + bench_random(240));
+	}
+
+	frame_arena arena;
+	frame_arena_init(&arena, "bench", 256 * 1024);
+
+	uint64_t checksum[2] = {};
+	uint64_t allocs[2];
+	double elapsed_us[2];
+
+	for (uint32_t use_arena = 0; use_arena < 2; use_arena++)
+	{
+		const uint64_t allocs_before = bench_packed_allocs();
+		const double begin = bench_time_us();
+		for (uint32_t f = 0; f < frames; f++)
+		{
+			const bench_arena_frame& frame = scripts[f % scripts.size()];
+			if (use_arena)
+			{
+				checksum[1] += bench_arena_frame_run(frame, frame_vector<uint32_t>(frame_allocator<uint32_t>(&arena)));
+				for (uint32_t bytes : frame.list_bytes)
+					checksum[1] += ((uint8_t*)frame_arena_alloc(&arena, bytes))[0] = (uint8_t)bytes;
+				frame_arena_reset(&arena);
+			}
+			else
+			{
+				checksum[0] += bench_arena_frame_run(frame, std::vector<uint32_t>());
+				void* lists[256];
+				for (size_t i = 0; i < frame.list_bytes.size(); i++)
+					checksum[0] += ((uint8_t*)(lists[i] = malloc(frame.list_bytes[i])))[0] = (uint8_t)frame.list_bytes[i];
+				for (size_t i = 0; i < frame.list_bytes.size(); i++)
+					free(lists[i]);
+			}
+		}
+		elapsed_us[use_arena] = (bench_time_us() - begin) / frames;
+		allocs[use_arena] = (bench_packed_allocs() - allocs_before) / frames;
+	}
+
+	printf("synthetic frame (64 grown paths, 8 reserved queues, 256 small lists):\n");
+	printf("  heap   %8.1f us per frame, %llu heap allocations per frame\n", elapsed_us[0], (unsigned long long)allocs[0]);
+	printf("  arena  %8.1f us per frame, %llu heap allocations per frame, %.2fx faster\n", elapsed_us[1], (unsigned long long)allocs[1], elapsed_us[0] / elapsed_us[1]);
+	if (checksum[0] != checksum[1])
+		printf("  results disagree: checksums %llu and %llu\n", (unsigned long long)checksum[0], (unsigned long long)checksum[1]);
+	frame_arena_report(&arena);
+
+	frame_arena_term(&arena);
+}
+
+static void bench_arena_pathfinding()
+{
+	const uint32_t runs = 200;
+
+	bench_map map;
+	bench_make_maze(&map, "braided", 256, 256, maze_kind_braided, 3);
+
+	path_goal_set goals;
+	path_goal_set_init(&goals, &map.grid);
+	const std::vector<tile_pos> open_tiles = bench_open_tiles(&map.grid);
+	for (uint32_t i = 0; i < 16; i++)
+		path_goal_set_add(&goals, open_tiles[bench_random((uint32_t)open_tiles.size())]);
+	path_goal_set_update(&goals);
+
+	path_prune prune = {};
+	path_prune_build(&prune, &map.grid);
+
+	std::vector<uint8_t> walkable(map.tiles.size());
+	for (size_t i = 0; i < map.tiles.size(); i++)
+		walkable[i] = map.tiles[i] != tile_flags_wall;
+
+	std::vector<uint32_t> distances;
+	uint64_t checksum[2] = {};
+	double distances_us[2] = {}, update_us[2] = {};
+
+	for (uint32_t use_arena = 0; use_arena < 2; use_arena++)
+	{
+		if (use_arena)
+			frame_arena_thread_init("pathbench", 1024 * 1024);
+
+		double begin = bench_time_us();
+		for (uint32_t run = 0; run < runs; run++)
+		{
+			path_goal_distances(&goals, &distances);
+			checksum[use_arena] += distances[distances.size() / 2];
+		}
+		distances_us[use_arena] = (bench_time_us() - begin) / runs;
+
+		// Each toggle is undone straight after, so both passes see the same sequence of maps
+		bench_random_state = 0x9E3779B97F4A7C15ull;
+		for (uint32_t run = 0; run < runs; run++)
+		{
+			const int32_t x = 1 + (int32_t)bench_random(map.grid.width - 2);
+			const int32_t y = 1 + (int32_t)bench_random(map.grid.height - 2);
+			const size_t toggled = (size_t)y * map.grid.width + x;
+			for (uint32_t toggle = 0; toggle < 2; toggle++)
+			{
+				for (size_t i = 0; i < map.tiles.size(); i++)
+					map.tiles[i] = walkable[i] ^ (uint8_t)(toggle == 0 && i == toggled);
+				tile_flags_from_walkable(map.tiles.data(), map.grid.width, map.grid.height);
+
+				begin = bench_time_us();
+				path_prune_update(&prune, x, y, x, y);
+				update_us[use_arena] += bench_time_us() - begin;
+			}
+			checksum[use_arena] += path_prune_count(&prune);
+		}
+
+		if (use_arena)
+		{
+			frame_arena_report(frame_scratch());
+			frame_arena_thread_term();
+		}
+	}
+
+	printf("path_goal_distances on 256x256:  heap %.1f us, arena %.1f us\n", distances_us[0], distances_us[1]);
+	printf("path_prune_update per toggle:    heap %.2f us, arena %.2f us\n", update_us[0] / (runs * 2), update_us[1] / (runs * 2));
+	if (checksum[0] != checksum[1])
+		printf("results disagree: checksums %llu and %llu\n", (unsigned long long)checksum[0], (unsigned long long)checksum[1]);
+
+	path_prune_term(&prune);
+	path_goal_set_term(&goals);
+}
+
+// Rollback poisons released memory in debug builds and frees overflow blocks past the mark
+static void bench_arena_checks()
+{
+	frame_arena arena;
+	frame_arena_init(&arena, "checks", 4096);
+
+	uint8_t* kept = (uint8_t*)frame_arena_alloc(&arena, 100);
+	memset(kept, 1, 100);
+	const frame_arena_mark mark = frame_arena_get_mark(&arena);
+	uint8_t* released = (uint8_t*)frame_arena_alloc(&arena, 1000, 64);
+	memset(released, 2, 1000);
+	uint8_t* overflowed = (uint8_t*)frame_arena_alloc(&arena, 8192, 64);
+	memset(overflowed, 3, 8192);
+	const bool aligned = ((uintptr_t)released % 64) == 0 && ((uintptr_t)overflowed % 64) == 0;
+	const uint64_t overflows = arena.overflow_count;
+	frame_arena_rollback(&arena, mark);
+
+	bool poisoned = true;
+	for (uint32_t i = 0; i < 1000; i++)
+		poisoned &= released[i] == frame_arena_poison;
+	bool intact = true;
+	for (uint32_t i = 0; i < 100; i++)
+		intact &= kept[i] == 1;
+
+#ifdef NDEBUG
+	const char* poison_result = "not checked in release";
+#else
+	const char* poison_result = poisoned ? "yes" : "NO";
+#endif
+	printf("checks: aligned %s, overflows %llu, overflow freed %s, kept memory intact %s, released memory poisoned %s\n",
+		aligned ? "yes" : "NO", (unsigned long long)overflows, arena.overflows == nullptr && arena.overflow_bytes == 0 ? "yes" : "NO",
+		intact ? "yes" : "NO", poison_result);
+
+	frame_arena_term(&arena);
+}
+
+static void bench_arena()
+{
+	bench_arena_checks();
+	bench_arena_synthetic(2000);
+	bench_arena_pathfinding();
+}
+
+/*
+	Quality against search effort of the suboptimal modes. Every query is first run with plain A*
+	for its shortest cost, then with weighted A* and focal search at a range of weights, checking
+	no path breaks its bound. Anytime searches are stepped a slice at a time to record how good
+	their path is after a given share of the expansions plain A* needed.
+*/
+static const uint16_t bench_suboptimal_weights[] = {110, 125, 150, 200, 300};
+static const double bench_anytime_budgets[] = {0.1, 0.25, 0.5, 1.0, 2.0};
+
+struct bench_anytime_event
+{
+	uint32_t expanded;
+	uint32_t cost;
+};
+
+static void bench_suboptimal_map(const char* name, const tile_grid* grid, const std::vector<path_query>& queries)
+{
+	const uint32_t count = (uint32_t)queries.size();
+
+	path_finder pf;
+	path_finder_init(&pf, grid);
+
+	std::vector<tile_pos> path;
+	std::vector<uint32_t> shortest(count);
+	std::vector<uint32_t> astar_expanded(count);
+	uint64_t astar_total = 0;
+
+	double begin = bench_time_us();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		path_stats stats;
+		path_find(&pf, &queries[i], &path, &stats);
+		shortest[i] = stats.cost;
+		astar_expanded[i] = stats.nodes_expanded;
+		astar_total += stats.nodes_expanded;
+	}
+	const double astar_us = (bench_time_us() - begin) / count;
+
+	printf("%s, %u queries, A* %.1f expanded and %.1f us per query\n", name, count, (double)astar_total / count, astar_us);
+	printf("  mode      weight  expanded  time     mean length  worst length  over bound\n");
+
+	for (path_mode mode : {path_mode_weighted, path_mode_focal})
+	{
+		for (uint16_t weight : bench_suboptimal_weights)
+		{
+			uint64_t expanded = 0;
+			double ratio_sum = 0.0, worst = 1.0;
+			uint32_t over = 0;
+
+			begin = bench_time_us();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				path_query query = queries[i];
+				query.mode = mode;
+				query.weight = weight;
+
+				path_stats stats;
+				path_find(&pf, &query, &path, &stats);
+				expanded += stats.nodes_expanded;
+
+				const double ratio = shortest[i] ? (double)stats.cost / shortest[i] : 1.0;
+				ratio_sum += ratio;
+				worst = std::max(worst, ratio);
+				over += (uint64_t)stats.cost * 100 > (uint64_t)shortest[i] * weight || path.size() != stats.cost + 1;
+			}
+			const double elapsed_us = (bench_time_us() - begin) / count;
+
+			printf("  %-8s  %.2f   %6.1f%%  %6.1f us  %.4fx      %.3fx        %u\n",
+				mode == path_mode_weighted ? "weighted" : "focal", weight / 100.0, 100.0 * expanded / astar_total, elapsed_us, ratio_sum / count, worst, over);
+		}
+	}
+
+	// Anytime: every improvement is recorded with the expansions it took, then read off at each budget
+	for (uint16_t weight : {(uint16_t)150, (uint16_t)300})
+	{
+		const uint32_t budget_count = sizeof(bench_anytime_budgets) / sizeof(bench_anytime_budgets[0]);
+		double ratio_sum[budget_count] = {}, first_ratio_sum = 0.0, first_share_sum = 0.0, proven_share_sum = 0.0;
+		uint32_t with_path[budget_count] = {}, over = 0;
+		std::vector<bench_anytime_event> events;
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			path_query query = queries[i];
+			query.mode = path_mode_anytime;
+			query.weight = weight;
+
+			path_stats stats;
+			events.clear();
+			path_status status = path_find_begin(&pf, &query, &path, &stats);
+			while (status == path_status_searching || status == path_status_improving)
+			{
+				const uint32_t before = stats.cost;
+				status = path_find_step(&pf, 64, &path, &stats);
+				if ((status == path_status_improving || status == path_status_found) && (events.empty() || stats.cost != before))
+					events.push_back({stats.nodes_expanded, stats.cost});
+			}
+
+			over += events.empty() || events.back().cost != shortest[i] || path.size() != shortest[i] + 1;
+			if (events.empty())
+				continue;
+
+			const double reference = std::max(astar_expanded[i], 1u);
+			// A query from a tile to itself has nothing to shorten and counts as exact
+			const double shortest_cost = shortest[i] ? shortest[i] : 1.0;
+			first_ratio_sum += shortest[i] ? events.front().cost / shortest_cost : 1.0;
+			first_share_sum += events.front().expanded / reference;
+			proven_share_sum += stats.nodes_expanded / reference;
+
+			for (uint32_t b = 0; b < budget_count; b++)
+			{
+				const uint32_t budget = (uint32_t)(bench_anytime_budgets[b] * reference);
+				uint32_t cost = UINT32_MAX;
+				for (const bench_anytime_event& event : events)
+				{
+					if (event.expanded <= budget)
+						cost = event.cost;
+				}
+				if (cost != UINT32_MAX)
+				{
+					ratio_sum[b] += shortest[i] ? cost / shortest_cost : 1.0;
+					with_path[b]++;
+				}
+			}
+		}
+
+		printf("  anytime   %.2f   first path after %.1f%% of A* expansions at %.4fx, shortest proven after %.1f%%, %u wrong final paths\n",
+			weight / 100.0, 100.0 * first_share_sum / count, first_ratio_sum / count, 100.0 * proven_share_sum / count, over);
+		printf("            budget:");
+		for (uint32_t b = 0; b < budget_count; b++)
+			printf("  %4.0f%% %5.1f%% with path %.4fx", 100.0 * bench_anytime_budgets[b], 100.0 * with_path[b] / count, with_path[b] ? ratio_sum[b] / with_path[b] : 0.0);
+		printf("\n");
+	}
+
+	path_finder_term(&pf);
+}
+
+static void bench_suboptimal()
+{
+	bench_map maps[bench_standard_map_count];
+	bench_make_standard_maps(maps);
+	bench_suboptimal_map(maps[0].name, &maps[0].grid, bench_standard_queries(&maps[0]));
+	for (uint32_t i = 1; i < bench_standard_map_count; i++)
+		bench_suboptimal_map(maps[i].name, &maps[i].grid, bench_random_queries(&maps[i].grid, 200));
+
+	bench_map rooms, braided;
+	bench_make_maze(&rooms, "rooms 1024x1024", 1024, 1024, maze_kind_rooms, 5);
+	bench_make_maze(&braided, "braided maze 1023x1023", 1023, 1023, maze_kind_braided, 5);
+	bench_suboptimal_map(rooms.name, &rooms.grid, bench_random_queries(&rooms.grid, 200));
+	bench_suboptimal_map(braided.name, &braided.grid, bench_random_queries(&braided.grid, 200));
+}
+
+/*
+	Hardware cache miss counter for the calling thread where the OS exposes one. Virtual machines
+	and locked down kernels often do not, and the counts then read as unavailable.
+*/
+struct bench_cache_counter
+{
+	int fd;
+};
+
+static void bench_cache_counter_open(bench_cache_counter* counter)
+{
+#ifdef __linux__
+	perf_event_attr attr = {};
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	counter->fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	counter->fd = -1;
+#endif
+}
+
+static void bench_cache_counter_close(bench_cache_counter* counter)
+{
+#ifdef __linux__
+	if (counter->fd >= 0)
+		close(counter->fd);
+#endif
+	counter->fd = -1;
+}
+
+static void bench_cache_counter_start(bench_cache_counter* counter)
+{
+#ifdef __linux__
+	if (counter->fd >= 0)
+	{
+		ioctl(counter->fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(counter->fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+#endif
+}
+
+// Misses since bench_cache_counter_start, UINT64_MAX when there is no counter
+static uint64_t bench_cache_counter_stop(bench_cache_counter* counter)
+{
+	uint64_t misses = UINT64_MAX;
+#ifdef __linux__
+	if (counter->fd >= 0)
+	{
+		ioctl(counter->fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(counter->fd, &misses, sizeof(misses)) != sizeof(misses))
+			misses = UINT64_MAX;
+	}
+#endif
+	return misses;
+}
+
+struct bench_layout_result
+{
+	double		line_share;		// Steps between open tiles whose nodes are on different cache lines
+	double		page_share;		// and on different 4KB pages
+	double		time_us;
+	uint64_t	expanded;
+	uint64_t	cost;
+	uint64_t	misses;
+};
+
+// Random open tile pairs, found by retrying rather than listing every open tile of a huge map
+static std::vector<path_query> bench_layout_queries(const tile_grid* grid, uint32_t count)
+{
+	std::vector<path_query> queries;
+	while (queries.size() < count)
+	{
+		tile_pos ends[2];
+		for (tile_pos& end : ends)
+		{
+			do
+				end = {(int32_t)bench_random((uint32_t)grid->width), (int32_t)bench_random((uint32_t)grid->height)};
+			while (tile_grid_get(grid, end.x, end.y) == tile_flags_wall);
+		}
+		queries.push_back({ends[0], ends[1], path_mode_astar});
+	}
+
+	return queries;
+}
+
+template<typename Grid>
+static void bench_layout_measure(const Grid& grid, path_finder* pf, const std::vector<path_query>& queries, bench_cache_counter* counter, bench_layout_result* result)
+{
+	const tile_grid* map = pf->grid;
+
+	uint64_t steps = 0, lines = 0, pages = 0;
+	for (int32_t y = 0; y < map->height; y++)
+	{
+		for (int32_t x = 0; x < map->width; x++)
+		{
+			const uint32_t index = grid.index({x, y});
+			const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[index]);
+			for (uint32_t i = 0; i < neighbours.count; i++)
+			{
+				const uint64_t from = (uint64_t)index * sizeof(path_node);
+				const uint64_t to = (uint64_t)grid.neighbour(index, neighbours.directions[i]) * sizeof(path_node);
+				steps++;
+				lines += (from >> 6) != (to >> 6);
+				pages += (from >> 12) != (to >> 12);
+			}
+		}
+	}
+	result->line_share = (double)lines / std::max<uint64_t>(steps, 1);
+	result->page_share = (double)pages / std::max<uint64_t>(steps, 1);
+
+	// Fault the node array in first so no layout pays for first touches
+	memset(pf->nodes[0], 0, (size_t)pf->node_count * sizeof(path_node));
+
+	std::vector<tile_pos> path;
+	result->expanded = 0;
+	result->cost = 0;
+
+	bench_cache_counter_start(counter);
+	const double begin = bench_time_us();
+	for (const path_query& query : queries)
+	{
+		path_stats stats;
+		path_search(pf, grid, &query, heuristic_manhattan{query.goal}, &path, &stats);
+		result->expanded += stats.nodes_expanded;
+		result->cost += stats.cost;
+	}
+	result->time_us = bench_time_us() - begin;
+	result->misses = bench_cache_counter_stop(counter);
+}
+
+/*
+	Runs the same random A* queries over each grid_layout of large generated maps, with the node
+	array in the same layout, and reports how often a step between neighbours lands on another
+	cache line or page of the node array, query times and hardware cache misses where available.
+*/
+static void bench_layouts(int32_t only_size)
+{
+	std::vector<int32_t> sizes = {4096, 16384};
+	if (only_size)
+		sizes = {only_size};
+
+	const maze_kind kinds[] = {maze_kind_rooms, maze_kind_braided};
+
+	bench_cache_counter counter;
+	bench_cache_counter_open(&counter);
+	if (counter.fd < 0)
+		printf("hardware cache miss counters unavailable, reporting line and page crossings only\n");
+
+	printf("%-6s %-8s %-12s %8s %7s %7s %12s %8s %10s %8s\n", "size", "map", "layout", "MB", "line%", "page%", "ms/query", "ns/exp", "miss/exp", "speedup");
+
+	for (int32_t size : sizes)
+	{
+		for (maze_kind kind : kinds)
+		{
+			bench_map map;
+			bench_make_maze(&map, maze_kind_names[kind], size, size, kind, (uint64_t)size + kind);
+
+			const std::vector<path_query> queries = bench_layout_queries(&map.grid, size <= 4096 ? 100 : 8);
+
+			path_finder pf;
+			path_finder_init(&pf, &map.grid);
+
+			double row_major_us = 0.0;
+			uint64_t row_major_cost = 0;
+			for (uint32_t kind_index = 0; kind_index < grid_layout_count; kind_index++)
+			{
+				grid_layout layout;
+				grid_layout_build(&layout, &map.grid, (grid_layout_kind)kind_index);
+				path_finder_set_layout(&pf, &layout);
+
+				bench_layout_result result;
+				switch (layout.kind)
+				{
+				case grid_layout_row_major: bench_layout_measure(grid_dynamic(&map.grid), &pf, queries, &counter, &result); break;
+				case grid_layout_blocked:	bench_layout_measure(grid_blocked(&layout), &pf, queries, &counter, &result); break;
+				default:					bench_layout_measure(grid_morton(&layout), &pf, queries, &counter, &result); break;
+				}
+
+				if (layout.kind == grid_layout_row_major)
+				{
+					row_major_us = result.time_us;
+					row_major_cost = result.cost;
+				}
+
+				char misses[16] = "n/a";
+				if (result.misses != UINT64_MAX)
+					snprintf(misses, sizeof(misses), "%.2f", (double)result.misses / std::max<uint64_t>(result.expanded, 1));
+
+				const double megabytes = (double)layout.tile_count * (1 + sizeof(path_node)) / (1024 * 1024);
+				printf("%-6d %-8s %-12s %8.0f %6.1f%% %6.1f%% %12.2f %8.1f %10s %7.2fx%s\n",
+					size, maze_kind_names[kind], grid_layout_names[layout.kind], megabytes, 100.0 * result.line_share, 100.0 * result.page_share,
+					result.time_us / queries.size() / 1000.0, 1000.0 * result.time_us / std::max<uint64_t>(result.expanded, 1), misses,
+					row_major_us / result.time_us, result.cost == row_major_cost ? "" : " path cost mismatch");
+
+				grid_layout_term(&layout);
+			}
+
+			path_finder_term(&pf);
+		}
+	}
+
+	bench_cache_counter_close(&counter);
+}
+
+/*
+	Endless world of 16x16 rooms for the sparse search, walled along each room's top row and left
+	column with a two tile doorway at a hashed spot in each wall, so every room joins its four
+	neighbours. Works at any coordinates including negative ones.
+*/
+struct bench_world_rooms
+{
+	static uint32_t door(int32_t room_x, int32_t room_y, uint32_t wall)
+	{
+		uint64_t hash = ((uint64_t)(uint32_t)room_x * 0x9E3779B97F4A7C15ull) ^ ((uint64_t)(uint32_t)room_y * 0xC2B2AE3D27D4EB4Full) ^ wall;
+		hash ^= hash >> 29;
+		hash *= 0xBF58476D1CE4E5B9ull;
+		hash ^= hash >> 32;
+
+		return 1 + (uint32_t)(hash % 13);
+	}
+
+	static bool walkable(tile_pos pos)
+	{
+		const uint32_t x = (uint32_t)pos.x & 15;
+		const uint32_t y = (uint32_t)pos.y & 15;
+		if (x && y)
+			return true;
+		if (!x && !y)
+			return false;
+
+		// Arithmetic shifts keep rooms 16 wide either side of zero
+		const uint32_t along = x ? x : y;
+		const uint32_t first = door(pos.x >> 4, pos.y >> 4, x ? 0 : 1);
+		return along == first || along == first + 1;
+	}
+
+	uint8_t tile(tile_pos pos) const
+	{
+		if (!walkable(pos))
+			return tile_flags_wall;
+
+		uint8_t flags = 0;
+		for (uint32_t direction = 0; direction < 4; direction++)
+		{
+			if (walkable({pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]}))
+				flags |= 1 << direction;
+		}
+
+		return flags;
+	}
+};
+
+// Open starts within range of origin, each with an open goal exactly distance tiles away
+template<typename World>
+static std::vector<path_query> bench_sparse_queries(const World& world, tile_pos origin, int32_t range, int32_t distance, uint32_t count)
+{
+	std::vector<path_query> queries;
+	while (queries.size() < count)
+	{
+		const tile_pos start = {origin.x + (int32_t)bench_random((uint32_t)range), origin.y + (int32_t)bench_random((uint32_t)range)};
+		const int32_t dx = (int32_t)bench_random((uint32_t)distance + 1);
+		const tile_pos goal = {start.x + (bench_random(2) ? dx : -dx), start.y + (bench_random(2) ? distance - dx : dx - distance)};
+		if (world.tile(start) != tile_flags_wall && world.tile(goal) != tile_flags_wall)
+			queries.push_back({start, goal, path_mode_astar});
+	}
+
+	return queries;
+}
+
+struct bench_sparse_result
+{
+	double		time_us;
+	uint64_t	expanded;
+	uint64_t	cost;
+	size_t		bytes;
+};
+
+template<typename World>
+static bench_sparse_result bench_sparse_run(const World& world, const std::vector<path_query>& queries)
+{
+	path_sparse ps;
+	path_sparse_init(&ps, 1u << 26);
+
+	std::vector<tile_pos> path;
+	bench_sparse_result result = {};
+
+	const double begin = bench_time_us();
+	for (const path_query& query : queries)
+	{
+		path_stats stats;
+		path_sparse_search(&ps, world, &query, &path, &stats);
+		result.expanded += stats.nodes_expanded;
+		result.cost += stats.cost;
+	}
+	result.time_us = (bench_time_us() - begin) / queries.size();
+	result.bytes = path_sparse_bytes(&ps);
+
+	path_sparse_term(&ps);
+	return result;
+}
+
+/*
+	Runs A* with dense and sparse search state over the same 4096x4096 rooms map at a range of
+	query lengths, then the sparse search alone on an endless world near the origin and two billion
+	tiles out. The dense finder keeps a node for every tile of the map, the sparse one grows to the
+	largest search it has seen. Both reset in constant time between queries.
+*/
+static void bench_sparse()
+{
+	const int32_t distances[] = {16, 64, 256, 1024, 4096};
+
+	bench_map map;
+	bench_make_maze(&map, "rooms 4096x4096", 4096, 4096, maze_kind_rooms, 7);
+
+	path_finder pf;
+	path_finder_init(&pf, &map.grid);
+
+	printf("%s, dense state %.0f MB\n", map.name, (double)pf.node_count * sizeof(path_node) / (1024 * 1024));
+	printf("%8s %8s %10s %10s %10s %8s %12s\n", "distance", "queries", "expanded", "dense us", "sparse us", "ratio", "sparse KB");
+
+	for (int32_t distance : distances)
+	{
+		const uint32_t count = distance <= 256 ? 2000 : (distance <= 1024 ? 200 : 40);
+		const std::vector<path_query> queries = bench_sparse_queries(world_grid{&map.grid}, {0, 0}, 4096, distance, count);
+
+		std::vector<tile_pos> path;
+		uint64_t dense_cost = 0, dense_expanded = 0;
+		const double begin = bench_time_us();
+		for (const path_query& query : queries)
+		{
+			path_stats stats;
+			path_search(&pf, grid_dynamic(&map.grid), &query, heuristic_manhattan{query.goal}, &path, &stats);
+			dense_cost += stats.cost;
+			dense_expanded += stats.nodes_expanded;
+		}
+		const double dense_us = (bench_time_us() - begin) / count;
+
+		const bench_sparse_result sparse = bench_sparse_run(world_grid{&map.grid}, queries);
+
+		printf("%8d %8u %10.1f %10.2f %10.2f %7.2fx %12.1f%s\n", distance, count, (double)dense_expanded / count, dense_us, sparse.time_us,
+			sparse.time_us / dense_us, sparse.bytes / 1024.0, sparse.cost == dense_cost && sparse.expanded == dense_expanded ? "" : " results differ");
+	}
+
+	path_finder_term(&pf);
+
+	printf("endless rooms\n");
+	printf("%8s %14s %10s %10s %12s\n", "distance", "origin", "expanded", "sparse us", "sparse KB");
+
+	const bench_world_rooms world;
+	for (int32_t distance : distances)
+	{
+		for (tile_pos origin : {tile_pos{-1000, -1000}, tile_pos{2000000000, -2000000000}})
+		{
+			const uint32_t count = distance <= 256 ? 2000 : (distance <= 1024 ? 200 : 40);
+			const std::vector<path_query> queries = bench_sparse_queries(world, origin, 2000, distance, count);
+			const bench_sparse_result sparse = bench_sparse_run(world, queries);
+
+			printf("%8d %14s %10.1f %10.2f %12.1f\n", distance, origin.x < 0 ? "near zero" : "2 billion out", (double)sparse.expanded / count, sparse.time_us, sparse.bytes / 1024.0);
+		}
+	}
+}
+
+/*
+	Builds goal bounds for the shipped maze and each generated layout, saves them and times loading
+	them back, then runs the same random A* queries with and without them. Costs must match.
+*/
+static void bench_bounds_map(const char* name, const tile_grid* grid, uint32_t threads)
+{
+	const char* filename = "pathbench.pgb";
+	const uint32_t query_count = 2000;
+
+	path_bounds built;
+	double begin = bench_time_us();
+	path_bounds_build(&built, grid, threads);
+	const double build_us = bench_time_us() - begin;
+
+	const bool saved = path_bounds_save(&built, filename);
+	path_bounds_term(&built);
+
+	path_bounds bounds;
+	begin = bench_time_us();
+	if (!saved || !path_bounds_load(&bounds, grid, filename))
+	{
+		printf("could not save and load %s\n", filename);
+		return;
+	}
+	const double load_us = bench_time_us() - begin;
+	remove(filename);
+
+	const std::vector<path_query> queries = bench_random_queries(grid, query_count);
+
+	path_finder pf;
+	path_finder_init(&pf, grid);
+
+	std::vector<tile_pos> path;
+	std::vector<uint32_t> costs(query_count);
+	uint64_t expanded[2] = {};
+	double search_us[2] = {};
+	uint32_t mismatches = 0;
+
+	for (uint32_t bounded = 0; bounded < 2; bounded++)
+	{
+		pf.bounds = bounded ? &bounds : nullptr;
+
+		begin = bench_time_us();
+		for (uint32_t i = 0; i < query_count; i++)
+		{
+			path_stats stats;
+			const uint32_t cost = path_find(&pf, &queries[i], &path, &stats) ? stats.cost : UINT32_MAX;
+			expanded[bounded] += stats.nodes_expanded;
+			if (!bounded)
+				costs[i] = cost;
+			else
+				mismatches += cost != costs[i];
+		}
+		search_us[bounded] = bench_time_us() - begin;
+	}
+
+	printf("%-10s %5dx%-5d build %8.0f ms, %7.2f MB, load %6.2f ms, expanded %7.0f -> %6.0f (%4.1f%%), search %7.2f -> %6.2f us, %.2fx\n",
+		name, grid->width, grid->height, build_us / 1000.0, path_bounds_size(&bounds) / (1024.0 * 1024.0), load_us / 1000.0,
+		(double)expanded[0] / query_count, (double)expanded[1] / query_count, 100.0 * expanded[1] / std::max<uint64_t>(expanded[0], 1),
+		search_us[0] / query_count, search_us[1] / query_count, search_us[0] / search_us[1]);
+	if (mismatches)
+		printf("%u bounded searches did not match the full grid\n", mismatches);
+
+	path_finder_term(&pf);
+	path_bounds_term(&bounds);
+}
+
+static void bench_bounds(int32_t size)
+{
+	const uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+	printf("building on %u threads\n", threads);
+
+	bench_bounds_map("shipped", &maze_grid, threads);
+	for (uint32_t kind = 0; kind < maze_kind_count; kind++)
+	{
+		bench_map map;
+		bench_make_maze(&map, maze_kind_names[kind], size, size, (maze_kind)kind, 9);
+		bench_bounds_map(map.name, &map.grid, threads);
+	}
+
+	bench_map open;
+	bench_make_open(&open, "open", size, size);
+	bench_bounds_map(open.name, &open.grid, threads);
+}
+
+// Stand-in for the sprite sheet's pixels, every texel different so a wrongly sampled one shows
+static std::vector<uint32_t> bench_compose_sheet(const sprite_atlas* atlas)
+{
+	std::vector<uint32_t> sheet((size_t)atlas->width * atlas->height);
+	for (size_t i = 0; i < sheet.size(); i++)
+		sheet[i] = 0xFF000000 | (uint32_t)((i * 0x9E3779B1u) >> 8);
+
+	return sheet;
+}
+
+struct bench_compose_stats
+{
+	uint32_t	frames;
+	uint64_t	rects;
+	uint64_t	dirty_pixels;		// Covered by dirty rects
+	uint64_t	touched_pixels;		// Written by composition, the rects plus the sprites drawn in them
+	uint64_t	full_pixels;		// Written by drawing every frame whole
+	uint32_t	whole_frames;		// Frames that fell back to a single full screen rect
+	uint32_t	idle_frames;		// Frames with nothing to draw
+	uint32_t	mismatched_frames;
+	uint32_t	clip_errors;		// Clipped GPU sprites whose corners or texture coordinates are off
+	double		compose_us;
+	double		full_us;
+};
+
+/*
+	Composes one frame of dynamic sprites over the layer's cached image, then draws the same frame
+	whole from the layer's sprites up as the reference and checks the two match pixel for pixel.
+*/
+static void bench_compose_frame(bench_compose_stats* stats, sprite_dirty* dirty, sprite_raster* frame, const sprite_raster* cached, sprite_raster* reference,
+	const sprite_layer* layer, const sprite_atlas* atlas, const uint32_t* sheet, const std::vector<sprite_instance>& sprites)
+{
+	const sprite_rect screen = {0, 0, frame->width, frame->height};
+
+	double begin = bench_time_us();
+	sprite_dirty_track(dirty, atlas, sprites.data(), (uint32_t)sprites.size());
+	stats->dirty_pixels += sprite_dirty_collect(dirty, atlas, sprites.data(), (uint32_t)sprites.size());
+	stats->touched_pixels += sprite_raster_compose(frame, cached, dirty, atlas, sheet, sprites.data());
+	stats->compose_us += bench_time_us() - begin;
+
+	// The GPU draws the same clipped sprites as quads, check them to within a thousandth of a pixel
+	const sprite_screen display = sprite_screen_make(frame->width, frame->height);
+	for (uint32_t i = 0; i < dirty->rects.size(); i++)
+	{
+		for (uint32_t j = dirty->rect_offsets[i]; j < dirty->rect_offsets[i + 1]; j++)
+		{
+			const sprite_instance& s = sprites[dirty->rect_sprites[j]];
+			const sprite_region* region = sprite_atlas_region(atlas, s.id);
+			const sprite_rect rect = sprite_rect_intersect(sprite_instance_rect(atlas, s), dirty->rects[i]);
+
+			sprite clipped;
+			sprite_set_clipped(&clipped, display, atlas, s, dirty->rects[i]);
+
+			const float expected[8] = {
+				(float)rect.x0, (float)rect.y0, (float)rect.x1, (float)rect.y1,
+				(region->u0 * atlas->width) + ((float)(rect.x0 - s.x) / s.scale), (region->v0 * atlas->height) + ((float)(rect.y0 - s.y) / s.scale),
+				(region->u0 * atlas->width) + ((float)(rect.x1 - s.x) / s.scale), (region->v0 * atlas->height) + ((float)(rect.y1 - s.y) / s.scale)
+			};
+			const float actual[8] = {
+				(clipped.x0 + 1.0f) / display.x_scale, (1.0f - clipped.y0) / display.y_scale,
+				(clipped.x1 + 1.0f) / display.x_scale, (1.0f - clipped.y1) / display.y_scale,
+				clipped.u0 * atlas->width, clipped.v0 * atlas->height, clipped.u1 * atlas->width, clipped.v1 * atlas->height
+			};
+
+			bool error = false;
+			for (uint32_t k = 0; k < 8; k++)
+				error |= fabsf(expected[k] - actual[k]) > (k < 4 ? 0.001f : 0.001f / s.scale);
+			stats->clip_errors += error;
+		}
+	}
+
+	begin = bench_time_us();
+	uint64_t full_pixels = sprite_raster_draw_layer(reference, layer, atlas, sheet);
+	for (const sprite_instance& s : sprites)
+		full_pixels += sprite_raster_draw(reference, atlas, sheet, s, screen);
+	stats->full_us += bench_time_us() - begin;
+
+	stats->frames++;
+	stats->rects += dirty->rects.size();
+	stats->full_pixels += full_pixels;
+	stats->whole_frames += dirty->rects.size() == 1 && sprite_rect_area(dirty->rects[0]) == sprite_rect_area(screen);
+	stats->idle_frames += dirty->rects.empty();
+	stats->mismatched_frames += memcmp(frame->pixels.data(), reference->pixels.data(), frame->pixels.size() * sizeof(uint32_t)) != 0;
+}
+
+static void bench_compose_print(const char* name, const bench_compose_stats& stats)
+{
+	const double frames = stats.frames;
+	printf("%-22s %6.1f %10.0f %10.0f %10.0f %7.3f%% %7d %6d %9.1f %9.1f %9u %9u\n",
+		name, stats.rects / frames, stats.dirty_pixels / frames, stats.touched_pixels / frames, stats.full_pixels / frames,
+		100.0 * stats.touched_pixels / stats.full_pixels, stats.whole_frames, stats.idle_frames, stats.compose_us / frames, stats.full_us / frames, stats.mismatched_frames, stats.clip_errors);
+}
+
+/*
+	Runs the Path-Man scene the way the game draws it, the maze in the static layer and the two
+	characters composed each tick as pathman chases a wandering ghost, then a large scene of many
+	sprites over a tiled background with a share of them moving or animating each frame. Every
+	composed frame is checked against drawing the frame whole with the CPU reference compositor.
+*/
+static void bench_compose(uint32_t sprite_count)
+{
+	const uint32_t pathman_frames = 3600;
+	const uint32_t stress_frames = 60;
+
+	// Regions and sizes as pathman registers them
+	sprite_atlas atlas;
+	sprite_atlas_init(&atlas, nullptr, 1024, 256);
+	const sprite_id maze = sprite_atlas_add(&atlas, "maze", 228, 0, 224, 248);
+	const sprite_sequence pathman_animation = sprite_atlas_add_sequence(&atlas, "pathman", 457, 1, 14, 14, 3, 16);
+	const sprite_sequence ghost_animation = sprite_atlas_add_sequence(&atlas, "ghost", 585, 65, 14, 14, 2, 16);
+	const std::vector<uint32_t> sheet = bench_compose_sheet(&atlas);
+
+	printf("%-22s %6s %10s %10s %10s %8s %7s %6s %9s %9s %9s %9s\n",
+		"scene", "rects", "dirty px", "touched px", "full px", "touched", "whole", "idle", "us", "full us", "mismatch", "clip err");
+
+	{
+		const int32_t scale = 4;
+		const int32_t width = 224 * scale, height = 248 * scale;
+
+		sprite_layer layer;
+		sprite_layer_init(&layer);
+		sprite_layer_add(&layer, maze, 0, 0, scale);
+
+		sprite_raster cached, frame, reference;
+		sprite_raster_init(&cached, width, height);
+		sprite_raster_init(&frame, width, height);
+		sprite_raster_init(&reference, width, height);
+		sprite_raster_draw_layer(&cached, &layer, &atlas, sheet.data());
+
+		sprite_dirty dirty;
+		sprite_dirty_init(&dirty, width, height);
+
+		entity_store entities;
+		entity_store_init(&entities, 2);
+		const entity_desc ghost_desc = {{13, 17}, ghost_animation, 8, UINT16_MAX};
+		const entity_desc pathman_desc = {{1, 1}, pathman_animation, 8, 20};
+		const entity_handle ghost = entity_create(&entities, &ghost_desc);
+		const entity_handle pathman = entity_create(&entities, &pathman_desc);
+
+		path_finder pf;
+		path_finder_init(&pf, &maze_grid);
+		std::vector<tile_pos> path;
+		std::vector<sprite_instance> sprites;
+
+		bench_compose_stats stats = {};
+		for (uint32_t tick = 0; tick < pathman_frames; tick++)
+		{
+			// The ghost wanders a tile every 15 ticks, pathman plans a new chase every 20
+			tile_pos* ghost_pos = &entities.positions[entity_index(&entities, ghost)];
+			if (tick % 15 == 0)
+			{
+				const uint32_t direction = bench_random(4);
+				if (tile_grid_get(&maze_grid, ghost_pos->x, ghost_pos->y) & (1 << direction))
+				{
+					ghost_pos->x += tile_direction_dx[direction];
+					ghost_pos->y += tile_direction_dy[direction];
+				}
+			}
+
+			if (tick % 20 == 0)
+			{
+				const path_query query = {entities.positions[entity_index(&entities, pathman)], *ghost_pos, path_mode_astar};
+				if (path_find(&pf, &query, &path, nullptr) && path.size() > 1)
+				{
+					path_packed packed;
+					path_packed_from_tiles(&packed, path.data(), (uint32_t)path.size() - 1);
+					entity_set_path(&entities, pathman, &packed);
+				}
+			}
+
+			entity_update_movement(&entities);
+			entity_update_animation(&entities);
+
+			sprites.clear();
+			for (uint32_t i = 0; i < entities.count; i++)
+				sprites.push_back({((entities.positions[i].x * 8) - 3) * scale, ((entities.positions[i].y * 8) - 3) * scale, entities.sprite_ids[i], (uint16_t)scale});
+
+			bench_compose_frame(&stats, &dirty, &frame, &cached, &reference, &layer, &atlas, sheet.data(), sprites);
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "pathman %dx%d", width, height);
+		bench_compose_print(name, stats);
+
+		path_finder_term(&pf);
+		entity_store_term(&entities);
+		sprite_dirty_term(&dirty);
+		sprite_raster_term(&cached);
+		sprite_raster_term(&frame);
+		sprite_raster_term(&reference);
+		sprite_layer_term(&layer);
+	}
+
+	for (uint32_t change_percent : {1, 5, 25})
+	{
+		const int32_t width = 3840, height = 2160, scale = 2;
+
+		// Maze copies tiled over the screen as the static layer
+		sprite_layer layer;
+		sprite_layer_init(&layer);
+		for (int32_t y = 0; y < height; y += 248)
+		{
+			for (int32_t x = 0; x < width; x += 224)
+				sprite_layer_add(&layer, maze, x, y, 1);
+		}
+
+		sprite_raster cached, frame, reference;
+		sprite_raster_init(&cached, width, height);
+		sprite_raster_init(&frame, width, height);
+		sprite_raster_init(&reference, width, height);
+		sprite_raster_draw_layer(&cached, &layer, &atlas, sheet.data());
+
+		sprite_dirty dirty;
+		sprite_dirty_init(&dirty, width, height);
+
+		// Sprites start anywhere, partly off screen included, each on a frame of one of the animations
+		std::vector<sprite_sequence> animations(sprite_count);
+		std::vector<uint32_t> frames(sprite_count);
+		std::vector<sprite_instance> sprites(sprite_count);
+		for (uint32_t i = 0; i < sprite_count; i++)
+		{
+			animations[i] = bench_random(2) ? pathman_animation : ghost_animation;
+			frames[i] = bench_random(animations[i].frame_count);
+			sprites[i] = {(int32_t)bench_random(width + 28) - 28, (int32_t)bench_random(height + 28) - 28, sprite_sequence_frame(animations[i], frames[i]), (uint16_t)scale};
+		}
+
+		bench_compose_stats stats = {};
+		for (uint32_t f = 0; f < stress_frames; f++)
+		{
+			// Changed sprites either step a few pixels or move on a frame
+			for (uint32_t i = 0; i < sprite_count; i++)
+			{
+				if (bench_random(100) >= change_percent)
+					continue;
+
+				if (bench_random(2))
+				{
+					sprites[i].x += (int32_t)bench_random(9) - 4;
+					sprites[i].y += (int32_t)bench_random(9) - 4;
+				}
+				else
+				{
+					frames[i] = (frames[i] + 1) % animations[i].frame_count;
+					sprites[i].id = sprite_sequence_frame(animations[i], frames[i]);
+				}
+			}
+
+			bench_compose_frame(&stats, &dirty, &frame, &cached, &reference, &layer, &atlas, sheet.data(), sprites);
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "%u sprites %u%% change", sprite_count, change_percent);
+		bench_compose_print(name, stats);
+
+		sprite_dirty_term(&dirty);
+		sprite_raster_term(&cached);
+		sprite_raster_term(&frame);
+		sprite_raster_term(&reference);
+		sprite_layer_term(&layer);
+	}
+}
+
+/*
+	Runs the path scheduler as a game would and reports how many allocations each frame makes,
+	first while the finders warm up and then in the steady state, which should be zero. Paths are
+	packed into each agent, so only the search nodes and open lists have to grow.
+	Steady state frames are held to a zero allocation budget so any that allocate are reported.
+*/
+static void bench_allocations()
+{
+#if ALLOC_PROFILE
+	const uint32_t agent_count = 32;
+	const uint32_t warm_up_frames = 120;
+	const uint32_t frame_count = 1200;
+
+	bench_map map;
+	bench_make_maze(&map, "corridors 256x256", 256, 256, maze_kind_corridors);
+
+	std::vector<path_query> queries;
+	std::vector<uint32_t> distances;
+	maze_generate_queries(&map.grid, frame_count, 4, 7, &queries, &distances);
+
+	path_landmarks lm;
+	path_landmarks_build(&lm, &map.grid, path_landmark_max);
+
+	path_schedule ps;
+	path_schedule_init(&ps, &map.grid, &lm, 4, agent_count, 256);
+
+	const alloc_totals setup = alloc_profile_totals();
+	alloc_profile_frame_end();
+
+	alloc_stats warm_up = {}, steady = {};
+	uint32_t steady_frames_allocating = 0;
+
+	for (uint32_t frame = 0; frame < frame_count; frame++)
+	{
+		if (frame == warm_up_frames)
+			alloc_profile_set_budget(0, 0, false);
+
+		path_schedule_request(&ps, frame % agent_count, &queries[frame]);
+		path_schedule_update(&ps, 2000, 1000.0);
+
+		const alloc_stats stats = alloc_profile_totals().this_frame;
+		alloc_stats* total = frame < warm_up_frames ? &warm_up : &steady;
+		total->allocs += stats.allocs;
+		total->frees += stats.frees;
+		total->bytes += stats.bytes;
+		steady_frames_allocating += frame >= warm_up_frames && stats.allocs;
+
+		alloc_profile_frame_end();
+	}
+
+	alloc_profile_set_budget(UINT64_MAX, UINT64_MAX, false);
+
+	path_schedule_term(&ps);
+	path_landmarks_term(&lm);
+
+	const alloc_totals totals = alloc_profile_totals();
+	printf("%s, %u agents\n", map.name, agent_count);
+	printf("setup          %8llu allocs %12llu bytes\n", (unsigned long long)setup.all.allocs, (unsigned long long)setup.all.bytes);
+	printf("warm up        %8.2f allocs/frame %12.1f bytes/frame over %u frames\n", (double)warm_up.allocs / warm_up_frames, (double)warm_up.bytes / warm_up_frames, warm_up_frames);
+	printf("steady state   %8.2f allocs/frame %12.1f bytes/frame over %u frames, %u frames allocated\n",
+		(double)steady.allocs / (frame_count - warm_up_frames), (double)steady.bytes / (frame_count - warm_up_frames), frame_count - warm_up_frames, steady_frames_allocating);
+	printf("peak live      %8llu bytes\n", (unsigned long long)totals.peak_bytes);
+#else
+	printf("allocation profiling is off in this build, use the debug build or build with CXXFLAGS=-DALLOC_PROFILE=1\n");
+#endif
+}
+
+int main(int argc, char** argv)
+{
+	const char* benchmark = argc > 1 ? argv[1] : "";
+	int result = 0;
+
+	if (strcmp(benchmark, "bidirectional") == 0)
+		bench_bidirectional();
+	else if (strcmp(benchmark, "landmarks") == 0)
+		bench_landmarks();
+	else if (strcmp(benchmark, "specialised") == 0)
+		bench_specialised();
+	else if (strcmp(benchmark, "sliced") == 0)
+		bench_sliced();
+	else if (strcmp(benchmark, "scaling") == 0)
+		bench_scaling(argc > 2 ? atoi(argv[2]) : 8192);
+	else if (strcmp(benchmark, "allocations") == 0)
+		bench_allocations();
+	else if (strcmp(benchmark, "nearest") == 0)
+		bench_nearest();
+	else if (strcmp(benchmark, "cooperative") == 0)
+		bench_cooperative();
+	else if (strcmp(benchmark, "parallel") == 0)
+		bench_parallel(argc > 2 ? atoi(argv[2]) : 4096);
+	else if (strcmp(benchmark, "database") == 0)
+		bench_database(argc > 2 ? atoi(argv[2]) : 256);
+	else if (strcmp(benchmark, "spatial") == 0)
+		bench_spatial();
+	else if (strcmp(benchmark, "entities") == 0)
+		bench_entities(argc > 2 ? (uint32_t)atoi(argv[2]) : 100000);
+	else if (strcmp(benchmark, "handoff") == 0)
+		result = bench_handoff();
+	else if (strcmp(benchmark, "packed") == 0)
+		bench_packed();
+	else if (strcmp(benchmark, "prune") == 0)
+		bench_prune();
+	else if (strcmp(benchmark, "scen") == 0 && argc > 2)
+		return bench_scenarios(argv[2], argc > 3 ? argv[3] : nullptr);
+	else if (strcmp(benchmark, "sprites") == 0)
+		bench_sprites(argc > 2 ? (uint32_t)atoi(argv[2]) : 100000);
+	else if (strcmp(benchmark, "arena") == 0)
+		bench_arena();
+	else if (strcmp(benchmark, "suboptimal") == 0)
+		bench_suboptimal();
+	else if (strcmp(benchmark, "layouts") == 0)
+		bench_layouts(argc > 2 ? atoi(argv[2]) : 0);
+	else if (strcmp(benchmark, "sparse") == 0)
+		bench_sparse();
+	else if (strcmp(benchmark, "bounds") == 0)
+		bench_bounds(argc > 2 ? atoi(argv[2]) : 128);
+	else if (strcmp(benchmark, "compose") == 0)
+		bench_compose(argc > 2 ? (uint32_t)atoi(argv[2]) : 10000);
+	else
+	{
+		printf("usage: pathbench <benchmark>\n");
+		printf("  bidirectional  nodes expanded by plain vs bidirectional A*\n");
+		printf("  landmarks      ALT landmark heuristic vs Manhattan distance\n");
+		printf("  specialised    compile-time grid policies vs runtime dimensions\n");
+		printf("  sliced         frame times with and without time-sliced searches\n");
+		printf("  scaling [max]  generated maps from 32x32 up to max (8192) square\n");
+		printf("  allocations    per-frame allocations of the path scheduler\n");
+		printf("  nearest        nearest of many goals vs one search per goal\n");
+		printf("  cooperative    WHCA* agents vs independent paths, time and conflicts\n");
+		printf("  parallel [n]   parallel BFS speedup by thread count on n and 2n square maps (4096)\n");
+		printf("  database [n]   compressed path database on an n square map (256) vs A*\n");
+		printf("  spatial        spatial hash updates and radius queries vs pairwise checks\n");
+		printf("  entities [n]   per-tick update of n (100000) animated agents, SoA vs AoS\n");
+		printf("  handoff        triple buffer and SPSC queue correctness and latency between threads\n");
+		printf("  packed         memory and allocations of packed 2 bit paths vs tile vectors\n");
+		printf("  prune          dead-end and swamp pruning on each map kind, and incremental updates\n");
+		printf("  scen <f> [dir]  MovingAI .scen file run as JSON, maps from dir or beside the file\n");
+		printf("  sprites [n]    per-sprite CPU cost of n (100000) sprites, pixel rects vs atlas regions\n");
+		printf("  arena          frame scratch arena vs heap on pathfinding allocation patterns\n");
+		printf("  suboptimal     weighted, focal and anytime path length vs search effort\n");
+		printf("  layouts [size]  row-major, blocked and Morton grid layouts on 4096 and 16384 square maps\n");
+		printf("  sparse         dense vs sparse search state by query length, and an endless world\n");
+		printf("  bounds [n]     goal bounding build, memory and A* expansions on n square maps (128)\n");
+		printf("  compose [n]    dirty rect composition of the Path-Man scene and n (10000) sprites at 4K vs whole frames\n");
+		return 1;
+	}
+
+	alloc_profile_report_leaks();
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+void entity_store_init(entity_store* es, uint32_t capacity)
+{
+	alloc_tag("entity");
+
+	es->count = 0;
+
+	es->positions.reserve(capacity);
+	es->anim_counters.reserve(capacity);
+	es->anim_lengths.reserve(capacity);
+	es->frame_ticks.reserve(capacity);
+	es->sprite_first.reserve(capacity);
+	es->sprite_ids.reserve(capacity);
+	es->move_periods.reserve(capacity);
+	es->move_timers.reserve(capacity);
+	es->paths.reserve(capacity);
+	es->path_cursors.reserve(capacity);
+	es->slots.reserve(capacity);
+	es->slot_indices.reserve(capacity);
+	es->slot_generations.reserve(capacity);
+	es->free_slots.reserve(capacity);
+}
+
+void entity_store_term(entity_store* es)
+{
+	// Swapping with empty vectors releases the storage, clear alone keeps it
+	std::vector<tile_pos>().swap(es->positions);
+	std::vector<uint16_t>().swap(es->anim_counters);
+	std::vector<uint16_t>().swap(es->anim_lengths);
+	std::vector<uint8_t>().swap(es->frame_ticks);
+	std::vector<sprite_id>().swap(es->sprite_first);
+	std::vector<sprite_id>().swap(es->sprite_ids);
+	std::vector<uint16_t>().swap(es->move_periods);
+	std::vector<uint16_t>().swap(es->move_timers);
+	std::vector<path_packed>().swap(es->paths);
+	std::vector<path_cursor>().swap(es->path_cursors);
+	std::vector<uint32_t>().swap(es->slots);
+	std::vector<uint32_t>().swap(es->slot_indices);
+	std::vector<uint32_t>().swap(es->slot_generations);
+	std::vector<uint32_t>().swap(es->free_slots);
+	es->count = 0;
+}
+
+entity_handle entity_create(entity_store* es, const entity_desc* desc)
+{
+	alloc_tag("entity");
+
+	assert(desc->animation.frame_count > 0 && desc->frame_ticks > 0 && desc->move_period > 0);
+
+	uint32_t slot;
+	if (!es->free_slots.empty())
+	{
+		slot = es->free_slots.back();
+		es->free_slots.pop_back();
+	}
+	else
+	{
+		slot = (uint32_t)es->slot_indices.size();
+		es->slot_indices.push_back(entity_none);
+		es->slot_generations.push_back(0);
+	}
+
+	const uint32_t index = es->count++;
+	es->slot_indices[slot] = index;
+
+	es->positions.push_back(desc->pos);
+	es->anim_counters.push_back(0);
+	es->anim_lengths.push_back((uint16_t)(desc->animation.frame_count * desc->frame_ticks));
+	es->frame_ticks.push_back(desc->frame_ticks);
+	es->sprite_first.push_back(desc->animation.first);
+	es->sprite_ids.push_back(desc->animation.first);
+	es->move_periods.push_back(desc->move_period);
+	es->move_timers.push_back(desc->move_period);
+	es->paths.emplace_back();
+	path_packed_clear(&es->paths.back(), desc->pos);
+	es->path_cursors.push_back(path_cursor_begin(&es->paths.back()));
+	es->slots.push_back(slot);
+
+	return {slot, es->slot_generations[slot]};
+}
+
+// Moves the entity at from into index to in every component array
+static void entity_move_index(entity_store* es, uint32_t from, uint32_t to)
+{
+	es->positions[to] = es->positions[from];
+	es->anim_counters[to] = es->anim_counters[from];
+	es->anim_lengths[to] = es->anim_lengths[from];
+	es->frame_ticks[to] = es->frame_ticks[from];
+	es->sprite_first[to] = es->sprite_first[from];
+	es->sprite_ids[to] = es->sprite_ids[from];
+	es->move_periods[to] = es->move_periods[from];
+	es->move_timers[to] = es->move_timers[from];
+	es->paths[to] = es->paths[from];
+	es->path_cursors[to] = es->path_cursors[from];
+	es->slots[to] = es->slots[from];
+
+	es->slot_indices[es->slots[to]] = to;
+}
+
+void entity_destroy(entity_store* es, entity_handle handle)
+{
+	const uint32_t index = entity_index(es, handle);
+	assert(index != entity_none);
+	if (index == entity_none)
+		return;
+
+	const uint32_t last = --es->count;
+	if (index != last)
+		entity_move_index(es, last, index);
+
+	es->positions.pop_back();
+	es->anim_counters.pop_back();
+	es->anim_lengths.pop_back();
+	es->frame_ticks.pop_back();
+	es->sprite_first.pop_back();
+	es->sprite_ids.pop_back();
+	es->move_periods.pop_back();
+	es->move_timers.pop_back();
+	es->paths.pop_back();
+	es->path_cursors.pop_back();
+	es->slots.pop_back();
+
+	es->slot_indices[handle.slot] = entity_none;
+	es->slot_generations[handle.slot]++;
+	es->free_slots.push_back(handle.slot);
+}
+
+void entity_set_path(entity_store* es, entity_handle handle, const path_packed* path)
+{
+	const uint32_t index = entity_index(es, handle);
+	assert(index != entity_none);
+
+	const tile_pos pos = es->positions[index];
+
+	es->paths[index] = *path;
+
+	// Walk the new path up to the entity's tile, if it is not on the path the cursor ends up past the last move and the entity waits
+	path_cursor* cursor = &es->path_cursors[index];
+	*cursor = path_cursor_begin(path);
+	while ((cursor->pos.x != pos.x || cursor->pos.y != pos.y) && path_cursor_next(path, cursor))
+	{
+	}
+}
+
+void entity_update_movement(entity_store* es)
+{
+	tile_pos* positions = es->positions.data();
+	uint16_t* timers = es->move_timers.data();
+	const uint16_t* periods = es->move_periods.data();
+	const path_packed* paths = es->paths.data();
+	path_cursor* cursors = es->path_cursors.data();
+
+	for (uint32_t i = 0; i < es->count; i++)
+	{
+		if (--timers[i] != 0)
+			continue;
+
+		timers[i] = periods[i];
+
+		if (path_cursor_next(&paths[i], &cursors[i]))
+			positions[i] = cursors[i].pos;
+	}
+}
+
+void entity_update_animation(entity_store* es)
+{
+	uint16_t* counters = es->anim_counters.data();
+	const uint16_t* lengths = es->anim_lengths.data();
+	const uint8_t* ticks = es->frame_ticks.data();
+	const sprite_id* first = es->sprite_first.data();
+	sprite_id* ids = es->sprite_ids.data();
+
+	for (uint32_t i = 0; i < es->count; i++)
+	{
+		const uint32_t counter = counters[i] + 1u == lengths[i] ? 0 : counters[i] + 1u;
+		counters[i] = (uint16_t)counter;
+		ids[i] = (sprite_id)(first[i] + (counter / ticks[i]));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+/*
+	Entity storage for agents and sprites, kept as structure of arrays.
+
+	Each component is its own array, and the arrays are packed: entity i of every array is the same
+	entity, and the first count entries are all alive. Destroying an entity moves the last one into
+	its place, so the update systems below just walk the arrays front to back and only touch the
+	components they need.
+
+	Because entities move around in the arrays, callers hold an entity_handle instead of an index.
+	A handle names a slot plus the generation of the slot when the entity was created. Slots are
+	reused after destroy with the generation bumped, so a stale handle is detected rather than
+	silently naming a different entity.
+*/
+struct entity_handle
+{
+	uint32_t slot;
+	uint32_t generation;
+};
+
+constexpr entity_handle entity_handle_none = {UINT32_MAX, 0};
+constexpr uint32_t entity_none = UINT32_MAX;
+
+struct entity_desc
+{
+	tile_pos		pos;
+	sprite_sequence	animation;		// Frames of the sprite atlas cycled through
+	uint8_t			frame_ticks;	// Ticks each frame is shown for
+	uint16_t		move_period;	// Ticks between steps along the path
+};
+
+struct entity_store
+{
+	uint32_t								count;
+
+	// Position
+	std::vector<tile_pos>					positions;
+
+	// Animation state
+	std::vector<uint16_t>					anim_counters;
+	std::vector<uint16_t>					anim_lengths;		// frame_count * frame_ticks
+	std::vector<uint8_t>					frame_ticks;
+
+	// Sprite frame, rewritten from the animation state every tick
+	std::vector<sprite_id>					sprite_first;		// Atlas region of the first frame
+	std::vector<sprite_id>					sprite_ids;
+
+	// Path state
+	std::vector<uint16_t>					move_periods;
+	std::vector<uint16_t>					move_timers;		// Ticks until the next step
+	std::vector<path_packed>				paths;
+	std::vector<path_cursor>				path_cursors;
+
+	// Handles, dense index to slot and back
+	std::vector<uint32_t>					slots;
+	std::vector<uint32_t>					slot_indices;		// Dense index of each slot, entity_none if free
+	std::vector<uint32_t>					slot_generations;
+	std::vector<uint32_t>					free_slots;
+};
+
+void entity_store_init(entity_store* es, uint32_t capacity);
+void entity_store_term(entity_store* es);
+
+entity_handle entity_create(entity_store* es, const entity_desc* desc);
+void entity_destroy(entity_store* es, entity_handle handle);
+
+// Dense index of the entity, entity_none if the handle is stale. Indices change on destroy
+inline uint32_t entity_index(const entity_store* es, entity_handle handle)
+{
+	if (handle.slot >= es->slot_generations.size() || es->slot_generations[handle.slot] != handle.generation)
+		return entity_none;
+
+	return es->slot_indices[handle.slot];
+}
+
+/*
+	Gives the entity a path to follow. If the entity is standing on one of the tiles it carries on
+	from there, otherwise it waits where it is, as it cannot step onto a tile it is not next to.
+	Paths are held packed, so this never allocates.
+*/
+void entity_set_path(entity_store* es, entity_handle handle, const path_packed* path);
+
+/*
+	Update systems, run once per tick. Movement steps every entity whose timer is up onto its next
+	path tile, animation advances the counters and picks each entity's atlas region.
+*/
+void entity_update_movement(entity_store* es);
+void entity_update_animation(entity_store* es);
\ No newline at end of file
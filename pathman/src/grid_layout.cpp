@@ -0,0 +1,80 @@
+const char* const grid_layout_names[grid_layout_count] = {"row major", "blocked 8x8", "morton"};
+
+void grid_layout_build(grid_layout* layout, const tile_grid* grid, grid_layout_kind kind)
+{
+	alloc_tag("grid_layout");
+
+	layout->grid = grid;
+	layout->kind = kind;
+	layout->blocks_x = 0;
+	layout->bits = 0;
+	layout->tiles.clear();
+
+	switch (kind)
+	{
+	case grid_layout_row_major:
+		layout->tile_count = (uint32_t)(grid->width * grid->height);
+		return;
+	case grid_layout_blocked:
+	{
+		layout->blocks_x = (uint32_t)(grid->width + 7) / 8;
+		layout->tile_count = layout->blocks_x * ((uint32_t)(grid->height + 7) / 8) * 64;
+		layout->tiles.assign(layout->tile_count, tile_flags_wall);
+
+		const grid_blocked blocked(layout);
+		for (int32_t y = 0; y < grid->height; y++)
+		{
+			for (int32_t x = 0; x < grid->width; x++)
+				layout->tiles[blocked.index({x, y})] = grid->tiles[(y * grid->width) + x];
+		}
+		return;
+	}
+	case grid_layout_morton:
+	{
+		// Indices are 32 bits, so the padded side can be at most 2^15
+		const uint32_t side = (uint32_t)std::max(grid->width, grid->height);
+		while ((1u << layout->bits) < side)
+			layout->bits++;
+		assert(layout->bits <= 15);
+
+		layout->tile_count = 1u << (layout->bits * 2);
+		layout->tiles.assign(layout->tile_count, tile_flags_wall);
+
+		for (int32_t y = 0; y < grid->height; y++)
+		{
+			for (int32_t x = 0; x < grid->width; x++)
+				layout->tiles[grid_morton::index({x, y})] = grid->tiles[(y * grid->width) + x];
+		}
+		return;
+	}
+	default:
+		assert(false);
+	}
+}
+
+void grid_layout_term(grid_layout* layout)
+{
+	std::vector<uint8_t>().swap(layout->tiles);
+}
+
+void path_finder_set_layout(path_finder* pf, const grid_layout* layout)
+{
+	alloc_tag("path_find");
+
+	assert(layout->grid == pf->grid);
+
+	if (layout->tile_count <= pf->node_count)
+		return;
+
+	// Nothing carries over, new arrays are zeroed and no search id matches a zeroed node
+	for (path_node*& nodes : pf->nodes)
+	{
+		if (nodes)
+		{
+			free(nodes);
+			nodes = (path_node*)calloc(layout->tile_count, sizeof(path_node));
+		}
+	}
+
+	pf->node_count = layout->tile_count;
+}
\ No newline at end of file
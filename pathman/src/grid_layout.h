@@ -0,0 +1,157 @@
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+	#include <immintrin.h>
+	#define GRID_LAYOUT_BMI2 1
+#endif
+
+/*
+	Tile orders for large maps.
+
+	tile_grid stores tiles row-major, so on a wide map the tiles above and below are a whole row
+	away and every vertical step of a search touches another cache line, and past 512 tiles wide
+	another page of the node array. A grid_layout holds a copy of a grid's tile flags in another
+	order, which the matching grid policy indexes so path_search runs on it like on any map:
+
+		row major	The tile_grid order itself, searched with grid_dynamic. No copy is made.
+		blocked		8x8 tile blocks stored one after another, row-major by block. A block's tile
+					flags are one cache line and its nodes eight. The map is padded to whole blocks.
+		morton		Z-order, the index interleaving the bits of x and y so every aligned power of two
+					square is contiguous. The map is padded to a power of two square. Converting
+					between index and position uses pdep and pext where BMI2 is available, and
+					stepping to a neighbour works on the interleaved bits without converting.
+
+	Search state follows the layout, as node arrays are indexed by the layout's tile index, so a
+	finder used with a layout must have been given it with path_finder_set_layout. Landmarks and
+	pruning are built over row-major indices and cannot be used with the other layouts.
+*/
+enum grid_layout_kind : uint8_t
+{
+	grid_layout_row_major,
+	grid_layout_blocked,
+	grid_layout_morton,
+	grid_layout_count
+};
+
+extern const char* const grid_layout_names[grid_layout_count];
+
+struct grid_layout
+{
+	const tile_grid*		grid;
+	grid_layout_kind		kind;
+	uint32_t				tile_count;		// Tiles including padding, the node count searches need
+	uint32_t				blocks_x;		// Blocked, blocks per row
+	uint32_t				bits;			// Morton, log2 of the padded side
+	std::vector<uint8_t>	tiles;			// Tile flags in layout order with padding as wall, empty for row major
+};
+
+void grid_layout_build(grid_layout* layout, const tile_grid* grid, grid_layout_kind kind);
+void grid_layout_term(grid_layout* layout);
+
+// Grows the finder's node arrays to one node per tile of the layout, which must be of its grid
+void path_finder_set_layout(path_finder* pf, const grid_layout* layout);
+
+/*
+	8x8 blocked policy. Inside a block an index is (y & 7) * 8 + (x & 7), so a step stays in the
+	block unless it leaves through an edge, when it moves to the same row or column of the next
+	block over instead. The choice is a compare and a conditional add rather than a branch.
+*/
+struct grid_blocked
+{
+	const uint8_t*	tiles;
+	uint32_t		blocks_x;
+	uint32_t		row_step;		// Index distance between vertically adjacent blocks
+	uint32_t		steps[4];		// Index change of a step inside a block
+	uint32_t		crossings[4];	// and of a step into the next block
+	uint32_t		masks[4];		// Bits of the index along the step's axis
+	uint32_t		edges[4];		// and their value on the edge a step would leave through
+
+	explicit grid_blocked(const grid_layout* layout) :
+		tiles(layout->tiles.data()), blocks_x(layout->blocks_x), row_step(layout->blocks_x * 64),
+		steps{(uint32_t)-8, 8, (uint32_t)-1, 1},
+		crossings{56 - row_step, row_step - 56, (uint32_t)-57, 57},
+		masks{0x38, 0x38, 0x07, 0x07},
+		edges{0x00, 0x38, 0x00, 0x07}
+	{
+		assert(layout->kind == grid_layout_blocked);
+	}
+
+	uint32_t index(tile_pos pos) const
+	{
+		const uint32_t block = ((uint32_t)pos.y >> 3) * row_step + (((uint32_t)pos.x >> 3) << 6);
+		return block | (((uint32_t)pos.y & 7) << 3) | ((uint32_t)pos.x & 7);
+	}
+
+	tile_pos pos(uint32_t index) const
+	{
+		const uint32_t block = index >> 6;
+		return {(int32_t)(((block % blocks_x) << 3) | (index & 7)), (int32_t)(((block / blocks_x) << 3) | ((index >> 3) & 7))};
+	}
+
+	uint32_t neighbour(uint32_t index, uint32_t direction) const
+	{
+		return index + ((index & masks[direction]) == edges[direction] ? crossings[direction] : steps[direction]);
+	}
+};
+
+/*
+	Morton policy. x is spread over the even index bits and y over the odd ones. Adding to one
+	coordinate in place sets the other coordinate's bits first so carries jump across them, and
+	the masked sum then takes only its own bits back: ((index | other) + delta) & own. Moving back
+	one tile adds the all ones pattern of the axis, which is -1 in the same interleaved form.
+*/
+constexpr uint32_t grid_morton_x_bits = 0x55555555;
+constexpr uint32_t grid_morton_y_bits = 0xAAAAAAAA;
+
+inline uint32_t grid_morton_spread(uint32_t value)
+{
+#ifdef GRID_LAYOUT_BMI2
+	return _pdep_u32(value, grid_morton_x_bits);
+#else
+	value &= 0xFFFF;
+	value = (value | (value << 8)) & 0x00FF00FF;
+	value = (value | (value << 4)) & 0x0F0F0F0F;
+	value = (value | (value << 2)) & 0x33333333;
+	return (value | (value << 1)) & 0x55555555;
+#endif
+}
+
+inline uint32_t grid_morton_compact(uint32_t value)
+{
+#ifdef GRID_LAYOUT_BMI2
+	return _pext_u32(value, grid_morton_x_bits);
+#else
+	value &= 0x55555555;
+	value = (value | (value >> 1)) & 0x33333333;
+	value = (value | (value >> 2)) & 0x0F0F0F0F;
+	value = (value | (value >> 4)) & 0x00FF00FF;
+	return (value | (value >> 8)) & 0xFFFF;
+#endif
+}
+
+struct grid_morton
+{
+	const uint8_t* tiles;
+
+	explicit grid_morton(const grid_layout* layout) : tiles(layout->tiles.data())
+	{
+		assert(layout->kind == grid_layout_morton);
+	}
+
+	static uint32_t index(tile_pos pos)
+	{
+		return grid_morton_spread((uint32_t)pos.x) | (grid_morton_spread((uint32_t)pos.y) << 1);
+	}
+
+	static tile_pos pos(uint32_t index)
+	{
+		return {(int32_t)grid_morton_compact(index), (int32_t)grid_morton_compact(index >> 1)};
+	}
+
+	static uint32_t neighbour(uint32_t index, uint32_t direction)
+	{
+		constexpr uint32_t own[4] = {grid_morton_y_bits, grid_morton_y_bits, grid_morton_x_bits, grid_morton_x_bits};
+		constexpr uint32_t deltas[4] = {grid_morton_y_bits, 2, grid_morton_x_bits, 1};
+
+		const uint32_t other = ~own[direction];
+		return (((index | other) + deltas[direction]) & own[direction]) | (index & other);
+	}
+};
\ No newline at end of file
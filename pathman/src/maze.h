@@ -0,0 +1,45 @@
+constexpr int32_t maze_width = 224;
+constexpr int32_t maze_height = 248;
+constexpr int32_t tile_map_width = maze_width / 8;
+constexpr int32_t tile_map_height = maze_height / 8;
+
+/*
+	28 x 31 Path-Man maze, one tile_flags value per 8x8 pixel tile. Open bits must agree between
+	neighbours (a tile open to the right has a neighbour open to the left) as the searches treat the
+	map as an undirected graph.
+*/
+static uint8_t tile_map[tile_map_width * tile_map_height] = {
+	0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0xA,0xC,0xC,0xC,0xC,0xE,0xC,0xC,0xC,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0xC,0xC,0xC,0xE,0xC,0xC,0xC,0xC,0x6,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0xB,0xC,0xC,0xC,0xC,0xF,0xC,0xC,0xE,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0xE,0xC,0xC,0xF,0xC,0xC,0xC,0xC,0x7,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x9,0xC,0xC,0xC,0xC,0x7,0x0,0x0,0x9,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0x5,0x0,0x0,0xB,0xC,0xC,0xC,0xC,0x5,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0xA,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0x6,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0xB,0xC,0xC,0x7,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0xB,0xC,0xC,0x7,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0xB,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0x7,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
+	0x0,0xA,0xC,0xC,0xC,0xC,0xF,0xC,0xC,0xD,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0xD,0xC,0xC,0xF,0xC,0xC,0xC,0xC,0x6,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x9,0xC,0x6,0x0,0x0,0xB,0xC,0xC,0xE,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0xE,0xC,0xC,0x7,0x0,0x0,0xA,0xC,0x5,0x0,
+	0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,
+	0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,
+	0x0,0xA,0xC,0xD,0xC,0xC,0x5,0x0,0x0,0x9,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0x5,0x0,0x0,0x9,0xC,0xC,0xD,0xC,0x6,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,
+	0x0,0x9,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0x5,0x0,
+	0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0
+};
+
+static const tile_grid maze_grid = {tile_map_width, tile_map_height, tile_map};
\ No newline at end of file
@@ -0,0 +1,285 @@
+const char* const maze_kind_names[maze_kind_count] = {"perfect", "braided", "rooms", "corridors"};
+
+/*
+	Cell lattice a map is carved from. Cell (cx, cy) covers cell_size tiles square starting at
+	wall + (c * pitch), doors between neighbouring cells are door_size tiles wide.
+*/
+struct maze_lattice
+{
+	int32_t width;			// Map size in tiles
+	int32_t cell_size;
+	int32_t wall;
+	int32_t door_size;
+	int32_t pitch;			// cell_size + wall
+	int32_t columns;
+	int32_t rows;
+};
+
+static maze_lattice maze_lattice_make(int32_t width, int32_t height, int32_t cell_size, int32_t wall, int32_t door_size)
+{
+	const int32_t pitch = cell_size + wall;
+	return {width, cell_size, wall, door_size, pitch, std::max(1, (width - wall) / pitch), std::max(1, (height - wall) / pitch)};
+}
+
+static void maze_fill(uint8_t* walkable, int32_t width, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	for (int32_t row = y; row < y + h; row++)
+		memset(&walkable[((size_t)row * width) + x], 1, w);
+}
+
+// Opens the cell interior, doors are opened separately by maze_open_door
+static void maze_open_cell(const maze_lattice* lattice, uint8_t* walkable, int32_t cx, int32_t cy)
+{
+	const int32_t x = lattice->wall + (cx * lattice->pitch);
+	const int32_t y = lattice->wall + (cy * lattice->pitch);
+	maze_fill(walkable, lattice->width, x, y, lattice->cell_size, lattice->cell_size);
+}
+
+// Opens the wall between a cell and its neighbour in the given direction, centred on the shared side
+static void maze_open_door(const maze_lattice* lattice, uint8_t* walkable, int32_t cx, int32_t cy, uint32_t direction)
+{
+	const int32_t x = lattice->wall + (cx * lattice->pitch);
+	const int32_t y = lattice->wall + (cy * lattice->pitch);
+	const int32_t door = (lattice->cell_size - lattice->door_size) / 2;
+
+	switch (direction)
+	{
+	case tile_direction_up:		maze_fill(walkable, lattice->width, x + door, y - lattice->wall, lattice->door_size, lattice->wall); break;
+	case tile_direction_down:	maze_fill(walkable, lattice->width, x + door, y + lattice->cell_size, lattice->door_size, lattice->wall); break;
+	case tile_direction_left:	maze_fill(walkable, lattice->width, x - lattice->wall, y + door, lattice->wall, lattice->door_size); break;
+	case tile_direction_right:	maze_fill(walkable, lattice->width, x + lattice->cell_size, y + door, lattice->wall, lattice->door_size); break;
+	}
+}
+
+static bool maze_cell_neighbour(const maze_lattice* lattice, int32_t cx, int32_t cy, uint32_t direction, int32_t* nx, int32_t* ny)
+{
+	*nx = cx + tile_direction_dx[direction];
+	*ny = cy + tile_direction_dy[direction];
+
+	return *nx >= 0 && *nx < lattice->columns && *ny >= 0 && *ny < lattice->rows;
+}
+
+/*
+	Links every cell into a spanning tree with a randomised depth first search. doors receives the
+	tile_flags style mask of opened doors for each cell.
+*/
+static void maze_carve_tree(const maze_lattice* lattice, uint8_t* walkable, std::vector<uint8_t>* doors, maze_random* rng)
+{
+	doors->assign((size_t)lattice->columns * lattice->rows, 0);
+
+	for (int32_t cy = 0; cy < lattice->rows; cy++)
+	{
+		for (int32_t cx = 0; cx < lattice->columns; cx++)
+			maze_open_cell(lattice, walkable, cx, cy);
+	}
+
+	std::vector<uint8_t> visited((size_t)lattice->columns * lattice->rows, 0);
+	std::vector<uint32_t> stack;
+	stack.push_back(0);
+	visited[0] = 1;
+
+	while (!stack.empty())
+	{
+		const uint32_t cell = stack.back();
+		const int32_t cx = (int32_t)(cell % lattice->columns);
+		const int32_t cy = (int32_t)(cell / lattice->columns);
+
+		uint32_t options[4];
+		uint32_t option_count = 0;
+		for (uint32_t direction = 0; direction < 4; direction++)
+		{
+			int32_t nx, ny;
+			if (maze_cell_neighbour(lattice, cx, cy, direction, &nx, &ny) && !visited[((size_t)ny * lattice->columns) + nx])
+				options[option_count++] = direction;
+		}
+
+		if (option_count == 0)
+		{
+			stack.pop_back();
+			continue;
+		}
+
+		const uint32_t direction = options[maze_random_next(rng, option_count)];
+		const uint32_t next = cell + (uint32_t)((tile_direction_dy[direction] * lattice->columns) + tile_direction_dx[direction]);
+
+		maze_open_door(lattice, walkable, cx, cy, direction);
+		(*doors)[cell] |= 1 << direction;
+		(*doors)[next] |= 1 << (direction ^ 1);
+		visited[next] = 1;
+		stack.push_back(next);
+	}
+}
+
+/*
+	Opens one more door from cells that have exactly one (dead ends) with the given percent chance,
+	and from every other cell with loop_percent chance.
+*/
+static void maze_add_loops(const maze_lattice* lattice, uint8_t* walkable, std::vector<uint8_t>* doors, uint32_t dead_end_percent, uint32_t loop_percent, maze_random* rng)
+{
+	for (int32_t cy = 0; cy < lattice->rows; cy++)
+	{
+		for (int32_t cx = 0; cx < lattice->columns; cx++)
+		{
+			const uint32_t cell = (uint32_t)((cy * lattice->columns) + cx);
+			const uint8_t mask = (*doors)[cell];
+			const bool dead_end = mask && !(mask & (mask - 1));
+			if (maze_random_next(rng, 100) >= (dead_end ? dead_end_percent : loop_percent))
+				continue;
+
+			uint32_t options[4];
+			uint32_t option_count = 0;
+			for (uint32_t direction = 0; direction < 4; direction++)
+			{
+				int32_t nx, ny;
+				if (!(mask & (1 << direction)) && maze_cell_neighbour(lattice, cx, cy, direction, &nx, &ny))
+					options[option_count++] = direction;
+			}
+
+			if (option_count == 0)
+				continue;
+
+			const uint32_t direction = options[maze_random_next(rng, option_count)];
+			const uint32_t next = cell + (uint32_t)((tile_direction_dy[direction] * lattice->columns) + tile_direction_dx[direction]);
+
+			maze_open_door(lattice, walkable, cx, cy, direction);
+			(*doors)[cell] |= 1 << direction;
+			(*doors)[next] |= 1 << (direction ^ 1);
+		}
+	}
+}
+
+/*
+	Path-Man corridors. A braided maze with one tile corridors and two tile wall blocks is carved on
+	the left half and mirrored onto the right, then the halves are joined by opening the centre
+	column wherever a corridor row meets it.
+*/
+static void maze_generate_corridors(uint8_t* walkable, int32_t width, int32_t height, maze_random* rng)
+{
+	const int32_t half = (width + 1) / 2;
+	const maze_lattice lattice = maze_lattice_make(width, height, 1, 2, 1);
+	maze_lattice left = maze_lattice_make(width, height, 1, 2, 1);
+	left.columns = std::max(1, (half - lattice.wall) / lattice.pitch);
+
+	std::vector<uint8_t> doors;
+	maze_carve_tree(&left, walkable, &doors, rng);
+	maze_add_loops(&left, walkable, &doors, 100, 10, rng);
+
+	for (int32_t y = 0; y < height; y++)
+	{
+		uint8_t* row = &walkable[(size_t)y * width];
+		for (int32_t x = 0; x < width / 2; x++)
+			row[width - 1 - x] = row[x];
+	}
+
+	// Right most column of left half cells, joined straight across to its mirror image
+	const int32_t edge = lattice.wall + ((left.columns - 1) * lattice.pitch);
+	for (int32_t cy = 0; cy < lattice.rows; cy++)
+	{
+		if (cy % 2 && cy != lattice.rows - 1)
+			continue;
+
+		const int32_t y = lattice.wall + (cy * lattice.pitch);
+		maze_fill(walkable, width, edge, y, width - (edge * 2), 1);
+	}
+}
+
+void maze_generate(std::vector<uint8_t>* tiles, int32_t width, int32_t height, maze_kind kind, uint64_t seed)
+{
+	assert(width >= 8 && height >= 8);
+	alloc_tag("maze_gen");
+
+	maze_random rng;
+	maze_random_seed(&rng, seed);
+
+	tiles->assign((size_t)width * height, 0);
+	uint8_t* walkable = tiles->data();
+	std::vector<uint8_t> doors;
+
+	switch (kind)
+	{
+	case maze_kind_perfect:
+	{
+		const maze_lattice lattice = maze_lattice_make(width, height, 1, 1, 1);
+		maze_carve_tree(&lattice, walkable, &doors, &rng);
+		break;
+	}
+	case maze_kind_braided:
+	{
+		const maze_lattice lattice = maze_lattice_make(width, height, 1, 1, 1);
+		maze_carve_tree(&lattice, walkable, &doors, &rng);
+		maze_add_loops(&lattice, walkable, &doors, 100, 0, &rng);
+		break;
+	}
+	case maze_kind_rooms:
+	{
+		// Rooms shrink on small maps so there are always a few of them
+		const int32_t room = std::max(3, std::min(15, (std::min(width, height) / 4) - 1));
+		const maze_lattice lattice = maze_lattice_make(width, height, room, 1, std::max(1, room / 3));
+		maze_carve_tree(&lattice, walkable, &doors, &rng);
+		maze_add_loops(&lattice, walkable, &doors, 50, 25, &rng);
+		break;
+	}
+	case maze_kind_corridors:
+		maze_generate_corridors(walkable, width, height, &rng);
+		break;
+	default:
+		assert(false);
+	}
+
+	tile_flags_from_walkable(walkable, width, height);
+}
+
+void maze_generate_queries(const tile_grid* grid, uint32_t count, uint32_t goals_per_start, uint64_t seed, std::vector<path_query>* queries, std::vector<uint32_t>* distances)
+{
+	assert(goals_per_start > 0);
+	alloc_tag("maze_gen");
+
+	const size_t tile_count = (size_t)grid->width * grid->height;
+	const grid_dynamic tiles(grid);
+
+	maze_random rng;
+	maze_random_seed(&rng, seed);
+
+	queries->clear();
+	distances->clear();
+
+	std::vector<uint32_t> distance(tile_count);
+	std::vector<uint32_t> reached;
+
+	while (queries->size() < count)
+	{
+		// Rejection sample an open start, every map kind is at least a quarter open
+		uint32_t start;
+		do
+			start = (uint32_t)(((uint64_t)maze_random_next(&rng, UINT32_MAX) * tile_count) >> 32);
+		while (grid->tiles[start] == tile_flags_wall);
+
+		// Breadth first search, reached doubles as the list of candidate goals
+		std::fill(distance.begin(), distance.end(), UINT32_MAX);
+		reached.clear();
+		reached.push_back(start);
+		distance[start] = 0;
+
+		for (size_t head = 0; head < reached.size(); head++)
+		{
+			const uint32_t index = reached[head];
+			const tile_neighbours& neighbours = tile_neighbours_of(grid->tiles[index]);
+			for (uint32_t i = 0; i < neighbours.count; i++)
+			{
+				const uint32_t next = index + tiles.offset(neighbours.directions[i]);
+				if (distance[next] != UINT32_MAX)
+					continue;
+
+				distance[next] = distance[index] + 1;
+				reached.push_back(next);
+			}
+		}
+
+		for (uint32_t i = 0; i < goals_per_start && queries->size() < count; i++)
+		{
+			const uint32_t goal = reached[maze_random_next(&rng, (uint32_t)reached.size())];
+			queries->push_back({tiles.pos(start), tiles.pos(goal), path_mode_astar});
+			distances->push_back(distance[goal]);
+		}
+	}
+}
\ No newline at end of file
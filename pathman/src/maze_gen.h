@@ -0,0 +1,53 @@
+/*
+	Seeded procedural maze generation for testing and benchmarking the searches at any size.
+
+	Every layout is built on a lattice of square cells separated by walls. A randomised depth first
+	search links the cells into a spanning tree by opening doors in the walls between them, and some
+	layouts then open extra doors to add loops. The output uses the same tile_flags encoding as the
+	shipped maze. The same kind, size and seed always give the same map.
+*/
+enum maze_kind : uint8_t
+{
+	maze_kind_perfect,		// One tile corridors with exactly one route between any two tiles
+	maze_kind_braided,		// Perfect maze with every dead end opened into a loop
+	maze_kind_rooms,		// Large open rooms joined by wide doorways, with some extra loops
+	maze_kind_corridors,	// Path-Man style corridors between thick wall blocks, mirrored left to right
+	maze_kind_count
+};
+
+extern const char* const maze_kind_names[maze_kind_count];
+
+struct maze_random
+{
+	uint64_t state;
+};
+
+inline void maze_random_seed(maze_random* rng, uint64_t seed)
+{
+	// Zero is the one state xorshift can never leave
+	rng->state = seed ? seed : 0x9E3779B97F4A7C15ull;
+}
+
+inline uint32_t maze_random_next(maze_random* rng, uint32_t range)
+{
+	// xorshift64*
+	rng->state ^= rng->state >> 12;
+	rng->state ^= rng->state << 25;
+	rng->state ^= rng->state >> 27;
+
+	return (uint32_t)(((rng->state * 0x2545F4914F6CDD1Dull) >> 32) % range);
+}
+
+/*
+	Fills tiles with a width * height map of the given kind in tile_flags form. Maps must be at
+	least 8 tiles each way. The outer edge is always wall and every open tile is reachable from
+	every other.
+*/
+void maze_generate(std::vector<uint8_t>* tiles, int32_t width, int32_t height, maze_kind kind, uint64_t seed);
+
+/*
+	Picks count queries between random open tiles along with their optimal path costs, found by a
+	breadth first search from each start. Each start is reused for goals_per_start goals so large
+	maps need fewer floods. Goals are always reachable from their start.
+*/
+void maze_generate_queries(const tile_grid* grid, uint32_t count, uint32_t goals_per_start, uint64_t seed, std::vector<path_query>* queries, std::vector<uint32_t>* distances);
\ No newline at end of file
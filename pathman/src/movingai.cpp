@@ -0,0 +1,110 @@
+static bool movingai_passable(char c)
+{
+	return c == '.' || c == 'G' || c == 'S';
+}
+
+bool movingai_load_map(const char* filename, movingai_map* map)
+{
+	alloc_tag("movingai");
+
+	FILE* file = fopen(filename, "r");
+	if (!file)
+	{
+		fprintf(stderr, "%s: could not open map\n", filename);
+		return false;
+	}
+
+	// Header lines are "name value" pairs in any order, ending with a line that is just "map"
+	int32_t width = 0, height = 0;
+	char key[32], value[32];
+	while (fscanf(file, "%31s", key) == 1 && strcmp(key, "map") != 0)
+	{
+		if (fscanf(file, "%31s", value) != 1)
+			break;
+
+		if (strcmp(key, "width") == 0)
+			width = atoi(value);
+		else if (strcmp(key, "height") == 0)
+			height = atoi(value);
+	}
+
+	if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF || strcmp(key, "map") != 0)
+	{
+		fprintf(stderr, "%s: missing or bad map header\n", filename);
+		fclose(file);
+		return false;
+	}
+
+	map->tiles.assign((size_t)width * height, 0);
+
+	bool valid = true;
+	for (int32_t y = 0; y < height && valid; y++)
+	{
+		for (int32_t x = 0; x < width; x++)
+		{
+			// Skips the line breaks, so both LF and CRLF files load
+			int c;
+			do
+				c = fgetc(file);
+			while (c == '\n' || c == '\r');
+
+			if (c == EOF)
+			{
+				valid = false;
+				break;
+			}
+
+			map->tiles[(size_t)y * width + x] = movingai_passable((char)c) ? 1 : 0;
+		}
+	}
+
+	fclose(file);
+
+	if (!valid)
+	{
+		fprintf(stderr, "%s: map ends before %dx%d tiles\n", filename, width, height);
+		return false;
+	}
+
+	tile_flags_from_walkable(map->tiles.data(), width, height);
+	map->grid = {width, height, map->tiles.data()};
+	return true;
+}
+
+bool movingai_load_scenarios(const char* filename, std::vector<movingai_scenario>* scenarios)
+{
+	alloc_tag("movingai");
+
+	scenarios->clear();
+
+	FILE* file = fopen(filename, "r");
+	if (!file)
+	{
+		fprintf(stderr, "%s: could not open scenarios\n", filename);
+		return false;
+	}
+
+	float version;
+	if (fscanf(file, " version %f", &version) != 1)
+	{
+		fprintf(stderr, "%s: missing version line\n", filename);
+		fclose(file);
+		return false;
+	}
+
+	// Map names never contain whitespace, the 255 matches movingai_max_name
+	movingai_scenario scenario;
+	while (fscanf(file, "%u %255s %d %d %d %d %d %d %lf", &scenario.bucket, scenario.map, &scenario.map_width, &scenario.map_height,
+		&scenario.start.x, &scenario.start.y, &scenario.goal.x, &scenario.goal.y, &scenario.optimal) == 9)
+	{
+		scenarios->push_back(scenario);
+	}
+
+	const bool valid = feof(file) != 0;
+	fclose(file);
+
+	if (!valid)
+		fprintf(stderr, "%s: malformed scenario after line %u\n", filename, (uint32_t)scenarios->size() + 1);
+
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+/*
+	Loaders for the MovingAI grid pathfinding benchmark formats, so the searches can be checked
+	against published map sets.
+
+	A .map file is a short header (type, height, width) followed by "map" and one line of
+	characters per row. '.', 'G' and 'S' are passable ground, anything else ('@', 'O', 'T', 'W')
+	blocks. Maps are converted to tile_flags with each tile opened toward its passable
+	neighbours, so they search like any other grid.
+
+	A .scen file starts with "version 1" and has one scenario per line: bucket, map file, map
+	width and height, start x and y, goal x and y, and the optimal path length. The reference
+	lengths are for 8-connected movement with diagonals costing sqrt(2), which is never longer
+	than the 4-connected paths these searches find.
+*/
+constexpr uint32_t movingai_max_name = 256;
+
+struct movingai_map
+{
+	tile_grid				grid;
+	std::vector<uint8_t>	tiles;
+};
+
+struct movingai_scenario
+{
+	uint32_t	bucket;
+	char		map[movingai_max_name];		// Map file as written in the .scen, usually relative
+	int32_t		map_width;
+	int32_t		map_height;
+	tile_pos	start;
+	tile_pos	goal;
+	double		optimal;					// Reference 8-connected length
+};
+
+// Both return false and print the reason to stderr if the file cannot be read or is malformed
+bool movingai_load_map(const char* filename, movingai_map* map);
+bool movingai_load_scenarios(const char* filename, std::vector<movingai_scenario>* scenarios);
\ No newline at end of file
@@ -0,0 +1,153 @@
+struct path_bounds_build_state
+{
+	const tile_grid*		grid;
+	const uint32_t*			sources;	// Walkable tiles
+	uint32_t				source_count;
+	std::atomic<uint32_t>	next_source;
+	path_bounds_box*		boxes;
+};
+
+// FNV-1a over the tile flags, telling a saved file from one built for an edited map
+static uint64_t path_bounds_hash(const tile_grid* grid)
+{
+	const size_t tile_count = (size_t)grid->width * grid->height;
+
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for (size_t i = 0; i < tile_count; i++)
+		hash = (hash ^ grid->tiles[i]) * 0x100000001B3ull;
+
+	return hash;
+}
+
+// Every tile the search from the source reached grows the box of each move starting a shortest path to it
+static void path_bounds_build_source(path_bounds_build_state* state, path_first_moves* search, uint32_t source)
+{
+	const grid_dynamic grid(state->grid);
+
+	path_bounds_box* boxes = &state->boxes[(size_t)source * 4];
+	for (uint32_t direction = 0; direction < 4; direction++)
+		boxes[direction] = {UINT16_MAX, UINT16_MAX, 0, 0};
+
+	path_first_moves_search(search, state->grid, source);
+	path_first_moves_visit(search, [&grid, boxes](uint32_t tile, uint8_t moves)
+	{
+		const tile_pos pos = grid.pos(tile);
+		for (; moves; moves &= moves - 1)
+		{
+			path_bounds_box& box = boxes[path_bit_scan(moves)];
+			box.min_x = std::min(box.min_x, (uint16_t)pos.x);
+			box.min_y = std::min(box.min_y, (uint16_t)pos.y);
+			box.max_x = std::max(box.max_x, (uint16_t)pos.x);
+			box.max_y = std::max(box.max_y, (uint16_t)pos.y);
+		}
+	});
+}
+
+static void path_bounds_build_thread(path_bounds_build_state* state)
+{
+	path_first_moves search;
+	path_first_moves_init(&search, state->grid);
+
+	for (;;)
+	{
+		const uint32_t source = state->next_source.fetch_add(1, std::memory_order_relaxed);
+		if (source >= state->source_count)
+			break;
+
+		path_bounds_build_source(state, &search, state->sources[source]);
+	}
+}
+
+void path_bounds_build(path_bounds* bounds, const tile_grid* grid, uint32_t thread_count)
+{
+	alloc_tag("path_bounds");
+
+	assert(grid->width <= UINT16_MAX && grid->height <= UINT16_MAX);
+
+	const size_t tile_count = (size_t)grid->width * grid->height;
+
+	// Walls keep empty boxes, no search starts there
+	bounds->grid = grid;
+	bounds->boxes.assign(tile_count * 4, {UINT16_MAX, UINT16_MAX, 0, 0});
+
+	std::vector<uint32_t> sources;
+	for (uint32_t index = 0; index < tile_count; index++)
+	{
+		if (grid->tiles[index] != tile_flags_wall)
+			sources.push_back(index);
+	}
+
+	path_bounds_build_state state;
+	state.grid = grid;
+	state.sources = sources.data();
+	state.source_count = (uint32_t)sources.size();
+	state.next_source.store(0, std::memory_order_relaxed);
+	state.boxes = bounds->boxes.data();
+
+	std::vector<std::thread> threads;
+	for (uint32_t i = 1; i < thread_count; i++)
+		threads.emplace_back(path_bounds_build_thread, &state);
+	path_bounds_build_thread(&state);
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+void path_bounds_term(path_bounds* bounds)
+{
+	std::vector<path_bounds_box>().swap(bounds->boxes);
+	bounds->grid = nullptr;
+}
+
+bool path_bounds_save(const path_bounds* bounds, const char* filename)
+{
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+		return false;
+
+	path_bounds_header header;
+	header.magic = path_bounds_magic;
+	header.header_size = sizeof(path_bounds_header);
+	header.width = bounds->grid->width;
+	header.height = bounds->grid->height;
+	header.tiles_hash = path_bounds_hash(bounds->grid);
+
+	const bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(bounds->boxes.data(), sizeof(path_bounds_box), bounds->boxes.size(), file) == bounds->boxes.size();
+
+	return fclose(file) == 0 && written;
+}
+
+bool path_bounds_load(path_bounds* bounds, const tile_grid* grid, const char* filename)
+{
+	alloc_tag("path_bounds");
+
+	FILE* file = fopen(filename, "rb");
+	if (!file)
+		return false;
+
+	path_bounds_header header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != path_bounds_magic || header.header_size != sizeof(path_bounds_header) ||
+		header.width != grid->width || header.height != grid->height || header.tiles_hash != path_bounds_hash(grid))
+	{
+		fclose(file);
+		return false;
+	}
+
+	const size_t tile_count = (size_t)grid->width * grid->height;
+	std::vector<path_bounds_box> boxes(tile_count * 4);
+
+	// Anything after the boxes means the file is not what the header says
+	const bool complete = fread(boxes.data(), sizeof(path_bounds_box), boxes.size(), file) == boxes.size() && fgetc(file) == EOF;
+	fclose(file);
+	if (!complete)
+		return false;
+
+	bounds->grid = grid;
+	bounds->boxes.swap(boxes);
+	return true;
+}
+
+size_t path_bounds_size(const path_bounds* bounds)
+{
+	return bounds->boxes.size() * sizeof(path_bounds_box);
+}
\ No newline at end of file
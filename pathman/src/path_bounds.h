@@ -0,0 +1,109 @@
+#include <atomic>
+#include <thread>
+
+/*
+	Goal bounding, pruning moves that cannot start a shortest path to the goal.
+
+	For every tile and each of its open directions this keeps the bounding box of all tiles some
+	shortest path to which starts with that move. A search for a goal outside a move's box can skip
+	the move, as whatever lies that way the goal is reached sooner some other way. That cuts off the
+	dead ends and side branches A* otherwise wanders into wherever the estimate points the wrong way.
+	Each move along a shortest path has the goal inside its box, so a shortest path is never pruned
+	and searches stay optimal. Pruning combines with landmarks and with path_prune.
+
+	Building takes a breadth first search from every walkable tile, the same as path_database, and
+	is meant to be done offline or once per map and cached with path_bounds_save and path_bounds_load.
+	It runs on as many threads as are given, each source writing only its own boxes. Boxes hold
+	uint16 coordinates, 32 bytes per tile, so maps may be at most 65535 tiles each way. The file is
+	the header followed by the boxes, and records a hash of the tile flags so a stale file for an
+	edited map is turned down.
+*/
+constexpr uint32_t path_bounds_magic = 0x31424750;	// "PGB1"
+
+struct path_bounds_box
+{
+	uint16_t min_x;
+	uint16_t min_y;
+	uint16_t max_x;
+	uint16_t max_y;
+};
+
+struct path_bounds_header
+{
+	uint32_t	magic;
+	uint32_t	header_size;
+	int32_t		width;
+	int32_t		height;
+	uint64_t	tiles_hash;
+};
+
+struct path_bounds
+{
+	const tile_grid*				grid;
+	std::vector<path_bounds_box>	boxes;	// Four per tile in tile_direction order, empty boxes have min above max
+};
+
+// Builds the boxes for the map on thread_count threads, including the calling one
+void path_bounds_build(path_bounds* bounds, const tile_grid* grid, uint32_t thread_count);
+void path_bounds_term(path_bounds* bounds);
+
+bool path_bounds_save(const path_bounds* bounds, const char* filename);
+
+// Loads boxes saved for the same tile flags, returning false if the file cannot be read or was built for another map
+bool path_bounds_load(path_bounds* bounds, const tile_grid* grid, const char* filename);
+
+// Bytes held by the boxes, the file adds only the header
+size_t path_bounds_size(const path_bounds* bounds);
+
+// Bit per tile_direction whose box holds the goal
+inline uint8_t path_bounds_moves(const path_bounds* bounds, uint32_t index, tile_pos goal)
+{
+	const path_bounds_box* boxes = &bounds->boxes[(size_t)index * 4];
+
+	uint8_t moves = 0;
+	for (uint32_t direction = 0; direction < 4; direction++)
+	{
+		const path_bounds_box& box = boxes[direction];
+		if (goal.x >= box.min_x && goal.x <= box.max_x && goal.y >= box.min_y && goal.y <= box.max_y)
+			moves |= (uint8_t)(1 << direction);
+	}
+
+	return moves;
+}
+
+/*
+	Grid policy over a row-major grid policy that hides moves whose box does not hold the goal, for
+	path_search and the A* steps. The bounds must have been built for the grid being searched.
+*/
+template<typename Grid>
+struct grid_bounded
+{
+	Grid				grid;
+	const path_bounds*	bounds;
+	tile_pos			goal;
+
+	grid_bounded(const Grid& grid, const path_bounds* bounds, tile_pos goal) : grid(grid), bounds(bounds), goal(goal)
+	{
+	}
+
+	uint32_t index(tile_pos pos) const
+	{
+		return grid.index(pos);
+	}
+
+	tile_pos pos(uint32_t index) const
+	{
+		return grid.pos(index);
+	}
+
+	uint32_t neighbour(uint32_t index, uint32_t direction) const
+	{
+		return grid.neighbour(index, direction);
+	}
+};
+
+template<typename Grid>
+inline uint8_t grid_moves(const grid_bounded<Grid>& grid, uint32_t index)
+{
+	return grid_moves(grid.grid, index) & path_bounds_moves(grid.bounds, index, grid.goal);
+}
\ No newline at end of file
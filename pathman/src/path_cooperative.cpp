@@ -0,0 +1,642 @@
+static const uint64_t path_coop_empty_key = UINT64_MAX;
+static const uint32_t path_coop_closed_bit = 0x80000000;
+
+static uint32_t path_coop_hash(uint64_t key, size_t capacity)
+{
+	// Fibonacci hashing, capacities are always powers of two
+	return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (uint32_t)(capacity - 1);
+}
+
+static uint64_t path_coop_key(uint32_t tile, uint32_t tick)
+{
+	return ((uint64_t)tick << 32) | tile;
+}
+
+/*
+	Reservation table
+*/
+static void path_coop_reservations_insert(path_coop_reservations* r, uint64_t key, uint32_t agent)
+{
+	const size_t mask = r->keys.size() - 1;
+
+	size_t slot = path_coop_hash(key, r->keys.size());
+	while (r->keys[slot] != path_coop_empty_key && r->keys[slot] != key)
+		slot = (slot + 1) & mask;
+
+	if (r->keys[slot] == path_coop_empty_key)
+		r->count++;
+
+	r->keys[slot] = key;
+	r->agents[slot] = agent;
+}
+
+static void path_coop_reservations_grow(path_coop_reservations* r, size_t capacity)
+{
+	std::vector<uint64_t> keys(capacity, path_coop_empty_key);
+	std::vector<uint32_t> agents(capacity);
+	keys.swap(r->keys);
+	agents.swap(r->agents);
+	r->count = 0;
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		if (keys[i] != path_coop_empty_key)
+			path_coop_reservations_insert(r, keys[i], agents[i]);
+	}
+}
+
+static size_t path_coop_reservations_slot(const path_coop_reservations* r, uint64_t key)
+{
+	const size_t mask = r->keys.size() - 1;
+
+	for (size_t slot = path_coop_hash(key, r->keys.size());; slot = (slot + 1) & mask)
+	{
+		if (r->keys[slot] == key || r->keys[slot] == path_coop_empty_key)
+			return slot;
+	}
+}
+
+static uint32_t path_coop_reserved_by(const path_coop_reservations* r, uint32_t tile, uint32_t tick)
+{
+	const uint64_t key = path_coop_key(tile, tick);
+	const size_t slot = path_coop_reservations_slot(r, key);
+
+	return r->keys[slot] == key ? r->agents[slot] : path_coop_no_agent;
+}
+
+static void path_coop_reserve(path_coop_reservations* r, uint32_t tile, uint32_t tick, uint32_t agent)
+{
+	// Kept at most half full so probe runs stay short
+	if ((size_t)(r->count + 1) * 2 > r->keys.size())
+		path_coop_reservations_grow(r, r->keys.size() * 2);
+
+	path_coop_reservations_insert(r, path_coop_key(tile, tick), agent);
+}
+
+// Drops a claim if the agent holds it, closing the gap by backward shift so lookups need no tombstones
+static void path_coop_release(path_coop_reservations* r, uint32_t tile, uint32_t tick, uint32_t agent)
+{
+	const size_t mask = r->keys.size() - 1;
+	const uint64_t key = path_coop_key(tile, tick);
+
+	size_t hole = path_coop_reservations_slot(r, key);
+	if (r->keys[hole] != key || r->agents[hole] != agent)
+		return;
+
+	for (size_t next = (hole + 1) & mask; r->keys[next] != path_coop_empty_key; next = (next + 1) & mask)
+	{
+		// An entry can fill the hole if its home slot is not between the hole and where it sits now
+		const size_t home = path_coop_hash(r->keys[next], r->keys.size());
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			r->keys[hole] = r->keys[next];
+			r->agents[hole] = r->agents[next];
+			hole = next;
+		}
+	}
+
+	r->keys[hole] = path_coop_empty_key;
+	r->count--;
+}
+
+/*
+	Reverse resumable A*
+*/
+static uint32_t path_coop_rra_slot(const path_coop_rra* rra, uint32_t tile)
+{
+	const size_t mask = rra->tiles.size() - 1;
+
+	for (size_t slot = path_coop_hash(tile, rra->tiles.size());; slot = (slot + 1) & mask)
+	{
+		if (rra->tiles[slot] == tile || rra->tiles[slot] == path_coop_unreachable)
+			return (uint32_t)slot;
+	}
+}
+
+static uint32_t path_coop_rra_insert(path_coop_rra* rra, uint32_t tile)
+{
+	if ((size_t)(rra->count + 1) * 2 > rra->tiles.size())
+	{
+		std::vector<uint32_t> tiles(rra->tiles.size() * 2, path_coop_unreachable);
+		std::vector<uint32_t> g(tiles.size());
+		tiles.swap(rra->tiles);
+		g.swap(rra->g);
+
+		for (size_t i = 0; i < tiles.size(); i++)
+		{
+			if (tiles[i] != path_coop_unreachable)
+			{
+				const uint32_t slot = path_coop_rra_slot(rra, tiles[i]);
+				rra->tiles[slot] = tiles[i];
+				rra->g[slot] = g[i];
+			}
+		}
+	}
+
+	const uint32_t slot = path_coop_rra_slot(rra, tile);
+	if (rra->tiles[slot] == path_coop_unreachable)
+	{
+		rra->tiles[slot] = tile;
+		rra->g[slot] = path_coop_unreachable & ~path_coop_closed_bit;
+		rra->count++;
+	}
+
+	return slot;
+}
+
+static void path_coop_rra_reset(path_coop_rra* rra, const grid_dynamic& grid, uint32_t goal, tile_pos origin)
+{
+	// Keep the table's size from the last goal, it is likely to need as much again
+	rra->tiles.assign(std::max(rra->tiles.size(), (size_t)64), path_coop_unreachable);
+	rra->g.resize(rra->tiles.size());
+	rra->count = 0;
+	rra->open.clear();
+	rra->goal = goal;
+	rra->origin = origin;
+
+	rra->g[path_coop_rra_insert(rra, goal)] = 0;
+	path_open_push(&rra->open, manhattan_distance(grid.pos(goal), origin), 0, goal);
+}
+
+// True distance from the tile to the goal, continuing the backward search until the tile is closed
+static uint32_t path_coop_rra_distance(path_coop* coop, path_coop_rra* rra, const grid_dynamic& grid, uint32_t tile)
+{
+	const uint32_t found = path_coop_rra_slot(rra, tile);
+	if (rra->tiles[found] == tile && (rra->g[found] & path_coop_closed_bit))
+		return rra->g[found] & ~path_coop_closed_bit;
+
+	while (!rra->open.empty())
+	{
+		const path_open_entry current = path_open_pop(&rra->open);
+		const uint32_t slot = path_coop_rra_slot(rra, current.index);
+		if (rra->g[slot] != current.g)
+			continue;
+
+		rra->g[slot] |= path_coop_closed_bit;
+		coop->stats.expansions++;
+
+		const tile_pos pos = grid.pos(current.index);
+		const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[current.index]);
+		const uint32_t g = current.g + 1;
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t direction = neighbours.directions[i];
+			const uint32_t index = current.index + grid.offset(direction);
+			const uint32_t next = path_coop_rra_insert(rra, index);
+
+			// Closed tiles already have their final distance, which is never more than g
+			if ((rra->g[next] & ~path_coop_closed_bit) <= g)
+				continue;
+
+			rra->g[next] = g;
+			const tile_pos next_pos = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+			path_open_push(&rra->open, g + manhattan_distance(next_pos, rra->origin), g, index);
+		}
+
+		if (current.index == tile)
+			return current.g;
+	}
+
+	return path_coop_unreachable;
+}
+
+/*
+	Space-time search
+*/
+static uint32_t path_coop_node_slot(const path_coop* coop, uint64_t key)
+{
+	const size_t mask = coop->node_keys.size() - 1;
+
+	for (size_t slot = path_coop_hash(key, coop->node_keys.size());; slot = (slot + 1) & mask)
+	{
+		if (coop->node_stamps[slot] != coop->node_stamp || coop->node_keys[slot] == key)
+			return (uint32_t)slot;
+	}
+}
+
+// Index of the node for (tile, t) in this search, adding an unreached node if there is none
+static uint32_t path_coop_node_at(path_coop* coop, uint32_t tile, uint32_t t)
+{
+	if ((coop->nodes.size() + 1) * 2 > coop->node_keys.size())
+	{
+		const size_t capacity = coop->node_keys.size() * 2;
+		coop->node_keys.assign(capacity, 0);
+		coop->node_stamps.assign(capacity, 0);
+		coop->node_indices.resize(capacity);
+
+		for (uint32_t i = 0; i < coop->nodes.size(); i++)
+		{
+			const uint32_t slot = path_coop_node_slot(coop, path_coop_key(coop->nodes[i].tile, coop->nodes[i].t));
+			coop->node_keys[slot] = path_coop_key(coop->nodes[i].tile, coop->nodes[i].t);
+			coop->node_stamps[slot] = coop->node_stamp;
+			coop->node_indices[slot] = i;
+		}
+	}
+
+	const uint64_t key = path_coop_key(tile, t);
+	const uint32_t slot = path_coop_node_slot(coop, key);
+	if (coop->node_stamps[slot] == coop->node_stamp)
+		return coop->node_indices[slot];
+
+	coop->node_keys[slot] = key;
+	coop->node_stamps[slot] = coop->node_stamp;
+	coop->node_indices[slot] = (uint32_t)coop->nodes.size();
+	coop->nodes.push_back({tile, t, UINT32_MAX, path_coop_no_agent, 0});
+
+	return coop->node_indices[slot];
+}
+
+/*
+	Agents that have had their goal longest go first, so every agent in time has the right of way
+	and gets through however crowded the map is. Agents already on their goal give way to anyone.
+*/
+static bool path_coop_outranks(const path_coop* coop, uint32_t a, uint32_t b)
+{
+	const path_coop_agent* first = &coop->agents[a];
+	const path_coop_agent* second = &coop->agents[b];
+	const bool first_home = first->pos.x == first->goal.x && first->pos.y == first->goal.y;
+	const bool second_home = second->pos.x == second->goal.x && second->pos.y == second->goal.y;
+
+	if (first_home != second_home)
+		return second_home;
+	if (first->goal_tick != second->goal_tick)
+		return first->goal_tick < second->goal_tick;
+	return a < b;
+}
+
+// Whether a claim stops the agent planning through it, claims of lower ranked agents do not
+static bool path_coop_blocks(const path_coop* coop, uint32_t holder, uint32_t agent)
+{
+	return holder != path_coop_no_agent && holder != agent && path_coop_outranks(coop, holder, agent);
+}
+
+/*
+	Queues an agent to replan. Until it does its old plan is no good, as the agent that bumped it
+	has taken some of its claims, so it gives up the rest and waits where it is, claiming its tile
+	wherever no other agent holds it.
+*/
+static void path_coop_bump(path_coop* coop, uint32_t agent_index)
+{
+	path_coop_agent* agent = &coop->agents[agent_index];
+	if (agent->bumped)
+		return;
+
+	agent->bumped = true;
+	agent->replan_tick = coop->tick;
+	coop->bumped.push_back(agent_index);
+	coop->stats.bumps++;
+
+	const uint32_t tick = coop->tick;
+	const uint32_t current = grid_dynamic(coop->grid).index(agent->pos);
+	for (uint32_t i = tick - agent->plan_tick; i < agent->plan.size(); i++)
+		path_coop_release(&coop->reservations, agent->plan[i], agent->plan_tick + i, agent_index);
+
+	agent->plan.assign(agent->plan.size(), current);
+	agent->plan_tick = tick;
+
+	for (uint32_t i = 0; i < agent->plan.size(); i++)
+	{
+		if (path_coop_reserved_by(&coop->reservations, current, tick + i) == path_coop_no_agent)
+			path_coop_reserve(&coop->reservations, current, tick + i, agent_index);
+	}
+}
+
+/*
+	A* over (tile, ticks from now) states where each tick an agent either moves to a neighbour or
+	waits. States claimed by higher ranked agents are skipped, as are moves that swap tiles with
+	one. Every action costs one tick except waiting on the goal, which is free so an agent that
+	arrives early stays there. The search ends at the first state expanded at the end of the
+	window whose tile is also free for the replan interval after it, as the plan then holds that
+	tile until the agent's next plan is due.
+
+	Claims of lower ranked agents are ignored and taken over, and those agents are bumped to
+	replan straight away around the new plan. Without this two agents meeting head on in a
+	corridor would each wait for the other forever. As ranks never form a cycle the replans this
+	sets off always end.
+
+	If the search fails, because higher ranked agents box the agent in for the whole window, it
+	follows the deepest partial plan found and tries again next tick.
+*/
+static bool path_coop_tail_free(const path_coop* coop, uint32_t agent_index, uint32_t tile, uint32_t first_tick)
+{
+	for (uint32_t i = 0; i < coop->config.replan_interval; i++)
+	{
+		if (path_coop_blocks(coop, path_coop_reserved_by(&coop->reservations, tile, first_tick + i), agent_index))
+			return false;
+	}
+
+	return true;
+}
+
+static void path_coop_replan(path_coop* coop, uint32_t agent_index)
+{
+	path_coop_agent* agent = &coop->agents[agent_index];
+	path_coop_reservations* reservations = &coop->reservations;
+	const grid_dynamic grid(coop->grid);
+	const uint32_t window = coop->config.window;
+	const uint32_t tick = coop->tick;
+	const uint32_t start = grid.index(agent->pos);
+	const uint32_t goal = grid.index(agent->goal);
+
+	// The old plan's claims from now on are replaced by the new plan's
+	for (uint32_t i = tick - agent->plan_tick; i < agent->plan.size(); i++)
+		path_coop_release(reservations, agent->plan[i], agent->plan_tick + i, agent_index);
+
+	if (++coop->node_stamp == 0)
+	{
+		std::fill(coop->node_stamps.begin(), coop->node_stamps.end(), 0);
+		coop->node_stamp = 1;
+	}
+	coop->nodes.clear();
+	coop->open.clear();
+
+	const uint32_t root = path_coop_node_at(coop, start, 0);
+	coop->nodes[root].g = 0;
+	path_open_push(&coop->open, path_coop_rra_distance(coop, &agent->rra, grid, start), 0, root);
+
+	uint32_t last = root;
+	bool complete = false;
+	while (!coop->open.empty())
+	{
+		const path_open_entry current = path_open_pop(&coop->open);
+		const path_coop_node node = coop->nodes[current.index];
+		if (node.closed || node.g != current.g)
+			continue;
+
+		coop->nodes[current.index].closed = 1;
+		coop->stats.expansions++;
+
+		// Entries come off in f order, so the first reaching each depth is the best partial plan
+		if (node.t > coop->nodes[last].t)
+			last = current.index;
+
+		if (node.t == window)
+		{
+			if (path_coop_tail_free(coop, agent_index, node.tile, tick + window + 1))
+			{
+				last = current.index;
+				complete = true;
+				break;
+			}
+			continue;
+		}
+
+		const uint32_t next_tick = tick + node.t + 1;
+		const uint32_t swap_agent = path_coop_reserved_by(reservations, node.tile, next_tick);
+		const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[node.tile]);
+
+		// Entry count is the wait plus each open side
+		for (uint32_t i = 0; i <= neighbours.count; i++)
+		{
+			const uint32_t next_tile = i < neighbours.count ? node.tile + grid.offset(neighbours.directions[i]) : node.tile;
+
+			if (path_coop_blocks(coop, path_coop_reserved_by(reservations, next_tile, next_tick), agent_index))
+				continue;
+
+			if (next_tile != node.tile && path_coop_blocks(coop, swap_agent, agent_index) &&
+				path_coop_reserved_by(reservations, next_tile, next_tick - 1) == swap_agent)
+				continue;
+
+			const uint32_t h = path_coop_rra_distance(coop, &agent->rra, grid, next_tile);
+			if (h == path_coop_unreachable)
+				continue;
+
+			const uint32_t g = node.g + (next_tile == node.tile && next_tile == goal ? 0 : 1);
+			const uint32_t next = path_coop_node_at(coop, next_tile, node.t + 1);
+			path_coop_node* next_node = &coop->nodes[next];
+			if (next_node->closed || next_node->g <= g)
+				continue;
+
+			next_node->g = g;
+			next_node->parent = current.index;
+			path_open_push(&coop->open, g + h, g, next);
+		}
+	}
+
+	// The last tile reached is held for the rest of the plan
+	agent->plan.assign(window + coop->config.replan_interval + 1, coop->nodes[last].tile);
+	agent->plan_tick = tick;
+	agent->replan_tick = tick + (complete ? coop->config.replan_interval : 1);
+	coop->stats.replans++;
+	coop->stats.failed += !complete;
+
+	for (uint32_t index = last; index != path_coop_no_agent; index = coop->nodes[index].parent)
+		agent->plan[coop->nodes[index].t] = coop->nodes[index].tile;
+
+	// Lower ranked agents that would swap tiles with this one have to move aside
+	for (uint32_t i = 0; i + 1 < agent->plan.size(); i++)
+	{
+		if (agent->plan[i] == agent->plan[i + 1])
+			continue;
+
+		const uint32_t other = path_coop_reserved_by(reservations, agent->plan[i], tick + i + 1);
+		if (other != path_coop_no_agent && other != agent_index && path_coop_reserved_by(reservations, agent->plan[i + 1], tick + i) == other)
+			path_coop_bump(coop, other);
+	}
+
+	// A partial plan can only claim the part of its tail higher ranked agents have left free
+	for (uint32_t i = 0; i < agent->plan.size(); i++)
+	{
+		const uint32_t holder = path_coop_reserved_by(reservations, agent->plan[i], tick + i);
+		if (path_coop_blocks(coop, holder, agent_index))
+			continue;
+
+		if (holder != path_coop_no_agent && holder != agent_index)
+			path_coop_bump(coop, holder);
+		path_coop_reserve(reservations, agent->plan[i], tick + i, agent_index);
+	}
+}
+
+void path_coop_init(path_coop* coop, const tile_grid* grid, uint32_t agent_count, const path_coop_config* config)
+{
+	alloc_tag("path_coop");
+
+	assert(config->window > 0 && config->replan_interval > 0 && config->replan_interval <= config->window);
+
+	coop->grid = grid;
+	coop->config = *config;
+	coop->tick = 0;
+	coop->cursor = 0;
+	coop->agents.clear();
+	coop->agents.resize(agent_count);
+	coop->stats = {};
+
+	// Every agent claims window + replan_interval + 1 states, start with room for that at half load
+	size_t capacity = 1024;
+	while (capacity < (size_t)agent_count * (config->window + config->replan_interval + 1) * 2)
+		capacity *= 2;
+	coop->reservations.keys.assign(capacity, path_coop_empty_key);
+	coop->reservations.agents.assign(capacity, path_coop_no_agent);
+	coop->reservations.count = 0;
+
+	coop->nodes.clear();
+	coop->node_keys.assign(1024, 0);
+	coop->node_stamps.assign(1024, 0);
+	coop->node_indices.assign(1024, 0);
+	coop->node_stamp = 0;
+	coop->open.clear();
+	coop->bumped.clear();
+}
+
+void path_coop_term(path_coop* coop)
+{
+	std::vector<path_coop_agent>().swap(coop->agents);
+	std::vector<uint64_t>().swap(coop->reservations.keys);
+	std::vector<uint32_t>().swap(coop->reservations.agents);
+	std::vector<path_coop_node>().swap(coop->nodes);
+	std::vector<uint64_t>().swap(coop->node_keys);
+	std::vector<uint32_t>().swap(coop->node_stamps);
+	std::vector<uint32_t>().swap(coop->node_indices);
+	std::vector<path_open_entry>().swap(coop->open);
+	std::vector<uint32_t>().swap(coop->bumped);
+}
+
+void path_coop_place(path_coop* coop, uint32_t agent_index, tile_pos start, tile_pos goal)
+{
+	alloc_tag("path_coop");
+
+	path_coop_agent* agent = &coop->agents[agent_index];
+	const grid_dynamic grid(coop->grid);
+	const uint32_t start_index = grid.index(start);
+
+	assert(tile_grid_get(coop->grid, start.x, start.y) != tile_flags_wall);
+	assert(tile_grid_get(coop->grid, goal.x, goal.y) != tile_flags_wall);
+
+	agent->pos = start;
+	agent->goal = goal;
+	agent->plan.assign(coop->config.window + coop->config.replan_interval + 1, start_index);
+	agent->plan_tick = coop->tick;
+	agent->replan_tick = coop->tick + (agent_index % coop->config.replan_interval);
+	agent->goal_tick = coop->tick;
+	agent->bumped = false;
+	path_coop_rra_reset(&agent->rra, grid, grid.index(goal), start);
+
+	for (uint32_t i = 0; i < agent->plan.size(); i++)
+		path_coop_reserve(&coop->reservations, start_index, coop->tick + i, agent_index);
+}
+
+void path_coop_set_goal(path_coop* coop, uint32_t agent_index, tile_pos goal)
+{
+	path_coop_agent* agent = &coop->agents[agent_index];
+	const grid_dynamic grid(coop->grid);
+
+	assert(tile_grid_get(coop->grid, goal.x, goal.y) != tile_flags_wall);
+
+	agent->goal = goal;
+	agent->replan_tick = coop->tick;
+	agent->goal_tick = coop->tick;
+	path_coop_rra_reset(&agent->rra, grid, grid.index(goal), agent->pos);
+}
+
+void path_coop_tick(path_coop* coop)
+{
+	alloc_tag("path_coop");
+
+	const grid_dynamic grid(coop->grid);
+	const uint32_t count = (uint32_t)coop->agents.size();
+	const uint64_t expansions_before = coop->stats.expansions;
+	const uint32_t tick = coop->tick;
+
+	/*
+		Bumped agents go first as their old plans cross a newer one, then due agents round robin
+		from where the last tick's budget ran out. Bumped agents left over stay queued for next tick.
+	*/
+	uint32_t replans = 0;
+	uint32_t n = 0;
+	while (replans < coop->config.max_replans && coop->stats.expansions - expansions_before < coop->config.max_expansions)
+	{
+		if (!coop->bumped.empty())
+		{
+			const uint32_t bumped = coop->bumped.back();
+			coop->bumped.pop_back();
+			coop->agents[bumped].bumped = false;
+
+			path_coop_replan(coop, bumped);
+			replans++;
+			continue;
+		}
+
+		while (n < count && (coop->agents[(coop->cursor + n) % count].replan_tick > tick || coop->agents[(coop->cursor + n) % count].bumped))
+			n++;
+		if (n == count)
+			break;
+
+		path_coop_replan(coop, (coop->cursor + n) % count);
+		replans++;
+		n++;
+	}
+
+	coop->stats.deferred += coop->bumped.size();
+	for (uint32_t i = n; i < count; i++)
+		coop->stats.deferred += coop->agents[(coop->cursor + i) % count].replan_tick <= tick && !coop->agents[(coop->cursor + i) % count].bumped;
+	coop->cursor = (coop->cursor + n) % count;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		path_coop_agent* agent = &coop->agents[i];
+		const uint32_t current = grid.index(agent->pos);
+		const uint32_t step = tick + 1 - agent->plan_tick;
+		path_coop_release(&coop->reservations, agent->plan[step - 1], tick, i);
+		const uint32_t next = agent->plan[step];
+
+		if (next != current)
+			coop->stats.moves++;
+		else
+			coop->stats.waits++;
+
+		agent->pos = grid.pos(next);
+
+		/*
+			An agent due a replan the budget has put off keeps its plan's last tile claimed as far
+			ahead as a full plan would, so every other agent planning meanwhile sees it there
+		*/
+		if (agent->replan_tick <= tick + 1)
+		{
+			const uint32_t last = agent->plan.back();
+			std::rotate(agent->plan.begin(), agent->plan.begin() + step, agent->plan.end());
+			std::fill(agent->plan.end() - step, agent->plan.end(), last);
+
+			for (uint32_t j = agent->plan_tick + (uint32_t)agent->plan.size(); j < tick + 1 + agent->plan.size(); j++)
+			{
+				if (path_coop_reserved_by(&coop->reservations, last, j) == path_coop_no_agent)
+					path_coop_reserve(&coop->reservations, last, j, i);
+			}
+			agent->plan_tick = tick + 1;
+		}
+	}
+
+	coop->tick++;
+}
+
+uint32_t path_coop_count_conflicts(const tile_grid* grid, const tile_pos* before, const tile_pos* after, uint32_t count, std::vector<uint32_t>* scratch)
+{
+	const grid_dynamic tiles(grid);
+	uint32_t conflicts = 0;
+
+	// Which agent ended up on each tile, extra agents on a tile are vertex conflicts
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t* occupant = &(*scratch)[tiles.index(after[i])];
+		if (*occupant != path_coop_no_agent)
+			conflicts++;
+		else
+			*occupant = i;
+	}
+
+	// Agent i moved from a to b and the agent now on a came from b, counted once per pair
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (before[i].x == after[i].x && before[i].y == after[i].y)
+			continue;
+
+		const uint32_t other = (*scratch)[tiles.index(before[i])];
+		if (other != path_coop_no_agent && other > i && before[other].x == after[i].x && before[other].y == after[i].y)
+			conflicts++;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+		(*scratch)[tiles.index(after[i])] = path_coop_no_agent;
+
+	return conflicts;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+	Cooperative pathfinding for many agents sharing a map, using windowed hierarchical cooperative
+	A* (WHCA*).
+
+	Agents plan one at a time through space and time, each avoiding every tile and move claimed by
+	agents ranked above it and taking over the claims of agents ranked below, which then replan.
+	Claims are held in a reservation table keyed on (tile, tick). A plan only searches the next
+	window ticks, which keeps it cheap, and each agent replans every replan_interval ticks, before
+	its plan runs out. Replans are staggered so only a fraction of the agents are due on any tick,
+	and path_coop_tick stops starting replans once the tick's replan or expansion budget is spent,
+	deferring the rest to the next tick, so the cost of a tick stays bounded however many agents
+	there are. An agent whose replan is put off keeps claiming the end of its plan as far ahead as
+	a new plan would reach, and one bumped by a higher ranked agent waits where it is until it
+	has replanned.
+
+	Inside the window the search is guided by the agent's true distance to its goal ignoring other
+	agents. This comes from a reverse resumable A* (RRA*) that searches back from the goal and is
+	only continued as far as the distances asked for need. It is kept until the goal changes so
+	later replans mostly reuse its work.
+*/
+constexpr uint32_t path_coop_no_agent = UINT32_MAX;
+constexpr uint32_t path_coop_unreachable = UINT32_MAX;
+
+// Open addressing hash of (tile, tick) to the agent holding it
+struct path_coop_reservations
+{
+	std::vector<uint64_t>	keys;		// Tick in the high half, tile index in the low half
+	std::vector<uint32_t>	agents;
+	uint32_t				count;
+};
+
+// Reverse resumable A* from an agent's goal, giving true distances to the goal on demand
+struct path_coop_rra
+{
+	uint32_t						goal;
+	tile_pos						origin;		// Where the agent was when the search began, steers the search
+	std::vector<uint32_t>			tiles;		// Open addressing table of reached tiles, path_coop_unreachable when empty
+	std::vector<uint32_t>			g;			// Distance to the goal for each table entry, top bit set once closed
+	uint32_t						count;
+	std::vector<path_open_entry>	open;
+};
+
+struct path_coop_agent
+{
+	tile_pos				pos;
+	tile_pos				goal;
+	std::vector<uint32_t>	plan;			// Tile for each tick from plan_tick, window + replan_interval + 1 entries
+	uint32_t				plan_tick;
+	uint32_t				replan_tick;	// Tick from which the agent is due a new plan
+	uint32_t				goal_tick;		// Tick the goal was set, agents with older goals rank higher
+	bool					bumped;			// Queued to replan because a higher ranked agent took its claims, waits until it does
+	path_coop_rra			rra;
+};
+
+struct path_coop_config
+{
+	uint32_t window;			// Ticks each plan looks ahead
+	uint32_t replan_interval;	// Ticks between an agent's replans, at most window
+	uint32_t max_replans;		// Replans per tick
+	uint32_t max_expansions;	// Space-time and RRA* expansions per tick, a replan already started is finished
+};
+
+struct path_coop_stats
+{
+	uint64_t replans;
+	uint64_t deferred;		// Agents due a replan left for a later tick by the budget
+	uint64_t failed;		// Replans that found no complete plan and fell back to a partial one
+	uint64_t bumps;			// Replans forced by a higher ranked agent's plan
+	uint64_t expansions;
+	uint64_t moves;
+	uint64_t waits;
+};
+
+struct path_coop_node
+{
+	uint32_t tile;
+	uint32_t t;				// Ticks after the start of the plan
+	uint32_t g;
+	uint32_t parent;		// Node index, path_coop_no_agent for the root
+	uint32_t closed;
+};
+
+struct path_coop
+{
+	const tile_grid*				grid;
+	path_coop_config				config;
+	uint32_t						tick;
+	uint32_t						cursor;			// Agent the next tick's replans start from
+	std::vector<path_coop_agent>	agents;
+	path_coop_reservations			reservations;
+	path_coop_stats					stats;			// Totals since init
+
+	// Space-time search scratch, reused by every replan
+	std::vector<path_coop_node>		nodes;
+	std::vector<uint64_t>			node_keys;		// Open addressing table of (tile, t) to node, valid where the stamp matches
+	std::vector<uint32_t>			node_stamps;
+	std::vector<uint32_t>			node_indices;
+	uint32_t						node_stamp;
+	std::vector<path_open_entry>	open;
+	std::vector<uint32_t>			bumped;			// Agents waiting to replan after being bumped
+};
+
+void path_coop_init(path_coop* coop, const tile_grid* grid, uint32_t agent_count, const path_coop_config* config);
+void path_coop_term(path_coop* coop);
+
+/*
+	Puts an agent on the map at start, holding its tile until its first plan. First plans are
+	staggered over replan_interval ticks by agent index. Starts must be distinct open tiles.
+*/
+void path_coop_place(path_coop* coop, uint32_t agent, tile_pos start, tile_pos goal);
+
+// Gives an agent a new goal and makes it due to replan straight away
+void path_coop_set_goal(path_coop* coop, uint32_t agent, tile_pos goal);
+
+// Replans the agents due within the budget, then moves every agent one step along its plan
+void path_coop_tick(path_coop* coop);
+
+/*
+	Counts collisions between two consecutive sets of agent positions: two agents on the same tile
+	after the step, or two agents swapping tiles. Scratch is sized to the map and must hold
+	path_coop_no_agent everywhere, which it does again on return.
+*/
+uint32_t path_coop_count_conflicts(const tile_grid* grid, const tile_pos* before, const tile_pos* after, uint32_t count, std::vector<uint32_t>* scratch);
\ No newline at end of file
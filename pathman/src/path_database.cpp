@@ -0,0 +1,386 @@
+// Position of a cell along a Hilbert curve filling an n x n square, n a power of two
+static uint64_t path_database_hilbert(uint32_t n, uint32_t x, uint32_t y)
+{
+	uint64_t d = 0;
+	for (uint32_t s = n / 2; s > 0; s /= 2)
+	{
+		const uint32_t rx = (x & s) ? 1 : 0;
+		const uint32_t ry = (y & s) ? 1 : 0;
+		d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+		// Rotate the quadrant so the curve inside it runs the right way
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				x = n - 1 - x;
+				y = n - 1 - y;
+			}
+			std::swap(x, y);
+		}
+	}
+
+	return d;
+}
+
+struct path_database_build_state
+{
+	const tile_grid*					grid;
+	const uint32_t*						order;			// Tile of each rank
+	const uint32_t*						ranks;			// Rank of each tile
+	uint32_t							open_count;
+	std::atomic<uint32_t>				next_source;
+	std::vector<std::vector<uint32_t>>	source_runs;
+};
+
+/*
+	Gathers the first moves from one source in rank order, then walks the targets, each run keeping
+	the moves common to all its targets until none are left. The source itself and unreachable
+	tiles accept any move.
+*/
+static void path_database_build_source(path_database_build_state* state, path_first_moves* search, std::vector<uint8_t>* rank_moves, uint32_t source_rank, std::vector<uint32_t>* runs)
+{
+	const uint32_t* ranks = state->ranks;
+
+	rank_moves->assign(state->open_count, 0xF);
+	path_first_moves_search(search, state->grid, state->order[source_rank]);
+	path_first_moves_visit(search, [ranks, rank_moves](uint32_t tile, uint8_t moves) { (*rank_moves)[ranks[tile]] = moves; });
+
+	uint32_t run_start = 0;
+	uint8_t common = 0xF;
+	for (uint32_t rank = 0; rank < state->open_count; rank++)
+	{
+		const uint8_t moves = (*rank_moves)[rank];
+		if (!(common & moves))
+		{
+			runs->push_back((run_start << 2) | path_bit_scan(common));
+			run_start = rank;
+			common = 0xF;
+		}
+		common &= moves;
+	}
+	runs->push_back((run_start << 2) | path_bit_scan(common));
+}
+
+static void path_database_build_thread(path_database_build_state* state)
+{
+	path_first_moves search;
+	path_first_moves_init(&search, state->grid);
+	std::vector<uint8_t> rank_moves;
+
+	for (;;)
+	{
+		const uint32_t source = state->next_source.fetch_add(1, std::memory_order_relaxed);
+		if (source >= state->open_count)
+			break;
+
+		path_database_build_source(state, &search, &rank_moves, source, &state->source_runs[source]);
+	}
+}
+
+/*
+	Points the section pointers into an image laid out as described in path_database.h, after
+	checking that queries cannot read outside it: every rank names a source, each source's runs
+	lie inside the run array, and its runs start at rank zero and climb through valid ranks.
+*/
+static bool path_database_attach(path_database* db, const void* image, size_t size)
+{
+	const path_database_header* header = (const path_database_header*)image;
+	if (size < sizeof(path_database_header) || header->magic != path_database_magic || header->header_size != sizeof(path_database_header) ||
+		header->width <= 0 || header->height <= 0)
+		return false;
+
+	const size_t tile_count = (size_t)header->width * header->height;
+	const size_t words = (tile_count * 2) + header->open_count + 1 + header->run_count;
+	if (header->open_count > tile_count || header->run_count < header->open_count || size != sizeof(path_database_header) + (words * sizeof(uint32_t)))
+		return false;
+
+	const uint32_t* ranks = (const uint32_t*)(header + 1);
+	const uint32_t* components = ranks + tile_count;
+	const uint32_t* offsets = components + tile_count;
+	const uint32_t* runs = offsets + header->open_count + 1;
+
+	for (size_t i = 0; i < tile_count; i++)
+	{
+		if (ranks[i] != path_database_none && ranks[i] >= header->open_count)
+			return false;
+	}
+
+	if (offsets[0] != 0 || offsets[header->open_count] != header->run_count)
+		return false;
+
+	for (uint32_t source = 0; source < header->open_count; source++)
+	{
+		if (offsets[source] >= offsets[source + 1] || offsets[source + 1] > header->run_count || (runs[offsets[source]] >> 2) != 0)
+			return false;
+
+		for (uint32_t run = offsets[source] + 1; run < offsets[source + 1]; run++)
+		{
+			if ((runs[run] >> 2) <= (runs[run - 1] >> 2) || (runs[run] >> 2) >= header->open_count)
+				return false;
+		}
+	}
+
+	db->width = header->width;
+	db->height = header->height;
+	db->open_count = header->open_count;
+	db->run_count = header->run_count;
+	db->ranks = ranks;
+	db->components = components;
+	db->offsets = offsets;
+	db->runs = runs;
+
+	return true;
+}
+
+void path_database_build(path_database* db, const tile_grid* grid, uint32_t thread_count)
+{
+	alloc_tag("path_database");
+
+	const grid_dynamic tiles(grid);
+	const size_t tile_count = (size_t)grid->width * grid->height;
+
+	// Rank the walkable tiles along a Hilbert curve over the smallest power of two square holding the map
+	uint32_t n = 1;
+	while (n < (uint32_t)std::max(grid->width, grid->height))
+		n *= 2;
+
+	std::vector<std::pair<uint64_t, uint32_t>> curve;
+	for (uint32_t index = 0; index < tile_count; index++)
+	{
+		if (grid->tiles[index] != tile_flags_wall)
+		{
+			const tile_pos pos = tiles.pos(index);
+			curve.push_back({path_database_hilbert(n, (uint32_t)pos.x, (uint32_t)pos.y), index});
+		}
+	}
+	std::sort(curve.begin(), curve.end());
+
+	// Runs keep the rank in 30 bits
+	assert(curve.size() < (1u << 30));
+
+	std::vector<uint32_t> order(curve.size());
+	std::vector<uint32_t> tile_ranks(tile_count, path_database_none);
+	for (uint32_t rank = 0; rank < curve.size(); rank++)
+	{
+		order[rank] = curve[rank].second;
+		tile_ranks[order[rank]] = rank;
+	}
+
+	path_database_build_state state;
+	state.grid = grid;
+	state.order = order.data();
+	state.ranks = tile_ranks.data();
+	state.open_count = (uint32_t)order.size();
+	state.next_source.store(0, std::memory_order_relaxed);
+	state.source_runs.resize(order.size());
+
+	std::vector<std::thread> threads;
+	for (uint32_t i = 1; i < thread_count; i++)
+		threads.emplace_back(path_database_build_thread, &state);
+	path_database_build_thread(&state);
+	for (std::thread& thread : threads)
+		thread.join();
+
+	size_t run_count = 0;
+	for (const std::vector<uint32_t>& runs : state.source_runs)
+		run_count += runs.size();
+
+	const size_t words = (tile_count * 2) + order.size() + 1 + run_count;
+	db->storage.assign((sizeof(path_database_header) / sizeof(uint32_t)) + words, 0);
+	db->mapping = nullptr;
+	db->mapping_size = 0;
+
+	path_database_header* header = (path_database_header*)db->storage.data();
+	header->magic = path_database_magic;
+	header->header_size = sizeof(path_database_header);
+	header->width = grid->width;
+	header->height = grid->height;
+	header->open_count = (uint32_t)order.size();
+	header->run_count = (uint32_t)run_count;
+
+	uint32_t* ranks = (uint32_t*)(header + 1);
+	uint32_t* components = ranks + tile_count;
+	uint32_t* offsets = components + tile_count;
+	uint32_t* runs = offsets + order.size() + 1;
+
+	memcpy(ranks, tile_ranks.data(), tile_count * sizeof(uint32_t));
+	std::fill(components, components + tile_count, path_database_none);
+
+	// Label connected components so queries can turn down unreachable goals without a lookup
+	uint32_t component_count = 0;
+	std::vector<uint32_t> queue;
+	for (uint32_t start : order)
+	{
+		if (components[start] != path_database_none)
+			continue;
+
+		components[start] = component_count;
+		queue.assign(1, start);
+		for (size_t head = 0; head < queue.size(); head++)
+		{
+			const tile_neighbours& neighbours = tile_neighbours_of(grid->tiles[queue[head]]);
+			for (uint32_t i = 0; i < neighbours.count; i++)
+			{
+				const uint32_t index = queue[head] + tiles.offset(neighbours.directions[i]);
+				if (components[index] == path_database_none)
+				{
+					components[index] = component_count;
+					queue.push_back(index);
+				}
+			}
+		}
+		component_count++;
+	}
+
+	size_t offset = 0;
+	for (uint32_t rank = 0; rank < order.size(); rank++)
+	{
+		offsets[rank] = (uint32_t)offset;
+		memcpy(runs + offset, state.source_runs[rank].data(), state.source_runs[rank].size() * sizeof(uint32_t));
+		offset += state.source_runs[rank].size();
+	}
+	offsets[order.size()] = (uint32_t)offset;
+
+	path_database_attach(db, db->storage.data(), db->storage.size() * sizeof(uint32_t));
+}
+
+size_t path_database_size(const path_database* db)
+{
+	return sizeof(path_database_header) + ((((size_t)db->width * db->height * 2) + db->open_count + 1 + db->run_count) * sizeof(uint32_t));
+}
+
+bool path_database_save(const path_database* db, const char* filename)
+{
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+		return false;
+
+	// The sections follow the header in one block, as built or mapped
+	const void* image = (const path_database_header*)db->ranks - 1;
+	const bool written = fwrite(image, 1, path_database_size(db), file) == path_database_size(db);
+
+	return (fclose(file) == 0) && written;
+}
+
+bool path_database_open(path_database* db, const char* filename)
+{
+	db->storage.clear();
+	db->mapping = nullptr;
+	db->mapping_size = 0;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = GetFileSizeEx(file, &size) ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+
+	// The view keeps the mapping alive on its own
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view)
+		return false;
+
+	db->mapping = view;
+	db->mapping_size = (size_t)size.QuadPart;
+#else
+	const int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	void* view = fstat(fd, &info) == 0 && info.st_size > 0 ? mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (view == MAP_FAILED)
+		return false;
+
+	db->mapping = view;
+	db->mapping_size = (size_t)info.st_size;
+#endif
+
+	if (!path_database_attach(db, db->mapping, db->mapping_size))
+	{
+		path_database_close(db);
+		return false;
+	}
+
+	return true;
+}
+
+void path_database_close(path_database* db)
+{
+	if (db->mapping)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(db->mapping);
+#else
+		munmap(db->mapping, db->mapping_size);
+#endif
+	}
+
+	db->mapping = nullptr;
+	db->mapping_size = 0;
+	std::vector<uint32_t>().swap(db->storage);
+	db->ranks = db->components = db->offsets = db->runs = nullptr;
+}
+
+// Tile index of a walkable tile, path_database_none for walls and tiles off the map
+static uint32_t path_database_tile(const path_database* db, tile_pos pos)
+{
+	if (pos.x < 0 || pos.x >= db->width || pos.y < 0 || pos.y >= db->height)
+		return path_database_none;
+
+	const uint32_t index = (uint32_t)((pos.y * db->width) + pos.x);
+	return db->ranks[index] != path_database_none ? index : path_database_none;
+}
+
+uint32_t path_database_first_move(const path_database* db, tile_pos start, tile_pos goal)
+{
+	const uint32_t start_index = path_database_tile(db, start);
+	const uint32_t goal_index = path_database_tile(db, goal);
+	if (start_index == path_database_none || goal_index == path_database_none || start_index == goal_index ||
+		db->components[start_index] != db->components[goal_index])
+		return path_database_none;
+
+	// Last run starting at or before the target, runs hold their start rank above the move
+	const uint32_t source = db->ranks[start_index];
+	const uint32_t target = db->ranks[goal_index];
+	const uint32_t* first = db->runs + db->offsets[source];
+	const uint32_t* last = db->runs + db->offsets[source + 1];
+	const uint32_t* run = std::upper_bound(first, last, (target << 2) | 3) - 1;
+
+	return *run & 3;
+}
+
+bool path_database_path(const path_database* db, tile_pos start, tile_pos goal, std::vector<tile_pos>* path)
+{
+	path->clear();
+
+	const uint32_t start_index = path_database_tile(db, start);
+	const uint32_t goal_index = path_database_tile(db, goal);
+	if (start_index == path_database_none || goal_index == path_database_none || db->components[start_index] != db->components[goal_index])
+		return false;
+
+	// A shortest path visits each open tile at most once, so a corrupt image whose moves step into
+	// a wall, off the map or round a loop is caught rather than followed
+	path->push_back(start);
+	for (tile_pos pos = start; pos.x != goal.x || pos.y != goal.y;)
+	{
+		const uint32_t direction = path_database_first_move(db, pos, goal);
+		if (direction == path_database_none || path->size() == db->open_count)
+		{
+			path->clear();
+			return false;
+		}
+
+		pos = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+		path->push_back(pos);
+	}
+
+	return true;
+}
\ No newline at end of file
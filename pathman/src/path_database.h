@@ -0,0 +1,89 @@
+#include <atomic>
+#include <thread>
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+/*
+	Compressed path database (CPD) giving the first move of a shortest path between any two tiles
+	without searching.
+
+	For every source tile a breadth first search finds which moves start a shortest path to each
+	target. Targets are laid out along a Hilbert curve over the map, so nearby targets, which
+	mostly share a first move, sit next to each other, and each source's moves are stored as runs
+	of targets sharing a move. Where several moves are optimal the run is extended with whichever
+	keeps it going longest. A query binary searches the source's runs for the target's rank, and
+	a full path is read off one first move at a time.
+
+	Building takes one search per walkable tile and is meant to be done offline, on as many
+	threads as are available. The result is a flat image that can be saved and later mapped
+	straight from the file:
+
+		header		path_database_header
+		ranks		uint32 per tile, the target's position on the curve, path_database_none for walls
+		components	uint32 per tile, tiles with the same value can reach each other
+		offsets		uint32 per walkable tile in rank order plus one, first run of each source
+		runs		uint32 per run, first target rank above the tile_direction in the low 2 bits
+*/
+constexpr uint32_t path_database_none = UINT32_MAX;
+constexpr uint32_t path_database_magic = 0x31424450;	// "PDB1"
+
+struct path_database_header
+{
+	uint32_t	magic;
+	uint32_t	header_size;
+	int32_t		width;
+	int32_t		height;
+	uint32_t	open_count;
+	uint32_t	run_count;
+};
+
+struct path_database
+{
+	int32_t					width;
+	int32_t					height;
+	uint32_t				open_count;
+	uint32_t				run_count;
+	const uint32_t*			ranks;
+	const uint32_t*			components;
+	const uint32_t*			offsets;
+	const uint32_t*			runs;
+
+	// The image is either built in storage or mapped from a file
+	std::vector<uint32_t>	storage;
+	void*					mapping;
+	size_t					mapping_size;
+};
+
+// Builds the database for the map on thread_count threads, including the calling one
+void path_database_build(path_database* db, const tile_grid* grid, uint32_t thread_count);
+
+bool path_database_save(const path_database* db, const char* filename);
+
+/*
+	Maps a saved database from the file, returning false if it cannot be read or is not a
+	database. Every section is checked on opening, so a truncated or corrupt file is turned down
+	rather than read out of bounds by later queries. Moves are not checked against the map, a
+	corrupt one makes path_database_path return false.
+*/
+bool path_database_open(path_database* db, const char* filename);
+void path_database_close(path_database* db);
+
+// Bytes in the database image, the same as its file size
+size_t path_database_size(const path_database* db);
+
+/*
+	tile_direction of the first move of a shortest path from start to goal, or path_database_none
+	if start is the goal or the goal cannot be reached.
+*/
+uint32_t path_database_first_move(const path_database* db, tile_pos start, tile_pos goal);
+
+/*
+	Follows first moves from start to goal, giving the same kind of path as path_find. Returns false
+	with an empty path if the goal cannot be reached or a move leads off the open tiles.
+*/
+bool path_database_path(const path_database* db, tile_pos start, tile_pos goal, std::vector<tile_pos>* path);
\ No newline at end of file
@@ -0,0 +1,591 @@
+static void path_finder_begin_search(path_finder* pf)
+{
+	// Search ids wrap after ~4 billion queries, when they do every tile has to be reset once
+	if (++pf->search == 0)
+	{
+		for (path_node* nodes : pf->nodes)
+		{
+			if (nodes)
+				memset(nodes, 0, (size_t)pf->node_count * sizeof(path_node));
+		}
+		pf->search = 1;
+	}
+
+	pf->open[0].clear();
+	pf->open[1].clear();
+	pf->focal.clear();
+}
+
+static uint32_t path_estimate(const path_finder* pf, uint32_t index, tile_pos pos, uint32_t target, tile_pos target_pos)
+{
+	const uint32_t manhattan = manhattan_distance(pos, target_pos);
+	if (!pf->landmarks)
+		return manhattan;
+
+	return std::max(manhattan, path_landmarks_estimate(pf->landmarks, index, target));
+}
+
+// Grid path_find searches, the pruned tile flags when pruning is set
+static grid_dynamic path_finder_grid(const path_finder* pf)
+{
+	grid_dynamic grid(pf->grid);
+	if (pf->prune_active)
+		grid.tiles = pf->prune_tiles;
+
+	return grid;
+}
+
+// Heuristic policy for path_find, picking Manhattan distance or the landmark bound at runtime
+struct heuristic_finder
+{
+	const path_finder*	pf;
+	uint32_t			target;
+	tile_pos			target_pos;
+
+	uint32_t operator()(uint32_t index, tile_pos pos) const
+	{
+		return path_estimate(pf, index, pos, target, target_pos);
+	}
+};
+
+/*
+	Bidirectional A*. Side 0 searches forward from the start and side 1 searches backward from the
+	goal, each step expanding whichever side has the lower key (forward on ties). Balancing on open
+	list size instead lets the two frontiers slip past each other along different but equally short
+	staircase paths in open areas, doubling the work.
+
+	Using the distance to the far end as each side's heuristic makes both frontiers race all the way
+	across the map before the stopping test can fire, which ends up expanding more than plain A*.
+	Instead both sides share the balanced potential p(v) = (h(v, goal) - h(v, start)) / 2, forward
+	keys being g + p(v) and backward keys g - p(v). This is a consistent heuristic for each side
+	and makes the search a bidirectional Dijkstra on reduced edge costs, so it can stop as soon as
+	the two lowest keys add up to the best complete path seen so far. Keys are doubled to stay in
+	integers and offset by h(start, goal) so they are never negative.
+
+	Whenever a side reaches a tile the other side has also reached, the two half paths form a
+	complete path and the cheapest one is remembered with its meeting tile in the finder, so the
+	search can be suspended and resumed like plain A*.
+*/
+static void path_find_bidirectional_begin(path_finder* pf, path_stats* stats)
+{
+	const grid_dynamic grid = path_finder_grid(pf);
+	const uint32_t origin[2] = {grid.index(pf->query.start), grid.index(pf->query.goal)};
+
+	for (uint32_t side = 0; side < 2; side++)
+	{
+		pf->nodes[side][origin[side]] = {pf->search, 0, 0, 0};
+		path_open_push(&pf->open[side], 0, 0, origin[side]);
+		stats->nodes_generated++;
+	}
+
+	pf->best_cost = origin[0] == origin[1] ? 0 : UINT32_MAX;
+	pf->meet = origin[0];
+}
+
+template<typename Path>
+static path_status path_find_bidirectional_step(path_finder* pf, uint32_t max_expansions, Path* path, path_stats* stats)
+{
+	const grid_dynamic grid = path_finder_grid(pf);
+	const uint32_t search = pf->search;
+	const uint32_t origin[2] = {grid.index(pf->query.start), grid.index(pf->query.goal)};
+	const tile_pos ends[2] = {pf->query.start, pf->query.goal};
+	const uint32_t offset = path_estimate(pf, origin[0], ends[0], origin[1], ends[1]);
+	path_node* nodes[2] = {pf->nodes[0], pf->nodes[1]};
+	std::vector<path_open_entry>* open[2] = {&pf->open[0], &pf->open[1]};
+
+	for (uint32_t expanded = 0;; expanded++)
+	{
+		for (uint32_t side = 0; side < 2; side++)
+		{
+			while (!open[side]->empty() && path_open_stale(open[side]->front(), nodes[side]))
+				path_open_pop(open[side]);
+		}
+
+		// Once either frontier is exhausted every path through it has already been seen
+		if (open[0]->empty() || open[1]->empty())
+			break;
+
+		if (pf->best_cost != UINT32_MAX && open[0]->front().f + open[1]->front().f >= (pf->best_cost + offset) * 2)
+			break;
+
+		if (expanded == max_expansions)
+			return path_status_searching;
+
+		const uint32_t side = open[0]->front().f <= open[1]->front().f ? 0 : 1;
+		path_node* side_nodes = nodes[side];
+		const path_node* other_nodes = nodes[side ^ 1];
+
+		const path_open_entry current = path_open_pop(open[side]);
+		side_nodes[current.index].closed = 1;
+		stats->nodes_expanded++;
+
+		const tile_pos pos = grid.pos(current.index);
+		const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[current.index]);
+		const uint32_t g = current.g + 1;
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t direction = neighbours.directions[i];
+			const uint32_t index = current.index + grid.offset(direction);
+			path_node* next = &side_nodes[index];
+			if (next->search == search && next->g <= g)
+				continue;
+
+			*next = {search, g, 0, direction ^ 1};
+
+			const tile_pos next_pos = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+			const uint32_t to_other_end = path_estimate(pf, index, next_pos, origin[side ^ 1], ends[side ^ 1]);
+			const uint32_t to_own_end = path_estimate(pf, index, next_pos, origin[side], ends[side]);
+			const uint32_t key = (g * 2) + to_other_end - to_own_end + offset;
+			path_open_push(open[side], key, g, index);
+			stats->nodes_generated++;
+
+			const path_node* other = &other_nodes[index];
+			if (other->search == search && g + other->g < pf->best_cost)
+			{
+				pf->best_cost = g + other->g;
+				pf->meet = index;
+			}
+		}
+	}
+
+	if (pf->best_cost == UINT32_MAX)
+		return path_status_failed;
+
+	// Forward half runs start to meeting tile, backward half is walked from the meeting tile to the goal
+	path_append_from_origin(grid, nodes[0], origin[0], pf->meet, path);
+	for (uint32_t index = pf->meet; index != origin[1];)
+	{
+		const uint32_t direction = nodes[1][index].parent;
+		index += grid.offset(direction);
+		path_append_step(grid, direction, index, path);
+	}
+
+	stats->cost = pf->best_cost;
+	return path_status_found;
+}
+
+static uint32_t path_query_weight(const path_query* query)
+{
+	return query->weight ? std::max<uint32_t>(query->weight, path_weight_optimal) : path_weight_default;
+}
+
+// Empties a path before an anytime search writes a shorter one
+static void path_reset(std::vector<tile_pos>* path, tile_pos)
+{
+	path->clear();
+}
+
+static void path_reset(path_packed* path, tile_pos start)
+{
+	path_packed_clear(path, start);
+}
+
+/*
+	Focal search (A*-epsilon). Open tiles whose f is within the weight of the lowest f on the open
+	list form the focal list, and the search expands from the focal list rather than by lowest f.
+	The cost bound follows from the lowest f, which only ever rises, so the first time the goal is
+	expanded its path is within the weight of the shortest. That only holds if closed tiles reached
+	more cheaply are reopened.
+
+	The focal list is ordered by g plus the weighted estimate rather than the estimate alone. Going
+	purely by estimate heads for the goal greedily and reaches tiles by long ways round, and on the
+	generated room maps reopening those cost ten times the expansions of A*. Ordered this way the
+	search behaves like weighted A* held back to the bound.
+
+	Three heaps are kept: open[0] holds every open tile ordered by f to track the lowest, open[1]
+	holds the tiles not yet within the bound ordered by f, and focal holds the rest. A tile appears
+	in open[0] and in one of the other two, and entries left behind when a tile is expanded or
+	reached more cheaply are dropped as stale like everywhere else.
+*/
+static void path_find_focal_begin(path_finder* pf, path_stats* stats)
+{
+	const grid_dynamic grid = path_finder_grid(pf);
+	const uint32_t start = grid.index(pf->query.start);
+	const uint32_t estimate = path_estimate(pf, start, pf->query.start, grid.index(pf->query.goal), pf->query.goal);
+
+	pf->nodes[0][start] = {pf->search, 0, 0, 0};
+	path_open_push(&pf->open[0], estimate, 0, start);
+	path_open_push(&pf->focal, estimate, 0, start);
+	stats->nodes_generated++;
+}
+
+template<typename Path>
+static path_status path_find_focal_step(path_finder* pf, uint32_t max_expansions, Path* path, path_stats* stats)
+{
+	const grid_dynamic grid = path_finder_grid(pf);
+	const uint32_t search = pf->search;
+	const uint32_t start = grid.index(pf->query.start);
+	const heuristic_finder heuristic = {pf, grid.index(pf->query.goal), pf->query.goal};
+	const uint32_t weight = path_query_weight(&pf->query);
+	path_node* nodes = pf->nodes[0];
+	std::vector<path_open_entry>* open = &pf->open[0];
+	std::vector<path_open_entry>* waiting = &pf->open[1];
+	std::vector<path_open_entry>* focal = &pf->focal;
+
+	for (uint32_t expanded = 0;; expanded++)
+	{
+		while (!open->empty() && path_open_stale(open->front(), nodes))
+			path_open_pop(open);
+
+		if (open->empty())
+			return path_status_failed;
+
+		// The tile with the lowest f is always within the bound, so focal is never empty after this
+		const uint32_t bound = (uint32_t)(((uint64_t)open->front().f * weight) / 100);
+		while (!waiting->empty() && (waiting->front().f <= bound || path_open_stale(waiting->front(), nodes)))
+		{
+			const path_open_entry entry = path_open_pop(waiting);
+			if (!path_open_stale(entry, nodes))
+				path_open_push(focal, entry.g + (uint32_t)(((uint64_t)(entry.f - entry.g) * weight) / 100), entry.g, entry.index);
+		}
+
+		while (!focal->empty() && path_open_stale(focal->front(), nodes))
+			path_open_pop(focal);
+
+		assert(!focal->empty());
+
+		if (expanded == max_expansions)
+			return path_status_searching;
+
+		const path_open_entry current = path_open_pop(focal);
+		nodes[current.index].closed = 1;
+		stats->nodes_expanded++;
+
+		if (current.index == heuristic.target)
+		{
+			path_append_from_origin(grid, nodes, start, current.index, path);
+			stats->cost = path_length_from_origin(grid, nodes, start, current.index);
+			return path_status_found;
+		}
+
+		const tile_pos pos = grid.pos(current.index);
+		const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[current.index]);
+		const uint32_t g = current.g + 1;
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t direction = neighbours.directions[i];
+			const uint32_t index = current.index + grid.offset(direction);
+			path_node* next = &nodes[index];
+			if (next->search == search && next->g <= g)
+				continue;
+
+			*next = {search, g, 0, direction ^ 1};
+
+			const tile_pos next_pos = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+			const uint32_t estimate = heuristic(index, next_pos);
+			path_open_push(open, g + estimate, g, index);
+			if (g + estimate <= bound)
+				path_open_push(focal, g + (uint32_t)(((uint64_t)estimate * weight) / 100), g, index);
+			else
+				path_open_push(waiting, g + estimate, g, index);
+			stats->nodes_generated++;
+		}
+	}
+}
+
+/*
+	Anytime weighted A*. The search runs as weighted A* and writes its path the first time it
+	expands the goal, then carries on from where it was. Each later path is shorter than the last,
+	as tiles that cannot beat the best path so far by their unweighted estimate are dropped, and
+	once the open list runs dry the best path is the shortest. Closed tiles reached more cheaply
+	are opened again, which the weighted estimate makes common.
+*/
+template<typename Path>
+static path_status path_find_anytime_step(path_finder* pf, uint32_t max_expansions, Path* path, path_stats* stats)
+{
+	const grid_dynamic grid = path_finder_grid(pf);
+	const uint32_t search = pf->search;
+	const uint32_t start = grid.index(pf->query.start);
+	const heuristic_finder heuristic = {pf, grid.index(pf->query.goal), pf->query.goal};
+	const heuristic_weighted<heuristic_finder> weighted = {heuristic, path_weight_scale(path_query_weight(&pf->query))};
+	path_node* nodes = pf->nodes[0];
+	std::vector<path_open_entry>* open = &pf->open[0];
+	const path_status pending = pf->best_cost == UINT32_MAX ? path_status_searching : path_status_improving;
+
+	for (uint32_t expanded = 0; !open->empty();)
+	{
+		if (path_open_stale(open->front(), nodes))
+		{
+			path_open_pop(open);
+			continue;
+		}
+
+		if (expanded++ == max_expansions)
+			return pending;
+
+		const path_open_entry current = path_open_pop(open);
+		const tile_pos pos = grid.pos(current.index);
+		if (current.g + heuristic(current.index, pos) >= pf->best_cost)
+			continue;
+
+		nodes[current.index].closed = 1;
+		stats->nodes_expanded++;
+
+		if (current.index == heuristic.target)
+		{
+			pf->best_cost = path_length_from_origin(grid, nodes, start, current.index);
+			path_reset(path, pf->query.start);
+			path_append_from_origin(grid, nodes, start, current.index, path);
+			stats->cost = pf->best_cost;
+			return path_status_improving;
+		}
+
+		const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[current.index]);
+		const uint32_t g = current.g + 1;
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t direction = neighbours.directions[i];
+			const uint32_t index = current.index + grid.offset(direction);
+			path_node* next = &nodes[index];
+			if (next->search == search && next->g <= g)
+				continue;
+
+			const tile_pos next_pos = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+			if (g + heuristic(index, next_pos) >= pf->best_cost)
+				continue;
+
+			*next = {search, g, 0, direction ^ 1};
+			path_open_push(open, g + weighted(index, next_pos), g, index);
+			stats->nodes_generated++;
+		}
+	}
+
+	return pf->best_cost == UINT32_MAX ? path_status_failed : path_status_found;
+}
+
+void tile_flags_from_walkable(uint8_t* tiles, int32_t width, int32_t height)
+{
+	/*
+		Safe to do in place: a tile only turns into a wall here if it has no walkable neighbours, so
+		no other tile can be looking at it.
+	*/
+	const tile_grid grid = {width, height, tiles};
+	for (int32_t y = 0; y < height; y++)
+	{
+		for (int32_t x = 0; x < width; x++)
+		{
+			uint8_t* tile = &tiles[(y * width) + x];
+			if (*tile == tile_flags_wall)
+				continue;
+
+			uint8_t flags = tile_flags_wall;
+			for (uint32_t direction = 0; direction < 4; direction++)
+			{
+				if (tile_grid_get(&grid, x + tile_direction_dx[direction], y + tile_direction_dy[direction]) != tile_flags_wall)
+					flags |= 1 << direction;
+			}
+			*tile = flags;
+		}
+	}
+}
+
+void path_finder_init(path_finder* pf, const tile_grid* grid)
+{
+	alloc_tag("path_find");
+
+	const size_t tile_count = (size_t)grid->width * grid->height;
+
+	pf->grid = grid;
+	pf->landmarks = nullptr;
+	pf->bounds = nullptr;
+	pf->nodes[0] = (path_node*)calloc(tile_count, sizeof(path_node));
+	pf->nodes[1] = nullptr;
+	pf->node_count = (uint32_t)tile_count;
+	pf->search = 0;
+	pf->query = {};
+	pf->best_cost = UINT32_MAX;
+	pf->meet = 0;
+	pf->prune = nullptr;
+	pf->prune_tiles = nullptr;
+	pf->prune_version = 0;
+	pf->prune_active = false;
+
+#ifndef NDEBUG
+	// Catch maps whose open bits point off the grid or only one way between two tiles
+	for (int32_t y = 0; y < grid->height; y++)
+	{
+		for (int32_t x = 0; x < grid->width; x++)
+		{
+			const uint8_t tile = tile_grid_get(grid, x, y);
+			for (uint32_t direction = 0; direction < 4; direction++)
+			{
+				const uint8_t next = tile_grid_get(grid, x + tile_direction_dx[direction], y + tile_direction_dy[direction]);
+				assert(((tile >> direction) & 1) == ((next >> (direction ^ 1)) & 1));
+			}
+		}
+	}
+#endif
+}
+
+void path_finder_term(path_finder* pf)
+{
+	free(pf->nodes[0]);
+	free(pf->nodes[1]);
+	pf->nodes[0] = pf->nodes[1] = nullptr;
+
+	free(pf->prune_tiles);
+	pf->prune_tiles = nullptr;
+	pf->prune = nullptr;
+	std::vector<uint32_t>().swap(pf->prune_patched);
+
+	// Release the heaps' storage too, clear alone keeps it
+	for (std::vector<path_open_entry>& open : pf->open)
+		std::vector<path_open_entry>().swap(open);
+	std::vector<path_open_entry>().swap(pf->focal);
+}
+
+// Per-query setup shared by every path type, the caller has already reset the path
+static bool path_finder_begin_any(path_finder* pf, const path_query* query, path_stats* stats)
+{
+	*stats = {};
+
+	assert(!pf->landmarks || pf->landmarks->grid == pf->grid);
+	assert(!pf->bounds || pf->bounds->grid == pf->grid);
+
+	if (tile_grid_get(pf->grid, query->start.x, query->start.y) == tile_flags_wall ||
+		tile_grid_get(pf->grid, query->goal.x, query->goal.y) == tile_flags_wall)
+		return false;
+
+	pf->query = *query;
+	path_finder_begin_search(pf);
+
+	pf->prune_active = pf->prune && path_finder_prune_query(pf, query);
+
+	return true;
+}
+
+bool path_finder_begin_query(path_finder* pf, const path_query* query, std::vector<tile_pos>* path, path_stats* stats)
+{
+	path->clear();
+	return path_finder_begin_any(pf, query, stats);
+}
+
+bool path_finder_begin_query(path_finder* pf, const path_query* query, path_packed* path, path_stats* stats)
+{
+	path_packed_clear(path, query->start);
+	return path_finder_begin_any(pf, query, stats);
+}
+
+template<typename Path>
+static path_status path_find_begin_any(path_finder* pf, const path_query* query, Path* path, path_stats* stats)
+{
+	alloc_tag("path_find");
+
+	if (query->mode == path_mode_bidirectional && !pf->nodes[1])
+		pf->nodes[1] = (path_node*)calloc(pf->node_count, sizeof(path_node));
+
+	if (!path_finder_begin_query(pf, query, path, stats))
+		return path_status_failed;
+
+	switch (query->mode)
+	{
+	case path_mode_astar:
+	{
+		const grid_dynamic grid = path_finder_grid(pf);
+		const heuristic_finder heuristic = {pf, grid.index(query->goal), query->goal};
+		path_search_astar_begin(pf, grid, heuristic, cost_uniform(), stats);
+		break;
+	}
+	case path_mode_bidirectional:
+		path_find_bidirectional_begin(pf, stats);
+		break;
+	case path_mode_weighted:
+	case path_mode_anytime:
+	{
+		const grid_dynamic grid = path_finder_grid(pf);
+		const heuristic_finder heuristic = {pf, grid.index(query->goal), query->goal};
+		path_search_astar_begin(pf, grid, heuristic_weighted<heuristic_finder>{heuristic, path_weight_scale(path_query_weight(query))}, cost_uniform(), stats);
+		pf->best_cost = UINT32_MAX;
+		break;
+	}
+	case path_mode_focal:
+		path_find_focal_begin(pf, stats);
+		break;
+	}
+
+	return path_status_searching;
+}
+
+template<typename Path>
+static path_status path_find_step_any(path_finder* pf, uint32_t max_expansions, Path* path, path_stats* stats)
+{
+	alloc_tag("path_find");
+
+	switch (pf->query.mode)
+	{
+	case path_mode_astar:
+	{
+		const grid_dynamic grid = path_finder_grid(pf);
+		const heuristic_finder heuristic = {pf, grid.index(pf->query.goal), pf->query.goal};
+		if (pf->bounds)
+			return path_search_astar_step(pf, grid_bounded<grid_dynamic>(grid, pf->bounds, pf->query.goal), heuristic, cost_uniform(), goal_tile{heuristic.target}, max_expansions, path, stats);
+
+		return path_search_astar_step(pf, grid, heuristic, cost_uniform(), goal_tile{heuristic.target}, max_expansions, path, stats);
+	}
+	case path_mode_bidirectional:
+		return path_find_bidirectional_step(pf, max_expansions, path, stats);
+	case path_mode_weighted:
+	{
+		const grid_dynamic grid = path_finder_grid(pf);
+		const heuristic_finder heuristic = {pf, grid.index(pf->query.goal), pf->query.goal};
+		const heuristic_weighted<heuristic_finder> weighted = {heuristic, path_weight_scale(path_query_weight(&pf->query))};
+		return path_search_astar_step(pf, grid, weighted, cost_uniform(), goal_tile{heuristic.target}, max_expansions, path, stats);
+	}
+	case path_mode_focal:
+		return path_find_focal_step(pf, max_expansions, path, stats);
+	case path_mode_anytime:
+		return path_find_anytime_step(pf, max_expansions, path, stats);
+	}
+
+	return path_status_failed;
+}
+
+template<typename Path>
+static bool path_find_any(path_finder* pf, const path_query* query, Path* path, path_stats* stats)
+{
+	path_stats local_stats;
+	if (!stats)
+		stats = &local_stats;
+
+	if (path_find_begin_any(pf, query, path, stats) == path_status_failed)
+		return false;
+
+	path_status status = path_find_step_any(pf, UINT32_MAX, path, stats);
+	while (status == path_status_improving)
+		status = path_find_step_any(pf, UINT32_MAX, path, stats);
+
+	return status == path_status_found;
+}
+
+path_status path_find_begin(path_finder* pf, const path_query* query, std::vector<tile_pos>* path, path_stats* stats)
+{
+	return path_find_begin_any(pf, query, path, stats);
+}
+
+path_status path_find_begin(path_finder* pf, const path_query* query, path_packed* path, path_stats* stats)
+{
+	return path_find_begin_any(pf, query, path, stats);
+}
+
+path_status path_find_step(path_finder* pf, uint32_t max_expansions, std::vector<tile_pos>* path, path_stats* stats)
+{
+	return path_find_step_any(pf, max_expansions, path, stats);
+}
+
+path_status path_find_step(path_finder* pf, uint32_t max_expansions, path_packed* path, path_stats* stats)
+{
+	return path_find_step_any(pf, max_expansions, path, stats);
+}
+
+bool path_find(path_finder* pf, const path_query* query, std::vector<tile_pos>* path, path_stats* stats)
+{
+	return path_find_any(pf, query, path, stats);
+}
+
+bool path_find(path_finder* pf, const path_query* query, path_packed* path, path_stats* stats)
+{
+	return path_find_any(pf, query, path, stats);
+}
\ No newline at end of file
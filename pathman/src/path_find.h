@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <vector>
+
+/*
+	Grid pathfinding over tile maps that use the tile_flags encoding.
+
+	Each tile stores which of its four neighbours can be entered. A tile with no open bits is a wall.
+	The open bits must describe an undirected graph (if A is open toward B then B is open toward A)
+	and must never point off the edge of the grid, so the search can step along them without any
+	bounds checks.
+*/
+enum tile_flags : uint8_t
+{
+	tile_flags_wall = 0x00,
+	tile_flags_open_up = 0x01,
+	tile_flags_open_down = 0x02,
+	tile_flags_open_left = 0x04,
+	tile_flags_open_right = 0x08,
+};
+
+/*
+	Direction index of each open bit, so (1 << direction) is the matching tile_flags bit and
+	(direction ^ 1) is the opposite direction.
+*/
+enum tile_direction : uint8_t
+{
+	tile_direction_up,
+	tile_direction_down,
+	tile_direction_left,
+	tile_direction_right
+};
+
+constexpr int32_t tile_direction_dx[4] = {0, 0, -1, 1};
+constexpr int32_t tile_direction_dy[4] = {-1, 1, 0, 0};
+
+struct tile_grid
+{
+	int32_t			width;
+	int32_t			height;
+	const uint8_t*	tiles;	// width * height tile_flags, row-major
+};
+
+struct tile_pos
+{
+	int32_t x;
+	int32_t y;
+};
+
+/*
+	The weighted, focal and anytime modes trade path length for search time. They may return a path
+	longer than the shortest, but never longer than the query's weight times the shortest. Weights
+	are in hundredths, so 150 allows paths up to half as long again, and 0 picks
+	path_weight_default.
+*/
+enum path_mode : uint8_t
+{
+	path_mode_astar,			// Single frontier grown from the start toward the goal
+	path_mode_bidirectional,	// Frontiers grown from both ends and stitched where they meet
+	path_mode_weighted,			// A* with the estimate scaled up by the weight, heading straight for the goal
+	path_mode_focal,			// A*-epsilon, weighted A* held to tiles within the weight of the lowest f
+	path_mode_anytime			// Weighted A* that keeps improving its path once found, down to the shortest
+};
+
+constexpr uint16_t path_weight_optimal = 100;
+constexpr uint16_t path_weight_default = 150;
+
+struct path_query
+{
+	tile_pos	start;
+	tile_pos	goal;
+	path_mode	mode;
+	uint16_t	weight;		// Suboptimal modes only, in hundredths, 0 for path_weight_default
+};
+
+enum path_status : uint8_t
+{
+	path_status_searching,		// Budget ran out, call path_find_step again to continue
+	path_status_found,
+	path_status_failed,			// No path, or an end of the query is a wall
+	path_status_improving		// Anytime mode, a path has been written and the next steps look for a shorter one
+};
+
+struct path_stats
+{
+	uint32_t nodes_expanded;	// Tiles taken off an open list and expanded
+	uint32_t nodes_generated;	// Open list insertions
+	uint32_t cost;				// Number of moves in the returned path
+};
+
+/*
+	Per tile search state. Tiles are only valid for the search whose id matches, which lets a new
+	search start without clearing the whole array.
+*/
+struct path_node
+{
+	uint32_t search;			// Id of the search that last touched this tile
+	uint32_t g		: 29;		// Cost from the search origin
+	uint32_t closed	: 1;		// Expanded with a final cost
+	uint32_t parent	: 2;		// tile_direction to step back toward the origin
+};
+
+struct path_open_entry
+{
+	uint32_t f;
+	uint32_t g;
+	uint32_t index;
+};
+
+struct path_landmarks;
+struct path_prune;
+struct path_bounds;
+
+/*
+	Reusable search context for one grid. Node arrays and open lists are kept between queries so
+	a warmed up finder does not allocate.
+
+	Searches estimate remaining distance with Manhattan distance, or with the larger of that and
+	the landmark bound when landmarks have been set. With pruning set (see path_prune.h) searches
+	run over the finder's own copy of the pruned tile flags instead of the grid's. With bounds set
+	(see path_bounds.h) A* queries also skip moves that start no shortest path to the goal.
+
+	A finder holds the complete state of one search, so a search started with path_find_begin can
+	be suspended between path_find_step calls and resumed later. Starting another query abandons it.
+*/
+struct path_finder
+{
+	const tile_grid*				grid;
+	const path_landmarks*			landmarks;	// Optional ALT tables for the same grid
+	const path_bounds*				bounds;		// Optional goal bounding boxes for the same grid
+	path_node*						nodes[2];	// Forward and backward search state, backward is created on first use
+	uint32_t						node_count;	// Entries in each node array, width * height unless a layout needs more
+	std::vector<path_open_entry>	open[2];	// Binary heaps ordered by lowest f then highest g
+	uint32_t						search;
+	path_query						query;		// Query of the current search
+	std::vector<path_open_entry>	focal;		// Focal search, open tiles within the weight ordered by estimate
+	uint32_t						best_cost;	// Bidirectional and anytime progress, cheapest complete path so far
+	uint32_t						meet;		// and the tile where its two halves join
+	const path_prune*				prune;			// Optional, set with path_finder_set_prune
+	uint8_t*						prune_tiles;	// Pruned tile flags with this query's exits opened
+	uint32_t						prune_version;
+	bool							prune_active;	// Whether this query searches the pruned flags
+	std::vector<uint32_t>			prune_patched;	// Tiles opened for this query, reset by the next
+};
+
+/*
+	Converts a map of walkable (non-zero) and blocked (zero) tiles into tile_flags in place, opening
+	each tile toward its walkable neighbours.
+*/
+void tile_flags_from_walkable(uint8_t* tiles, int32_t width, int32_t height);
+
+void path_finder_init(path_finder* pf, const tile_grid* grid);
+void path_finder_term(path_finder* pf);
+
+/*
+	Finds a path for the query, the shortest unless the mode is one of the suboptimal ones. On
+	success the path holds every tile from start to goal inclusive and true is returned. Anytime
+	queries run until the path is the shortest. Stats are optional.
+*/
+bool path_find(path_finder* pf, const path_query* query, std::vector<tile_pos>* path, path_stats* stats);
+
+/*
+	Time-sliced version of path_find. path_find_begin starts the search and path_find_step then
+	expands at most max_expansions tiles per call until it returns found or failed. Stats are
+	accumulated across steps so the same stats must be passed to every call, and the path is only
+	written once the search completes.
+
+	Anytime queries also return improving, each time they find a shorter path and once the budget
+	runs out after the first. The path then already holds the best so far and can be used while
+	later steps keep improving it, the same path must be passed to every call.
+*/
+path_status path_find_begin(path_finder* pf, const path_query* query, std::vector<tile_pos>* path, path_stats* stats);
+path_status path_find_step(path_finder* pf, uint32_t max_expansions, std::vector<tile_pos>* path, path_stats* stats);
+
+/*
+	Resets stats, path and per-query finder state before a search. Returns false if either end of
+	the query is a wall. Only needed by searches implemented outside path_find, such as path_search.
+*/
+bool path_finder_begin_query(path_finder* pf, const path_query* query, std::vector<tile_pos>* path, path_stats* stats);
+
+inline int32_t manhattan_distance(tile_pos a, tile_pos b)
+{
+	return abs(a.x - b.x) + abs(a.y - b.y);
+}
+
+inline uint8_t tile_grid_get(const tile_grid* grid, int32_t x, int32_t y)
+{
+	if (x < 0 || x >= grid->width || y < 0 || y >= grid->height)
+		return tile_flags_wall;
+
+	return grid->tiles[(y * grid->width) + x];
+}
\ No newline at end of file
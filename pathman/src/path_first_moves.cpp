@@ -0,0 +1,46 @@
+void path_first_moves_init(path_first_moves* search, const tile_grid* grid)
+{
+	const size_t tile_count = (size_t)grid->width * grid->height;
+
+	search->visited.assign(tile_count, 0);
+	search->distance.resize(tile_count);
+	search->moves.resize(tile_count);
+	search->queue.reserve(tile_count);
+	search->search = 0;
+}
+
+void path_first_moves_search(path_first_moves* search, const tile_grid* grid, uint32_t source)
+{
+	const grid_dynamic tiles(grid);
+	const uint32_t id = ++search->search;
+
+	search->queue.clear();
+	search->queue.push_back(source);
+	search->visited[source] = id;
+	search->distance[source] = 0;
+	search->moves[source] = 0;
+
+	for (size_t head = 0; head < search->queue.size(); head++)
+	{
+		const uint32_t current = search->queue[head];
+		const uint32_t distance = search->distance[current] + 1;
+		const tile_neighbours& neighbours = tile_neighbours_of(tiles.tiles[current]);
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t direction = neighbours.directions[i];
+			const uint32_t index = current + tiles.offset(direction);
+			const uint8_t moves = current == source ? (uint8_t)(1 << direction) : search->moves[current];
+
+			if (search->visited[index] != id)
+			{
+				search->visited[index] = id;
+				search->distance[index] = distance;
+				search->moves[index] = moves;
+				search->queue.push_back(index);
+			}
+			else if (search->distance[index] == distance)
+				search->moves[index] |= moves;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+/*
+	Breadth first search from one source keeping every optimal first move of each tile, the
+	search behind the offline tables built from every walkable tile, path_database and
+	path_bounds.
+
+	A tile's moves are those of all its parents one level closer, which are complete before the
+	tile itself is expanded. Keeping all optimal moves rather than one keeps every shortest path,
+	so whatever is built from them does not depend on which one a search happens to find. The
+	scratch is stamped with a search id so nothing is cleared between sources; each build thread
+	keeps its own.
+*/
+struct path_first_moves
+{
+	std::vector<uint32_t>	visited;	// Search id that last reached each tile
+	std::vector<uint32_t>	distance;
+	std::vector<uint8_t>	moves;		// Bit per tile_direction that starts a shortest path to the tile
+	std::vector<uint32_t>	queue;		// Reached tiles in search order, the source first
+	uint32_t				search;
+};
+
+void path_first_moves_init(path_first_moves* search, const tile_grid* grid);
+
+void path_first_moves_search(path_first_moves* search, const tile_grid* grid, uint32_t source);
+
+// Calls visit(tile, moves) for every tile the last search reached other than its source, in search order
+template<typename Visit>
+void path_first_moves_visit(const path_first_moves* search, Visit visit)
+{
+	for (size_t i = 1; i < search->queue.size(); i++)
+		visit(search->queue[i], search->moves[search->queue[i]]);
+}
\ No newline at end of file
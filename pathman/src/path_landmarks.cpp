@@ -0,0 +1,108 @@
+/*
+	Breadth first search from one tile, writing the distance to every tile into the given landmark
+	slot of the distance table. Tiles that are never reached keep path_landmark_unreachable.
+*/
+static void path_landmarks_flood(path_landmarks* lm, uint32_t slot, uint32_t origin, std::vector<uint32_t>* queue)
+{
+	const tile_grid* grid = lm->grid;
+	const int32_t offsets[4] = {-grid->width, grid->width, -1, 1};
+	const size_t tile_count = (size_t)grid->width * grid->height;
+	uint16_t* distances = lm->distances + slot;
+
+	for (size_t i = 0; i < tile_count; i++)
+		distances[i * lm->stride] = path_landmark_unreachable;
+
+	queue->clear();
+	queue->push_back(origin);
+	distances[(size_t)origin * lm->stride] = 0;
+
+	for (size_t head = 0; head < queue->size(); head++)
+	{
+		const uint32_t index = (*queue)[head];
+		const uint16_t distance = distances[(size_t)index * lm->stride];
+		const uint16_t next_distance = distance < path_landmark_far ? distance + 1 : path_landmark_far;
+		const uint8_t tile = grid->tiles[index];
+
+		for (uint32_t direction = 0; direction < 4; direction++)
+		{
+			if (!(tile & (1 << direction)))
+				continue;
+
+			const uint32_t next = index + offsets[direction];
+			uint16_t* next_slot = &distances[(size_t)next * lm->stride];
+			if (*next_slot != path_landmark_unreachable)
+				continue;
+
+			*next_slot = next_distance;
+			queue->push_back(next);
+		}
+	}
+}
+
+void path_landmarks_build(path_landmarks* lm, const tile_grid* grid, uint32_t count)
+{
+	assert(count > 0 && count <= path_landmark_max);
+	alloc_tag("path_landmarks");
+
+	const size_t tile_count = (size_t)grid->width * grid->height;
+
+	lm->grid = grid;
+	lm->count = 0;
+	lm->stride = count <= 4 ? 4 : path_landmark_max;
+	lm->distances = (uint16_t*)calloc(tile_count * lm->stride, sizeof(uint16_t));
+
+	uint32_t first_open = 0;
+	while (first_open < tile_count && grid->tiles[first_open] == tile_flags_wall)
+		first_open++;
+
+	if (first_open == tile_count)
+		return;
+
+	/*
+		Farthest point selection. Flood from an arbitrary open tile and take the farthest tile as
+		the first landmark, then keep adding the tile whose distance to its nearest landmark is
+		largest. Slot 0 is used as scratch for the seed flood and overwritten by the first landmark.
+		Tiles not reachable from any landmark yet count as infinitely far, so each disconnected
+		region of the map gets a landmark before any region gets a second one.
+	*/
+	std::vector<uint32_t> queue;
+	std::vector<uint16_t> nearest(tile_count, path_landmark_unreachable);
+	path_landmarks_flood(lm, 0, first_open, &queue);
+
+	uint32_t candidate = queue.back();
+	while (lm->count < count)
+	{
+		const uint32_t slot = lm->count++;
+		lm->tiles[slot] = candidate;
+		path_landmarks_flood(lm, slot, candidate, &queue);
+
+		uint32_t farthest = 0;
+		candidate = UINT32_MAX;
+		for (size_t i = 0; i < tile_count; i++)
+		{
+			if (grid->tiles[i] == tile_flags_wall)
+				continue;
+
+			const uint16_t distance = lm->distances[(i * lm->stride) + slot];
+			if (distance < nearest[i])
+				nearest[i] = distance;
+
+			if (nearest[i] > farthest || candidate == UINT32_MAX)
+			{
+				farthest = nearest[i];
+				candidate = (uint32_t)i;
+			}
+		}
+
+		// Every open tile is already a landmark
+		if (farthest == 0)
+			break;
+	}
+}
+
+void path_landmarks_term(path_landmarks* lm)
+{
+	free(lm->distances);
+	lm->distances = nullptr;
+	lm->count = 0;
+}
\ No newline at end of file
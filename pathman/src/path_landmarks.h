@@ -0,0 +1,79 @@
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define PATH_LANDMARKS_SSE2 1
+#endif
+
+/*
+	ALT (A*, landmarks, triangle inequality) heuristic.
+
+	A few landmark tiles are picked spread out across the map and the true walking distance from
+	each landmark to every tile is stored. For any landmark L the triangle inequality gives
+	|d(L, a) - d(L, b)| <= d(a, b), so the largest of these differences is an admissible and
+	consistent estimate that, unlike Manhattan distance, knows about walls.
+
+	Distances are stored tile-major, 4 or 8 entries per tile depending on the landmark count, so the
+	distances for all landmarks of one tile are a single 8 or 16 byte load and the bound is
+	evaluated with SIMD. Distances that do not fit are clamped to path_landmark_far, which keeps
+	the estimate admissible, and tiles a landmark cannot reach are path_landmark_unreachable.
+*/
+constexpr uint32_t path_landmark_max = 8;
+constexpr uint16_t path_landmark_far = 0xFFFE;
+constexpr uint16_t path_landmark_unreachable = 0xFFFF;
+
+struct path_landmarks
+{
+	const tile_grid*	grid;
+	uint32_t			count;
+	uint32_t			stride;						// Distances per tile, 4 or 8
+	uint32_t			tiles[path_landmark_max];	// Tile index of each landmark
+	uint16_t*			distances;					// stride distances per tile, unused slots are zero
+};
+
+/*
+	Picks count (at most path_landmark_max) landmarks by farthest point selection and computes the
+	distance tables with one breadth first search per landmark.
+*/
+void path_landmarks_build(path_landmarks* lm, const tile_grid* grid, uint32_t count);
+void path_landmarks_term(path_landmarks* lm);
+
+inline uint32_t path_landmarks_estimate(const path_landmarks* lm, uint32_t index, uint32_t target)
+{
+	const uint16_t* a = &lm->distances[(size_t)index * lm->stride];
+	const uint16_t* b = &lm->distances[(size_t)target * lm->stride];
+
+#ifdef PATH_LANDMARKS_SSE2
+	__m128i va, vb;
+	if (lm->stride == 4)
+	{
+		// Upper four lanes load as zero and do not change the bound
+		va = _mm_loadl_epi64((const __m128i*)a);
+		vb = _mm_loadl_epi64((const __m128i*)b);
+	}
+	else
+	{
+		va = _mm_loadu_si128((const __m128i*)a);
+		vb = _mm_loadu_si128((const __m128i*)b);
+	}
+
+	// |a - b| for unsigned 16 bit lanes, one of the saturating subtractions is always zero
+	const __m128i diff = _mm_or_si128(_mm_subs_epu16(va, vb), _mm_subs_epu16(vb, va));
+
+	// SSE2 only has a signed 16 bit max, so flip the sign bit to keep unsigned ordering
+	const __m128i bias = _mm_set1_epi16((short)0x8000);
+	__m128i m = _mm_xor_si128(diff, bias);
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 8));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 4));
+	m = _mm_max_epi16(m, _mm_srli_si128(m, 2));
+
+	return (uint32_t)(uint16_t)(_mm_cvtsi128_si32(m) ^ 0x8000);
+#else
+	uint32_t estimate = 0;
+	for (uint32_t i = 0; i < lm->stride; i++)
+	{
+		const uint32_t diff = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+		estimate = diff > estimate ? diff : estimate;
+	}
+
+	return estimate;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,268 @@
+// Heuristic policy for the nearest goal search
+struct heuristic_nearest_goal
+{
+	const path_goal_set* goals;
+
+	uint32_t operator()(uint32_t, tile_pos pos) const
+	{
+		return path_goal_set_estimate(goals, pos);
+	}
+};
+
+// Goal policy accepting any tile of the set
+struct goal_in_set
+{
+	const path_goal_set* goals;
+
+	bool operator()(uint32_t index) const
+	{
+		return path_goal_set_contains(goals, index);
+	}
+};
+
+void path_goal_set_init(path_goal_set* goals, const tile_grid* grid)
+{
+	alloc_tag("path_nearest");
+
+	goals->grid = grid;
+	goals->mask.assign((((size_t)grid->width * grid->height) + 63) / 64, 0);
+	goals->count = 0;
+	goals->dirty = true;
+	goals->bucket_columns = (grid->width + path_goal_bucket_size - 1) / path_goal_bucket_size;
+	goals->bucket_rows = (grid->height + path_goal_bucket_size - 1) / path_goal_bucket_size;
+	goals->bucket_first.clear();
+	goals->bucket_goals.clear();
+}
+
+void path_goal_set_term(path_goal_set* goals)
+{
+	std::vector<uint64_t>().swap(goals->mask);
+	std::vector<uint32_t>().swap(goals->bucket_first);
+	std::vector<tile_pos>().swap(goals->bucket_goals);
+	goals->count = 0;
+}
+
+void path_goal_set_clear(path_goal_set* goals)
+{
+	std::fill(goals->mask.begin(), goals->mask.end(), 0);
+	goals->count = 0;
+	goals->dirty = true;
+}
+
+void path_goal_set_add(path_goal_set* goals, tile_pos pos)
+{
+	assert(pos.x >= 0 && pos.x < goals->grid->width && pos.y >= 0 && pos.y < goals->grid->height);
+
+	const uint32_t index = (uint32_t)((pos.y * goals->grid->width) + pos.x);
+	if (path_goal_set_contains(goals, index))
+		return;
+
+	goals->mask[index >> 6] |= 1ull << (index & 63);
+	goals->count++;
+	goals->dirty = true;
+}
+
+void path_goal_set_remove(path_goal_set* goals, tile_pos pos)
+{
+	assert(pos.x >= 0 && pos.x < goals->grid->width && pos.y >= 0 && pos.y < goals->grid->height);
+
+	const uint32_t index = (uint32_t)((pos.y * goals->grid->width) + pos.x);
+	if (!path_goal_set_contains(goals, index))
+		return;
+
+	goals->mask[index >> 6] &= ~(1ull << (index & 63));
+	goals->count--;
+	goals->dirty = true;
+}
+
+void path_goal_set_update(path_goal_set* goals)
+{
+	if (!goals->dirty)
+		return;
+
+	alloc_tag("path_nearest");
+
+	const int32_t width = goals->grid->width;
+	const size_t bucket_count = (size_t)goals->bucket_columns * goals->bucket_rows;
+
+	// Counting sort of the goals into buckets, walking set bits a word at a time
+	goals->bucket_first.assign(bucket_count + 1, 0);
+	goals->bucket_goals.resize(goals->count);
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (size_t word = 0; word < goals->mask.size(); word++)
+		{
+			for (uint64_t bits = goals->mask[word]; bits; bits &= bits - 1)
+			{
+				const uint32_t index = (uint32_t)((word * 64) + path_bit_scan(bits));
+				const tile_pos pos = {(int32_t)(index % width), (int32_t)(index / width)};
+				const size_t bucket = ((size_t)(pos.y / path_goal_bucket_size) * goals->bucket_columns) + (pos.x / path_goal_bucket_size);
+
+				if (pass == 0)
+					goals->bucket_first[bucket + 1]++;
+				else
+					goals->bucket_goals[goals->bucket_first[bucket]++] = pos;
+			}
+		}
+
+		/*
+			Prefix sum turns counts into start offsets. The fill pass then leaves each entry at the
+			next bucket's start, so shift them back down.
+		*/
+		if (pass == 0)
+		{
+			for (size_t i = 0; i < bucket_count; i++)
+				goals->bucket_first[i + 1] += goals->bucket_first[i];
+		}
+		else
+		{
+			for (size_t i = bucket_count; i > 0; i--)
+				goals->bucket_first[i] = goals->bucket_first[i - 1];
+			goals->bucket_first[0] = 0;
+		}
+	}
+
+	goals->dirty = false;
+}
+
+uint32_t path_goal_set_estimate(const path_goal_set* goals, tile_pos pos)
+{
+	assert(!goals->dirty);
+
+	const int32_t bx = pos.x / path_goal_bucket_size;
+	const int32_t by = pos.y / path_goal_bucket_size;
+	const int32_t max_ring = std::max(goals->bucket_columns, goals->bucket_rows);
+	uint32_t best = path_goal_unreachable;
+
+	for (int32_t ring = 0; ring <= max_ring; ring++)
+	{
+		/*
+			A bucket ring cells away differs by ring cells on at least one axis, so every tile in it
+			is at least (ring - 1) * size + 1 tiles away along that axis.
+		*/
+		if (ring > 0 && (uint32_t)(((ring - 1) * path_goal_bucket_size) + 1) >= best)
+			break;
+
+		for (int32_t y = by - ring; y <= by + ring; y++)
+		{
+			if (y < 0 || y >= goals->bucket_rows)
+				continue;
+
+			// Interior rows of the ring only have their two end buckets
+			const bool edge_row = y == by - ring || y == by + ring;
+			const int32_t step = edge_row ? 1 : std::max(1, ring * 2);
+
+			for (int32_t x = bx - ring; x <= bx + ring; x += step)
+			{
+				if (x < 0 || x >= goals->bucket_columns)
+					continue;
+
+				const size_t bucket = ((size_t)y * goals->bucket_columns) + x;
+				for (uint32_t i = goals->bucket_first[bucket]; i < goals->bucket_first[bucket + 1]; i++)
+					best = std::min(best, (uint32_t)manhattan_distance(pos, goals->bucket_goals[i]));
+			}
+		}
+	}
+
+	return best;
+}
+
+bool path_find_nearest(path_finder* pf, tile_pos start, path_goal_set* goals, std::vector<tile_pos>* path, path_stats* stats)
+{
+	assert(goals->grid == pf->grid);
+	alloc_tag("path_find");
+
+	path_stats local_stats;
+	if (!stats)
+		stats = &local_stats;
+
+	// The query has no single goal, start doubles as it so begin_query only checks the start
+	const path_query query = {start, start, path_mode_astar};
+	if (!path_finder_begin_query(pf, &query, path, stats) || goals->count == 0)
+		return false;
+
+	path_goal_set_update(goals);
+
+	const grid_dynamic grid(pf->grid);
+	const heuristic_nearest_goal heuristic = {goals};
+	path_search_astar_begin(pf, grid, heuristic, cost_uniform(), stats);
+	return path_search_astar_step(pf, grid, heuristic, cost_uniform(), goal_in_set{goals}, UINT32_MAX, path, stats) == path_status_found;
+}
+
+void path_goal_distances(const path_goal_set* goals, std::vector<uint32_t>* distances)
+{
+	alloc_tag("path_nearest");
+
+	const tile_grid* tiles = goals->grid;
+	const grid_dynamic grid(tiles);
+	const size_t tile_count = (size_t)tiles->width * tiles->height;
+
+	distances->assign(tile_count, path_goal_unreachable);
+
+	// The queue only lives for the search, so it goes in the thread's scratch arena if it has one
+	frame_arena_scope scratch(frame_scratch());
+	frame_vector<uint32_t> queue{frame_allocator<uint32_t>(scratch.arena)};
+	queue.reserve(tile_count);
+
+	// Every goal starts the breadth first search at distance zero, goals on walls are skipped
+	for (size_t word = 0; word < goals->mask.size(); word++)
+	{
+		for (uint64_t bits = goals->mask[word]; bits; bits &= bits - 1)
+		{
+			const uint32_t index = (uint32_t)((word * 64) + path_bit_scan(bits));
+			if (tiles->tiles[index] == tile_flags_wall)
+				continue;
+
+			(*distances)[index] = 0;
+			queue.push_back(index);
+		}
+	}
+
+	for (size_t head = 0; head < queue.size(); head++)
+	{
+		const uint32_t index = queue[head];
+		const uint32_t next_distance = (*distances)[index] + 1;
+		const tile_neighbours& neighbours = tile_neighbours_of(tiles->tiles[index]);
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t next = index + grid.offset(neighbours.directions[i]);
+			if ((*distances)[next] != path_goal_unreachable)
+				continue;
+
+			(*distances)[next] = next_distance;
+			queue.push_back(next);
+		}
+	}
+}
+
+bool path_goal_distances_path(const tile_grid* tiles, const std::vector<uint32_t>& distances, tile_pos start, std::vector<tile_pos>* path)
+{
+	const grid_dynamic grid(tiles);
+	uint32_t index = grid.index(start);
+
+	path->clear();
+	if (distances[index] == path_goal_unreachable)
+		return false;
+
+	path->push_back(start);
+	while (distances[index] != 0)
+	{
+		// Some neighbour is always exactly one closer, take the first in direction order
+		const tile_neighbours& neighbours = tile_neighbours_of(tiles->tiles[index]);
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t next = index + grid.offset(neighbours.directions[i]);
+			if (distances[next] == distances[index] - 1)
+			{
+				index = next;
+				break;
+			}
+		}
+
+		path->push_back(grid.pos(index));
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+	Searches toward many goals at once, such as the nearest pellet, power-up or exit.
+
+	Goals are held as one bit per tile of a grid. path_find_nearest runs a single A* that stops at
+	the first goal expanded, with the distance to the nearest goal ignoring walls as the heuristic.
+	That is the minimum of the single goal Manhattan estimates so it stays admissible and
+	consistent, and the search finds a nearest reachable goal with one pass instead of one search
+	per goal.
+
+	To keep the estimate cheap with hundreds of goals, goals are also bucketed into coarse square
+	cells and the nearest is found by checking rings of cells outward from the tile, stopping once
+	no farther ring could hold anything closer.
+
+	path_goal_distances is the multi-source version: one breadth first search seeded from every
+	goal that gives each tile its distance to the nearest goal, which pays off when many agents
+	query the same goal set.
+*/
+constexpr int32_t path_goal_bucket_size = 16;
+constexpr uint32_t path_goal_unreachable = UINT32_MAX;
+
+struct path_goal_set
+{
+	const tile_grid*		grid;
+	std::vector<uint64_t>	mask;				// One bit per tile, row-major, set for goals
+	uint32_t				count;
+	bool					dirty;				// Goals changed since the buckets were built
+	int32_t					bucket_columns;
+	int32_t					bucket_rows;
+	std::vector<uint32_t>	bucket_first;		// First entry of each bucket in bucket_goals, plus an end entry
+	std::vector<tile_pos>	bucket_goals;
+};
+
+void path_goal_set_init(path_goal_set* goals, const tile_grid* grid);
+void path_goal_set_term(path_goal_set* goals);
+void path_goal_set_clear(path_goal_set* goals);
+void path_goal_set_add(path_goal_set* goals, tile_pos pos);
+void path_goal_set_remove(path_goal_set* goals, tile_pos pos);
+
+// Rebuilds the buckets after goals change, searches call this themselves when needed
+void path_goal_set_update(path_goal_set* goals);
+
+// Manhattan distance from the tile to the nearest goal, path_goal_unreachable if there are none
+uint32_t path_goal_set_estimate(const path_goal_set* goals, tile_pos pos);
+
+inline bool path_goal_set_contains(const path_goal_set* goals, uint32_t index)
+{
+	return (goals->mask[index >> 6] >> (index & 63)) & 1;
+}
+
+/*
+	Finds a shortest path from start to whichever goal is nearest. On success the path holds every
+	tile from start to the goal inclusive, so the goal reached is path.back(). Stats are optional.
+*/
+bool path_find_nearest(path_finder* pf, tile_pos start, path_goal_set* goals, std::vector<tile_pos>* path, path_stats* stats);
+
+/*
+	Fills distances with the number of moves from every tile to its nearest goal, walls and tiles
+	that cannot reach any goal get path_goal_unreachable.
+*/
+void path_goal_distances(const path_goal_set* goals, std::vector<uint32_t>* distances);
+
+/*
+	Walks downhill through a distance field from path_goal_distances, giving the same kind of path
+	as path_find_nearest. Returns false if start cannot reach a goal.
+*/
+bool path_goal_distances_path(const tile_grid* grid, const std::vector<uint32_t>& distances, tile_pos start, std::vector<tile_pos>* path);
\ No newline at end of file
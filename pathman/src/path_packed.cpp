@@ -0,0 +1,25 @@
+void path_packed_from_tiles(path_packed* path, const tile_pos* tiles, uint32_t count)
+{
+	path_packed_clear(path, count ? tiles[0] : tile_pos{0, 0});
+
+	for (uint32_t i = 1; i < count; i++)
+	{
+		const int32_t dx = tiles[i].x - tiles[i - 1].x;
+		const int32_t dy = tiles[i].y - tiles[i - 1].y;
+		assert(abs(dx) + abs(dy) == 1);
+
+		// Up and down are 0 and 1, left and right 2 and 3
+		const uint32_t direction = dx ? (dx < 0 ? tile_direction_left : tile_direction_right) : (dy < 0 ? tile_direction_up : tile_direction_down);
+		path_packed_push(path, direction);
+	}
+}
+
+void path_packed_to_tiles(const path_packed* path, std::vector<tile_pos>* tiles)
+{
+	tiles->clear();
+
+	path_cursor cursor = path_cursor_begin(path);
+	tiles->push_back(cursor.pos);
+	while (path_cursor_next(path, &cursor))
+		tiles->push_back(cursor.pos);
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+/*
+	Compact path storage for agents that keep a live path.
+
+	A path_packed holds the start tile and up to path_packed_capacity moves as 2 bit tile_direction
+	codes, 32 to a word, in a fixed inline buffer, so the whole path is one 64 byte cache line,
+	aligned to one in an array too, and never allocates. A longer path keeps its first
+	path_packed_capacity moves and is marked truncated, and its agent should plan again from the
+	last tile once it gets there.
+
+	Searches write this format directly while walking parent links back from the goal, see the
+	path_find overloads below. A path_cursor then walks a path one move at a time, also without
+	allocating.
+*/
+constexpr uint32_t path_packed_capacity = 192;
+
+struct alignas(64) path_packed
+{
+	tile_pos	start;
+	uint16_t	length;								// Moves stored
+	bool		truncated;							// Only the first path_packed_capacity moves were kept
+	uint64_t	moves[path_packed_capacity / 32];	// Move i is bits 2 * (i % 32) of word i / 32
+};
+
+static_assert(sizeof(path_packed) == 64, "path_packed must fill exactly one cache line");
+
+struct path_cursor
+{
+	tile_pos	pos;
+	uint32_t	step;	// Next move to take
+};
+
+inline void path_packed_clear(path_packed* path, tile_pos start)
+{
+	path->start = start;
+	path->length = 0;
+	path->truncated = false;
+}
+
+inline uint32_t path_packed_move(const path_packed* path, uint32_t step)
+{
+	return (uint32_t)(path->moves[step >> 5] >> ((step & 31) * 2)) & 3;
+}
+
+inline void path_packed_set_move(path_packed* path, uint32_t step, uint32_t direction)
+{
+	uint64_t* word = &path->moves[step >> 5];
+	const uint32_t shift = (step & 31) * 2;
+	*word = (*word & ~(3ull << shift)) | ((uint64_t)direction << shift);
+}
+
+// Appends a move, or marks the path truncated once it is full
+inline void path_packed_push(path_packed* path, uint32_t direction)
+{
+	if (path->length == path_packed_capacity)
+	{
+		path->truncated = true;
+		return;
+	}
+
+	path_packed_set_move(path, path->length++, direction);
+}
+
+inline path_cursor path_cursor_begin(const path_packed* path)
+{
+	return {path->start, 0};
+}
+
+// Takes the next move, returns false at the end of the path
+inline bool path_cursor_next(const path_packed* path, path_cursor* cursor)
+{
+	if (cursor->step >= path->length)
+		return false;
+
+	const uint32_t direction = path_packed_move(path, cursor->step++);
+	cursor->pos.x += tile_direction_dx[direction];
+	cursor->pos.y += tile_direction_dy[direction];
+	return true;
+}
+
+// Conversions to and from a list of tiles from start to end inclusive, each one move from the last
+void path_packed_from_tiles(path_packed* path, const tile_pos* tiles, uint32_t count);
+void path_packed_to_tiles(const path_packed* path, std::vector<tile_pos>* tiles);
+
+/*
+	Search reconstruction into a packed path, the counterparts of the std::vector versions in
+	path_search.h. The parent links only lead backward, so the moves from the origin are counted
+	first and then written from the back, leaving out any past the capacity.
+*/
+template<typename Grid>
+void path_append_from_origin(const Grid& grid, const path_node* nodes, uint32_t origin, uint32_t index, path_packed* path)
+{
+	uint32_t count = 0;
+	for (uint32_t i = index; i != origin; i = grid.neighbour(i, nodes[i].parent))
+		count++;
+
+	const uint32_t first = path->length;
+	const uint32_t kept = std::min(count, path_packed_capacity - first);
+	path->length = (uint16_t)(first + kept);
+	path->truncated |= kept < count;
+
+	for (uint32_t step = count; index != origin; index = grid.neighbour(index, nodes[index].parent))
+	{
+		if (--step < kept)
+			path_packed_set_move(path, first + step, nodes[index].parent ^ 1);
+	}
+}
+
+template<typename Grid>
+void path_append_step(const Grid&, uint32_t direction, uint32_t, path_packed* path)
+{
+	path_packed_push(path, direction);
+}
+
+/*
+	path_find variants writing a packed path, otherwise the same as the std::vector versions. On
+	success the path starts at the query start, and is truncated if the full path is longer than
+	path_packed_capacity moves.
+*/
+bool path_find(path_finder* pf, const path_query* query, path_packed* path, path_stats* stats);
+path_status path_find_begin(path_finder* pf, const path_query* query, path_packed* path, path_stats* stats);
+path_status path_find_step(path_finder* pf, uint32_t max_expansions, path_packed* path, path_stats* stats);
+bool path_finder_begin_query(path_finder* pf, const path_query* query, path_packed* path, path_stats* stats);
\ No newline at end of file
@@ -0,0 +1,299 @@
+// Frontier entries or map words handed out per chunk
+static const size_t path_parallel_frontier_chunk = 256;
+static const size_t path_parallel_word_chunk = 64;
+
+// Frontiers smaller than this are expanded on the calling thread alone
+static const size_t path_parallel_min_frontier = 1024;
+
+/*
+	Direction switch thresholds from Beamer et al. Go bottom-up once the frontier is more than
+	1/14th of the tiles still unvisited, and back top-down when it shrinks below 1/24th of the map.
+*/
+static const uint32_t path_parallel_alpha = 14;
+static const uint32_t path_parallel_beta = 24;
+
+static void path_parallel_work(path_parallel* pp, uint32_t thread_index)
+{
+	const grid_dynamic grid(pp->grid);
+	const size_t tile_count = (size_t)pp->grid->width * pp->grid->height;
+	const uint32_t visited = pp->search << 2;
+	std::vector<uint32_t>* next = &pp->next[thread_index];
+
+	const size_t chunk = pp->job == path_parallel_job_top_down || pp->job == path_parallel_job_mark_bits ? path_parallel_frontier_chunk : path_parallel_word_chunk;
+	const size_t total = pp->job == path_parallel_job_top_down || pp->job == path_parallel_job_mark_bits ? pp->frontier.size() : pp->bit_words;
+
+	for (;;)
+	{
+		const size_t begin = pp->job_cursor.fetch_add(chunk, std::memory_order_relaxed);
+		if (begin >= total)
+			break;
+		const size_t end = std::min(begin + chunk, total);
+
+		switch (pp->job)
+		{
+		case path_parallel_job_top_down:
+			for (size_t i = begin; i < end; i++)
+			{
+				const uint32_t current = pp->frontier[i];
+				const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[current]);
+
+				for (uint32_t n = 0; n < neighbours.count; n++)
+				{
+					const uint32_t direction = neighbours.directions[n];
+					const uint32_t index = current + grid.offset(direction);
+
+					// Cheap load first, most neighbours were already visited by an earlier level
+					uint32_t visit = pp->visits[index].load(std::memory_order_relaxed);
+					if ((visit & ~3u) == visited)
+						continue;
+
+					if (pp->visits[index].compare_exchange_strong(visit, visited | (direction ^ 1), std::memory_order_relaxed))
+						next->push_back(index);
+				}
+			}
+			break;
+
+		case path_parallel_job_bottom_up:
+			// Each chunk owns whole words of the next bitmap, so plain stores are enough
+			for (size_t word = begin; word < end; word++)
+			{
+				uint64_t bits = 0;
+				const size_t first = word * 64;
+				const size_t last = std::min(first + 64, tile_count);
+
+				for (size_t index = first; index < last; index++)
+				{
+					const uint8_t tile = grid.tiles[index];
+					if (tile == tile_flags_wall || (pp->visits[index].load(std::memory_order_relaxed) & ~3u) == visited)
+						continue;
+
+					const tile_neighbours& neighbours = tile_neighbours_of(tile);
+					for (uint32_t n = 0; n < neighbours.count; n++)
+					{
+						const uint32_t direction = neighbours.directions[n];
+						const size_t neighbour = index + grid.offset(direction);
+						if ((pp->frontier_bits[neighbour >> 6].load(std::memory_order_relaxed) >> (neighbour & 63)) & 1)
+						{
+							pp->visits[index].store(visited | direction, std::memory_order_relaxed);
+							bits |= 1ull << (index & 63);
+							next->push_back((uint32_t)index);
+							break;
+						}
+					}
+				}
+
+				pp->next_bits[word].store(bits, std::memory_order_relaxed);
+			}
+			break;
+
+		case path_parallel_job_clear_bits:
+			for (size_t word = begin; word < end; word++)
+				pp->frontier_bits[word].store(0, std::memory_order_relaxed);
+			break;
+
+		case path_parallel_job_mark_bits:
+			for (size_t i = begin; i < end; i++)
+			{
+				const uint32_t index = pp->frontier[i];
+				pp->frontier_bits[index >> 6].fetch_or(1ull << (index & 63), std::memory_order_relaxed);
+			}
+			break;
+		}
+	}
+}
+
+static void path_parallel_worker(path_parallel* pp, uint32_t thread_index)
+{
+	uint32_t generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(pp->mutex);
+			pp->job_start.wait(lock, [&]() { return pp->quit || pp->job_generation != generation; });
+			if (pp->quit)
+				return;
+			generation = pp->job_generation;
+		}
+
+		path_parallel_work(pp, thread_index);
+
+		std::lock_guard<std::mutex> lock(pp->mutex);
+		if (--pp->job_running == 0)
+			pp->job_done.notify_one();
+	}
+}
+
+// Runs a job to completion, on every thread or only the calling one
+static void path_parallel_run(path_parallel* pp, path_parallel_job job, bool parallel)
+{
+	pp->job = job;
+	pp->job_cursor.store(0, std::memory_order_relaxed);
+
+	if (!parallel || pp->workers.empty())
+	{
+		path_parallel_work(pp, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(pp->mutex);
+		pp->job_generation++;
+		pp->job_running = (uint32_t)pp->workers.size();
+	}
+	pp->job_start.notify_all();
+
+	path_parallel_work(pp, 0);
+
+	std::unique_lock<std::mutex> lock(pp->mutex);
+	pp->job_done.wait(lock, [&]() { return pp->job_running == 0; });
+}
+
+void path_parallel_init(path_parallel* pp, const tile_grid* grid, uint32_t thread_count)
+{
+	alloc_tag("path_parallel");
+
+	assert(thread_count >= 1 && thread_count <= path_parallel_max_threads);
+
+	const size_t tile_count = (size_t)grid->width * grid->height;
+
+	pp->grid = grid;
+	pp->thread_count = thread_count;
+	pp->open_count = 0;
+	for (size_t i = 0; i < tile_count; i++)
+		pp->open_count += grid->tiles[i] != tile_flags_wall;
+
+	pp->visits = new std::atomic<uint32_t>[tile_count];
+	for (size_t i = 0; i < tile_count; i++)
+		pp->visits[i].store(0, std::memory_order_relaxed);
+	pp->search = 0;
+
+	pp->bit_words = (tile_count + 63) / 64;
+	pp->frontier_bits = new std::atomic<uint64_t>[pp->bit_words];
+	pp->next_bits = new std::atomic<uint64_t>[pp->bit_words];
+
+	pp->frontier.clear();
+	pp->next.clear();
+	pp->next.resize(thread_count);
+	pp->levels = 0;
+	pp->parallel_levels = 0;
+	pp->bottom_up_levels = 0;
+
+	pp->job_generation = 0;
+	pp->job_running = 0;
+	pp->quit = false;
+	pp->workers.clear();
+	for (uint32_t i = 1; i < thread_count; i++)
+		pp->workers.emplace_back(path_parallel_worker, pp, i);
+}
+
+void path_parallel_term(path_parallel* pp)
+{
+	{
+		std::lock_guard<std::mutex> lock(pp->mutex);
+		pp->quit = true;
+	}
+	pp->job_start.notify_all();
+
+	for (std::thread& worker : pp->workers)
+		worker.join();
+	std::vector<std::thread>().swap(pp->workers);
+
+	delete[] pp->visits;
+	delete[] pp->frontier_bits;
+	delete[] pp->next_bits;
+	pp->visits = nullptr;
+	pp->frontier_bits = pp->next_bits = nullptr;
+
+	std::vector<uint32_t>().swap(pp->frontier);
+	std::vector<std::vector<uint32_t>>().swap(pp->next);
+}
+
+bool path_parallel_find(path_parallel* pp, const path_query* query, std::vector<tile_pos>* path, path_stats* stats)
+{
+	alloc_tag("path_parallel");
+
+	path_stats local_stats;
+	if (!stats)
+		stats = &local_stats;
+
+	*stats = {};
+	path->clear();
+	pp->levels = 0;
+	pp->parallel_levels = 0;
+	pp->bottom_up_levels = 0;
+
+	if (tile_grid_get(pp->grid, query->start.x, query->start.y) == tile_flags_wall ||
+		tile_grid_get(pp->grid, query->goal.x, query->goal.y) == tile_flags_wall)
+		return false;
+
+	const grid_dynamic grid(pp->grid);
+	const size_t tile_count = (size_t)pp->grid->width * pp->grid->height;
+	const uint32_t start = grid.index(query->start);
+	const uint32_t goal = grid.index(query->goal);
+
+	// Search ids share the visit word with the parent direction, so they wrap after 2^30 queries
+	if (++pp->search == (1u << 30))
+	{
+		for (size_t i = 0; i < tile_count; i++)
+			pp->visits[i].store(0, std::memory_order_relaxed);
+		pp->search = 1;
+	}
+	const uint32_t visited = pp->search << 2;
+
+	pp->visits[start].store(visited, std::memory_order_relaxed);
+	pp->frontier.assign(1, start);
+	stats->nodes_generated = 1;
+
+	uint32_t total_visited = 1;
+	bool bottom_up = false;
+
+	while (!pp->frontier.empty() && (pp->visits[goal].load(std::memory_order_relaxed) & ~3u) != visited)
+	{
+		const size_t frontier_size = pp->frontier.size();
+		const bool parallel = frontier_size >= path_parallel_min_frontier;
+
+		// Bottom-up needs the frontier as a bitmap, which bottom-up levels leave behind themselves
+		const bool want_bottom_up = bottom_up ? frontier_size >= pp->open_count / path_parallel_beta : frontier_size > (pp->open_count - total_visited) / path_parallel_alpha;
+		if (want_bottom_up && !bottom_up)
+		{
+			path_parallel_run(pp, path_parallel_job_clear_bits, true);
+			path_parallel_run(pp, path_parallel_job_mark_bits, parallel);
+		}
+		bottom_up = want_bottom_up;
+
+		for (std::vector<uint32_t>& next : pp->next)
+			next.clear();
+
+		path_parallel_run(pp, bottom_up ? path_parallel_job_bottom_up : path_parallel_job_top_down, bottom_up || parallel);
+
+		stats->nodes_expanded += (uint32_t)frontier_size;
+		pp->levels++;
+		pp->parallel_levels += (bottom_up || parallel) && !pp->workers.empty();
+		pp->bottom_up_levels += bottom_up;
+		if (bottom_up)
+			std::swap(pp->frontier_bits, pp->next_bits);
+
+		pp->frontier.clear();
+		for (const std::vector<uint32_t>& next : pp->next)
+			pp->frontier.insert(pp->frontier.end(), next.begin(), next.end());
+
+		total_visited += (uint32_t)pp->frontier.size();
+		stats->nodes_generated += (uint32_t)pp->frontier.size();
+	}
+
+	if ((pp->visits[goal].load(std::memory_order_relaxed) & ~3u) != visited)
+		return false;
+
+	// Every level is one move, so the goal's level is the path cost
+	for (uint32_t index = goal;; index += grid.offset(pp->visits[index].load(std::memory_order_relaxed) & 3))
+	{
+		path->push_back(grid.pos(index));
+		if (index == start)
+			break;
+	}
+	std::reverse(path->begin(), path->end());
+
+	stats->cost = pp->levels;
+	return true;
+}
\ No newline at end of file
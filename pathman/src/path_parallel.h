@@ -0,0 +1,73 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*
+	Multi-threaded breadth first search for single long queries on very large maps.
+
+	Every move costs the same, so a breadth first search run level by level finds shortest paths
+	and each level can be shared between threads. Levels run one of two ways, switching on the
+	frontier size as in direction optimising BFS:
+
+		Top-down	Threads take chunks of the frontier list and visit the neighbours of each tile.
+					Tiles are claimed with a compare and swap on their visit word, so a tile
+					reached from two frontier tiles at once joins the next frontier only once.
+		Bottom-up	Threads take chunks of every tile on the map and each unvisited tile looks for
+					a neighbour in the frontier bitmap. This touches the whole map but needs no
+					atomics, and wins once the frontier is a large part of what is left to visit.
+
+	Levels with small frontiers, which is all of them in narrow mazes, run on the calling thread
+	alone as waking the workers would cost more than the level. Neighbours come from the
+	tile_flags bits through the same lookup table as the other searches.
+*/
+constexpr uint32_t path_parallel_max_threads = 64;
+
+enum path_parallel_job : uint8_t
+{
+	path_parallel_job_top_down,
+	path_parallel_job_bottom_up,
+	path_parallel_job_clear_bits,
+	path_parallel_job_mark_bits,
+};
+
+struct path_parallel
+{
+	const tile_grid*					grid;
+	uint32_t							thread_count;		// Including the calling thread
+	uint32_t							open_count;			// Walkable tiles on the map
+	std::atomic<uint32_t>*				visits;				// Per tile, search id above the tile_direction back to the parent
+	uint32_t							search;
+	std::vector<uint32_t>				frontier;
+	std::vector<std::vector<uint32_t>>	next;				// Tiles reached in the current level, one list per thread
+	std::atomic<uint64_t>*				frontier_bits;		// Frontier as one bit per tile, for bottom-up levels
+	std::atomic<uint64_t>*				next_bits;
+	size_t								bit_words;
+
+	// Last query
+	uint32_t							levels;
+	uint32_t							parallel_levels;	// Levels shared with the worker threads
+	uint32_t							bottom_up_levels;
+
+	// Worker threads wait for a job, all threads take chunks of it until none are left
+	std::vector<std::thread>			workers;
+	std::mutex							mutex;
+	std::condition_variable				job_start;
+	std::condition_variable				job_done;
+	uint32_t							job_generation;
+	uint32_t							job_running;		// Workers still working on the current job
+	bool								quit;
+	path_parallel_job					job;
+	std::atomic<size_t>					job_cursor;
+};
+
+// Thread count includes the caller, so one runs every level on the calling thread
+void path_parallel_init(path_parallel* pp, const tile_grid* grid, uint32_t thread_count);
+void path_parallel_term(path_parallel* pp);
+
+/*
+	Finds a shortest path for the query, ignoring its mode. On success the path holds every tile
+	from start to goal inclusive and true is returned. Stats are optional, nodes expanded counts
+	every tile visited.
+*/
+bool path_parallel_find(path_parallel* pp, const path_query* query, std::vector<tile_pos>* path, path_stats* stats);
\ No newline at end of file
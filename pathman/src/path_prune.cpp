@@ -0,0 +1,323 @@
+// Set in exits for tiles pruned as swamps, so updates can keep the per-rule counts
+constexpr uint8_t path_prune_swamp_bit = 0x80;
+
+enum path_prune_rule : uint8_t
+{
+	path_prune_keep,
+	path_prune_dead_end,
+	path_prune_swamp
+};
+
+static void path_prune_set(path_prune* prune, uint32_t index, bool pruned)
+{
+	const uint64_t bit = 1ull << (index & 63);
+	if (pruned)
+		prune->pruned[index >> 6] |= bit;
+	else
+		prune->pruned[index >> 6] &= ~bit;
+}
+
+static bool path_prune_present(const path_prune* prune, uint32_t index)
+{
+	return prune->grid->tiles[index] != tile_flags_wall && !path_prune_is_pruned(prune, index);
+}
+
+// Open bits of the tile toward neighbours that have not been pruned
+static uint8_t path_prune_open(const path_prune* prune, const grid_dynamic& grid, uint32_t index)
+{
+	const tile_neighbours& neighbours = tile_neighbours_of(grid.tiles[index]);
+
+	uint8_t open = 0;
+	for (uint32_t i = 0; i < neighbours.count; i++)
+	{
+		const uint32_t direction = neighbours.directions[i];
+		if (!path_prune_is_pruned(prune, index + grid.offset(direction)))
+			open |= 1 << direction;
+	}
+
+	return open;
+}
+
+static path_prune_rule path_prune_rule_for(const path_prune* prune, const grid_dynamic& grid, uint32_t index, uint8_t open)
+{
+	const uint8_t vertical = open & (tile_flags_open_up | tile_flags_open_down);
+	const uint8_t horizontal = open & (tile_flags_open_left | tile_flags_open_right);
+
+	if (!vertical || !horizontal)
+		return (vertical & (vertical - 1)) || (horizontal & (horizontal - 1)) ? path_prune_keep : path_prune_dead_end;
+
+	// Three or more neighbours always include an opposite pair, which has no way round
+	if ((vertical & (vertical - 1)) || (horizontal & (horizontal - 1)))
+		return path_prune_keep;
+
+	const uint32_t v = path_bit_scan(vertical);
+	const uint32_t h = path_bit_scan(horizontal);
+	const uint32_t a = index + grid.offset(v);
+	const uint32_t b = index + grid.offset(h);
+	const uint32_t corner = a + grid.offset(h);
+
+	if (path_prune_present(prune, corner) && (grid.tiles[a] & (1 << h)) && (grid.tiles[b] & (1 << v)))
+		return path_prune_swamp;
+
+	return path_prune_keep;
+}
+
+/*
+	Prunes tiles from the work list until no rule applies. Pruning a tile can only make its
+	remaining neighbours prunable, so those go back on the list.
+*/
+static void path_prune_run(path_prune* prune, const grid_dynamic& grid, frame_vector<uint32_t>* pruned = nullptr)
+{
+	while (!prune->work.empty())
+	{
+		const uint32_t index = prune->work.back();
+		prune->work.pop_back();
+
+		if (!path_prune_present(prune, index))
+			continue;
+
+		const uint8_t open = path_prune_open(prune, grid, index);
+		const path_prune_rule rule = path_prune_rule_for(prune, grid, index, open);
+		if (rule == path_prune_keep)
+			continue;
+
+		path_prune_set(prune, index, true);
+		prune->exits[index] = open | (rule == path_prune_swamp ? path_prune_swamp_bit : 0);
+		if (rule == path_prune_dead_end)
+			prune->dead_end_count++;
+		else
+			prune->swamp_count++;
+
+		if (pruned)
+			pruned->push_back(index);
+
+		const tile_neighbours& neighbours = tile_neighbours_of(open);
+		for (uint32_t i = 0; i < neighbours.count; i++)
+			prune->work.push_back(index + grid.offset(neighbours.directions[i]));
+	}
+}
+
+static void path_prune_update_tile(path_prune* prune, const grid_dynamic& grid, uint32_t index)
+{
+	prune->tiles[index] = path_prune_present(prune, index) ? path_prune_open(prune, grid, index) : tile_flags_wall;
+}
+
+void path_prune_build(path_prune* prune, const tile_grid* grid)
+{
+	alloc_tag("path_prune");
+
+	const grid_dynamic dynamic(grid);
+	const uint32_t tile_count = (uint32_t)(grid->width * grid->height);
+
+	prune->grid = grid;
+	prune->pruned.assign((tile_count + 63) / 64, 0);
+	prune->exits.assign(tile_count, 0);
+	prune->tiles.assign(grid->tiles, grid->tiles + tile_count);
+	prune->dead_end_count = 0;
+	prune->swamp_count = 0;
+	prune->version++;
+
+	// Reversed so the work list pops tiles in row-major order
+	prune->work.clear();
+	for (uint32_t index = tile_count; index-- > 0;)
+	{
+		if (grid->tiles[index] != tile_flags_wall)
+			prune->work.push_back(index);
+	}
+
+	path_prune_run(prune, dynamic);
+
+	for (uint32_t index = 0; index < tile_count; index++)
+		path_prune_update_tile(prune, dynamic, index);
+}
+
+void path_prune_term(path_prune* prune)
+{
+	std::vector<uint64_t>().swap(prune->pruned);
+	std::vector<uint8_t>().swap(prune->exits);
+	std::vector<uint8_t>().swap(prune->tiles);
+	std::vector<uint32_t>().swap(prune->work);
+}
+
+/*
+	A pruned tile's rule only looked at its four neighbours and the four diagonal tiles, so a wall
+	change can only invalidate pruned tiles within one tile of it. Those are restored along with
+	every pruned tile 4-connected to them, as a restored tile changes its pruned neighbours'
+	neighbour counts in turn. Restoring only ever adds tiles back, which cannot break the corner
+	a swamp tile elsewhere relied on, so the rest of the pruning stays valid and the restored area
+	is simply pruned again.
+*/
+void path_prune_update(path_prune* prune, int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y)
+{
+	alloc_tag("path_prune");
+
+	const tile_grid* grid = prune->grid;
+	const grid_dynamic dynamic(grid);
+
+	min_x = std::max(min_x - 1, 0);
+	min_y = std::max(min_y - 1, 0);
+	max_x = std::min(max_x + 1, grid->width - 1);
+	max_y = std::min(max_y + 1, grid->height - 1);
+
+	// Tile lists only live for this update, so they go in the thread's scratch arena if it has one
+	frame_arena_scope scratch(frame_scratch());
+
+	// Walls inside the rectangle may have opened or closed, recount those and unprune any new walls
+	frame_vector<uint32_t> restored{frame_allocator<uint32_t>(scratch.arena)};
+	for (int32_t y = min_y; y <= max_y; y++)
+	{
+		for (int32_t x = min_x; x <= max_x; x++)
+		{
+			const uint32_t index = dynamic.index({x, y});
+			if (path_prune_is_pruned(prune, index))
+			{
+				path_prune_set(prune, index, false);
+				restored.push_back(index);
+			}
+		}
+	}
+
+	// Flood out through pruned tiles, by position as the walls between them may have changed
+	for (size_t i = 0; i < restored.size(); i++)
+	{
+		const tile_pos pos = dynamic.pos(restored[i]);
+		for (uint32_t direction = 0; direction < 4; direction++)
+		{
+			const tile_pos next = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+			if (next.x < 0 || next.y < 0 || next.x >= grid->width || next.y >= grid->height)
+				continue;
+
+			const uint32_t index = dynamic.index(next);
+			if (path_prune_is_pruned(prune, index))
+			{
+				path_prune_set(prune, index, false);
+				restored.push_back(index);
+			}
+		}
+	}
+
+	for (uint32_t index : restored)
+	{
+		if (prune->exits[index] & path_prune_swamp_bit)
+			prune->swamp_count--;
+		else
+			prune->dead_end_count--;
+	}
+
+	// Restored tiles, and tiles next to or diagonal to them, may be prunable now
+	const size_t restored_count = restored.size();
+	for (int32_t y = min_y; y <= max_y; y++)
+	{
+		for (int32_t x = min_x; x <= max_x; x++)
+			restored.push_back(dynamic.index({x, y}));
+	}
+
+	prune->work.clear();
+	for (uint32_t index : restored)
+	{
+		const tile_pos pos = dynamic.pos(index);
+		for (int32_t y = std::max(pos.y - 1, 0); y <= std::min(pos.y + 1, grid->height - 1); y++)
+		{
+			for (int32_t x = std::max(pos.x - 1, 0); x <= std::min(pos.x + 1, grid->width - 1); x++)
+				prune->work.push_back(dynamic.index({x, y}));
+		}
+	}
+
+	frame_vector<uint32_t> changed{frame_allocator<uint32_t>(scratch.arena)};
+	path_prune_run(prune, dynamic, &changed);
+	changed.insert(changed.end(), restored.begin(), restored.begin() + restored_count);
+
+	// Tiles whose own state or a neighbour's changed need their pruned flags rebuilt
+	for (uint32_t index : restored)
+		path_prune_update_tile(prune, dynamic, index);
+
+	for (uint32_t index : changed)
+	{
+		path_prune_update_tile(prune, dynamic, index);
+
+		const tile_pos pos = dynamic.pos(index);
+		for (uint32_t direction = 0; direction < 4; direction++)
+		{
+			const tile_pos next = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+			if (next.x >= 0 && next.y >= 0 && next.x < grid->width && next.y < grid->height)
+				path_prune_update_tile(prune, dynamic, dynamic.index(next));
+		}
+	}
+
+	prune->version++;
+}
+
+void path_finder_set_prune(path_finder* pf, const path_prune* prune)
+{
+	alloc_tag("path_prune");
+
+	assert(!prune || prune->grid == pf->grid);
+
+	pf->prune = prune;
+	pf->prune_version = 0;
+	pf->prune_patched.clear();
+
+	free(pf->prune_tiles);
+	pf->prune_tiles = prune ? (uint8_t*)malloc(prune->tiles.size()) : nullptr;
+	if (prune)
+	{
+		memcpy(pf->prune_tiles, prune->tiles.data(), prune->tiles.size());
+		pf->prune_version = prune->version;
+	}
+}
+
+/*
+	Undoes the last query's patches, or recopies the pruned flags if the pruning has changed, then
+	opens the exit edges reachable from both ends of the query.
+*/
+bool path_finder_prune_query(path_finder* pf, const path_query* query)
+{
+	const path_prune* prune = pf->prune;
+	const grid_dynamic grid(pf->grid);
+
+	if (pf->prune_version != prune->version)
+	{
+		memcpy(pf->prune_tiles, prune->tiles.data(), prune->tiles.size());
+		pf->prune_version = prune->version;
+	}
+	else
+	{
+		for (uint32_t index : pf->prune_patched)
+			pf->prune_tiles[index] = prune->tiles[index];
+	}
+	pf->prune_patched.clear();
+
+	for (tile_pos end : {query->start, query->goal})
+	{
+		const uint32_t index = grid.index(end);
+		if (path_prune_is_pruned(prune, index))
+			pf->prune_patched.push_back(index);
+	}
+
+	// Patched tiles double as the work list, a pruned tile is expanded when first reached
+	uint32_t swamps = 0;
+	for (size_t i = 0; i < pf->prune_patched.size(); i++)
+	{
+		const uint32_t index = pf->prune_patched[i];
+		const uint8_t exits = prune->exits[index] & 0xF;
+		if (!path_prune_is_pruned(prune, index) || (pf->prune_tiles[index] & exits) == exits)
+			continue;
+
+		// Patches made so far are still undone by the next query
+		if ((prune->exits[index] & path_prune_swamp_bit) && ++swamps > path_prune_max_swamps)
+			return false;
+
+		pf->prune_tiles[index] |= exits;
+
+		const tile_neighbours& neighbours = tile_neighbours_of(exits);
+		for (uint32_t n = 0; n < neighbours.count; n++)
+		{
+			const uint32_t direction = neighbours.directions[n];
+			const uint32_t next = index + grid.offset(direction);
+			pf->prune_tiles[next] |= 1 << (direction ^ 1);
+			pf->prune_patched.push_back(next);
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+/*
+	Dead-end and swamp pruning, a preprocessing pass that walls off tiles no shortest path needs
+	unless it starts or ends there.
+
+	Tiles are removed one at a time while either rule holds for what is left of the map:
+
+		Dead end	At most one open neighbour remains. Stripping these repeatedly removes every
+					branch that only leads back the way it came.
+		Swamp		Exactly two open neighbours remain, at right angles, and the tile diagonally
+					between them is open to both. Any path through the tile can cut that corner
+					instead at the same cost, so peeling these empties open rooms down to the tiles
+					that join their doorways.
+
+	Neither rule changes the distance between any two tiles that remain, so searches over the
+	remaining tiles find paths just as short. Each removed tile keeps the neighbours it still had
+	when it went (its exits). Every tile that a shortest path from a removed tile needs can be
+	reached by following exits, so a query reopens the exit edges reachable from its start and
+	goal, and leaves everything else pruned.
+
+	path_finder_set_prune makes path_find search the pruned map. The finder keeps a copy of the
+	pruned tile flags and patches the exit edges into it for each query, so the search loop is
+	unchanged and pruned tiles simply look like walls. Exits from a dead end form a single chain
+	back to the rest of the map, but in wide open areas nearly every tile is a swamp and the exits
+	from one tile can fan out over most of the room. A query that would reopen more than
+	path_prune_max_swamps swamp tiles searches the full grid instead.
+*/
+constexpr uint32_t path_prune_max_swamps = 2048;
+
+struct path_prune
+{
+	const tile_grid*		grid;
+	std::vector<uint64_t>	pruned;				// Side bitmap, one bit per tile
+	std::vector<uint8_t>	exits;				// tile_flags bits of the neighbours each pruned tile had left
+	std::vector<uint8_t>	tiles;				// The grid's tile_flags with pruned tiles and the edges into them closed
+	uint32_t				dead_end_count;		// Pruned by each rule
+	uint32_t				swamp_count;
+	uint32_t				version;			// Bumped by every change so finders know to refresh their copy
+	std::vector<uint32_t>	work;
+};
+
+void path_prune_build(path_prune* prune, const tile_grid* grid);
+void path_prune_term(path_prune* prune);
+
+/*
+	Call after changing walls inside the rectangle (inclusive), with the grid's tile_flags already
+	updated. Pruned regions touching the change are restored and pruned again, the rest of the map
+	is left alone.
+*/
+void path_prune_update(path_prune* prune, int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y);
+
+inline bool path_prune_is_pruned(const path_prune* prune, uint32_t index)
+{
+	return (prune->pruned[index >> 6] >> (index & 63)) & 1;
+}
+
+inline uint32_t path_prune_count(const path_prune* prune)
+{
+	return prune->dead_end_count + prune->swamp_count;
+}
+
+// Makes path_find search the pruned map, nullptr to search the full grid again
+void path_finder_set_prune(path_finder* pf, const path_prune* prune);
+
+/*
+	Called by path_find at the start of each query on a finder with pruning set. Returns false if
+	the query reopens too many tiles and should search the full grid.
+*/
+bool path_finder_prune_query(path_finder* pf, const path_query* query);
\ No newline at end of file
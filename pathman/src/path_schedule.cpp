@@ -0,0 +1,170 @@
+static void path_schedule_complete(path_schedule* ps, path_schedule_slot* slot, path_status status)
+{
+	path_agent* agent = &ps->agents[slot->agent];
+
+	// A failed search leaves the last path in place for the agent to keep following
+	if (status == path_status_found)
+		agent->path = slot->path;
+
+	agent->status = status;
+	agent->has_pending = false;
+	agent->slot = path_schedule_none;
+	agent->latency = ps->frame - agent->requested_frame;
+	slot->agent = path_schedule_none;
+}
+
+// Starts the agent's pending query in the slot, finishing it straight away if it cannot succeed
+static void path_schedule_start(path_schedule* ps, uint32_t slot_index, uint32_t agent_index)
+{
+	path_schedule_slot* slot = &ps->slots[slot_index];
+	path_agent* agent = &ps->agents[agent_index];
+
+	slot->agent = agent_index;
+	agent->slot = slot_index;
+
+	if (path_find_begin(&slot->finder, &agent->pending, &slot->path, &slot->stats) == path_status_failed)
+		path_schedule_complete(ps, slot, path_status_failed);
+}
+
+// Fills free slots from the waiting queue, oldest request first
+static void path_schedule_fill(path_schedule* ps)
+{
+	uint32_t i = 0;
+	while (i < ps->slots.size() && ps->waiting_count)
+	{
+		if (ps->slots[i].agent != path_schedule_none)
+		{
+			i++;
+			continue;
+		}
+
+		// A query that fails immediately leaves the slot free for the next one
+		const uint32_t agent = ps->waiting[ps->waiting_head];
+		ps->waiting_head = (ps->waiting_head + 1) % (uint32_t)ps->waiting.size();
+		ps->waiting_count--;
+		path_schedule_start(ps, i, agent);
+	}
+}
+
+static double path_schedule_time_us()
+{
+	using namespace std::chrono;
+	return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+void path_schedule_init(path_schedule* ps, const tile_grid* grid, const path_landmarks* landmarks, uint32_t slot_count, uint32_t agent_count, uint32_t slice_expansions)
+{
+	assert(slot_count > 0 && slice_expansions > 0);
+	alloc_tag("path_schedule");
+
+	ps->slots.resize(slot_count);
+	for (path_schedule_slot& slot : ps->slots)
+	{
+		path_finder_init(&slot.finder, grid);
+		slot.finder.landmarks = landmarks;
+		slot.stats = {};
+		slot.agent = path_schedule_none;
+	}
+
+	ps->agents.resize(agent_count);
+	for (path_agent& agent : ps->agents)
+	{
+		path_packed_clear(&agent.path, {0, 0});
+		agent.status = path_status_searching;
+		agent.pending = {};
+		agent.has_pending = false;
+		agent.slot = path_schedule_none;
+		agent.requested_frame = 0;
+		agent.latency = 0;
+	}
+
+	ps->waiting.resize(agent_count);
+	ps->waiting_head = 0;
+	ps->waiting_count = 0;
+	ps->slice_expansions = slice_expansions;
+	ps->cursor = 0;
+	ps->frame = 0;
+}
+
+void path_schedule_term(path_schedule* ps)
+{
+	for (path_schedule_slot& slot : ps->slots)
+		path_finder_term(&slot.finder);
+
+	std::vector<path_schedule_slot>().swap(ps->slots);
+	std::vector<path_agent>().swap(ps->agents);
+	std::vector<uint32_t>().swap(ps->waiting);
+}
+
+void path_schedule_request(path_schedule* ps, uint32_t agent_index, const path_query* query)
+{
+	alloc_tag("path_schedule");
+
+	path_agent* agent = &ps->agents[agent_index];
+
+	const bool was_pending = agent->has_pending;
+	agent->pending = *query;
+	agent->has_pending = true;
+	agent->requested_frame = ps->frame;
+
+	if (agent->slot != path_schedule_none)
+		path_schedule_start(ps, agent->slot, agent_index);
+	else if (!was_pending)
+	{
+		ps->waiting[(ps->waiting_head + ps->waiting_count) % ps->waiting.size()] = agent_index;
+		ps->waiting_count++;
+	}
+}
+
+uint32_t path_schedule_update(path_schedule* ps, uint32_t max_expansions, double max_us)
+{
+	alloc_tag("path_schedule");
+
+	const double begin_us = path_schedule_time_us();
+	const uint32_t slot_count = (uint32_t)ps->slots.size();
+	uint32_t expansions = 0;
+
+	path_schedule_fill(ps);
+
+	/*
+		Hand out one slice at a time, moving on to the next slot after each. Idle slots are skipped
+		and the loop ends once a whole lap finds nothing to run.
+	*/
+	for (uint32_t idle = 0; idle < slot_count && expansions < max_expansions; ps->cursor = (ps->cursor + 1) % slot_count)
+	{
+		path_schedule_slot* slot = &ps->slots[ps->cursor];
+		if (slot->agent == path_schedule_none)
+		{
+			idle++;
+			continue;
+		}
+		idle = 0;
+
+		const uint32_t before = slot->stats.nodes_expanded;
+		const uint32_t budget = std::min(ps->slice_expansions, max_expansions - expansions);
+		const path_status status = path_find_step(&slot->finder, budget, &slot->path, &slot->stats);
+		expansions += slot->stats.nodes_expanded - before;
+
+		// An anytime search hands over each path it finds but keeps its slot until the path is the shortest
+		if (status == path_status_improving)
+		{
+			path_agent* agent = &ps->agents[slot->agent];
+			agent->path = slot->path;
+			agent->status = status;
+		}
+		else if (status != path_status_searching)
+		{
+			path_schedule_complete(ps, slot, status);
+			path_schedule_fill(ps);
+		}
+
+		if (path_schedule_time_us() - begin_us >= max_us)
+		{
+			ps->cursor = (ps->cursor + 1) % slot_count;
+			break;
+		}
+	}
+
+	ps->frame++;
+	return expansions;
+}
\ No newline at end of file
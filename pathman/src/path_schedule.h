@@ -0,0 +1,70 @@
+#include <chrono>
+
+/*
+	Shares a per-frame pathfinding budget between many agents.
+
+	Agents request paths at any time and path_schedule_update is called once a frame to advance the
+	searches. A fixed pool of finders runs the requests in the order they arrived, and the budget is
+	handed out in equal slices of node expansions, round robin over the running searches, so one
+	long query cannot hold up every other agent. Each agent keeps its last path until a new one is
+	found, so it always has something to follow, and its status tells whether the latest search
+	failed. Anytime queries hand over each path they find straight away and keep improving it with
+	whatever budget is left.
+*/
+constexpr uint32_t path_schedule_none = UINT32_MAX;
+
+struct path_agent
+{
+	path_packed				path;				// Last path found, kept when a later search fails, no moves before the first
+	path_status				status;				// Result of the last completed search, searching before the first, improving while an anytime search runs on
+	path_query				pending;			// Query waiting for or running in a finder
+	bool					has_pending;
+	uint32_t				slot;				// Finder slot running the pending query, or path_schedule_none
+	uint32_t				requested_frame;	// Frame the pending query was requested on
+	uint32_t				latency;			// Frames from request to completion of the last completed search
+};
+
+struct path_schedule_slot
+{
+	path_finder				finder;
+	path_stats				stats;
+	path_packed				path;		// Written by the search, copied to the agent on completion
+	uint32_t				agent;		// Agent being searched for, or path_schedule_none
+};
+
+struct path_schedule
+{
+	std::vector<path_schedule_slot>	slots;
+	std::vector<path_agent>			agents;
+	std::vector<uint32_t>			waiting;			// Ring of agents whose pending query has no slot yet, oldest first
+	uint32_t						waiting_head;		// Oldest entry in the ring, an agent is queued at most once
+	uint32_t						waiting_count;		// so it never holds more than agent_count entries
+	uint32_t						slice_expansions;	// Expansions given to a search before moving to the next
+	uint32_t						cursor;				// Slot the next slice goes to, carried across frames
+	uint32_t						frame;
+};
+
+/*
+	slot_count is the number of searches that can be in progress at once, each slot owns a finder
+	with its own node arrays for the grid. Landmarks are optional.
+*/
+void path_schedule_init(path_schedule* ps, const tile_grid* grid, const path_landmarks* landmarks, uint32_t slot_count, uint32_t agent_count, uint32_t slice_expansions);
+void path_schedule_term(path_schedule* ps);
+
+/*
+	Requests a new path for the agent. A request that has not completed yet is replaced, and restarted
+	in place if it was already running.
+*/
+void path_schedule_request(path_schedule* ps, uint32_t agent, const path_query* query);
+
+/*
+	Advances pending searches until either max_expansions nodes have been expanded or max_us
+	microseconds have passed, whichever comes first. The time is checked between slices, so the
+	overshoot is bounded by one slice. Returns the number of nodes expanded.
+*/
+uint32_t path_schedule_update(path_schedule* ps, uint32_t max_expansions, double max_us);
+
+inline bool path_schedule_pending(const path_schedule* ps, uint32_t agent)
+{
+	return ps->agents[agent].has_pending;
+}
\ No newline at end of file
@@ -0,0 +1,427 @@
+/*
+	Compile-time specialised grid search.
+
+	path_search runs A* with the map type and search rules supplied as policies, so the compiler
+	generates a separate hot loop for each combination with the index math and estimates inlined:
+
+		Grid		Tile indexing and neighbour steps. grid_static fixes the dimensions at compile
+					time, turning the index math into shifts and masks for power of two widths, while
+					grid_dynamic reads them from a tile_grid at runtime. Both index tiles row-major,
+					see grid_layout.h for orders that keep vertical neighbours closer in memory.
+		Heuristic	Estimated number of moves from a tile to the target.
+		Cost		Cost of entering a tile. min_step is the cheapest possible move and scales the
+					heuristic so it stays admissible.
+		Goal		Whether an expanded tile ends the search, a single tile or for example any tile
+					of a set.
+
+	Neighbours are decoded from the tile_flags bits through a 16 entry lookup table rather than
+	testing each direction in turn.
+*/
+struct tile_neighbours
+{
+	uint8_t count;
+	uint8_t directions[4];	// tile_direction of each open side, in bit order
+};
+
+struct tile_neighbour_lut
+{
+	tile_neighbours entries[16];
+};
+
+constexpr tile_neighbour_lut tile_neighbour_lut_build()
+{
+	tile_neighbour_lut lut = {};
+	for (uint32_t flags = 0; flags < 16; flags++)
+	{
+		for (uint8_t direction = 0; direction < 4; direction++)
+		{
+			if (flags & (1 << direction))
+				lut.entries[flags].directions[lut.entries[flags].count++] = direction;
+		}
+	}
+
+	return lut;
+}
+
+constexpr tile_neighbour_lut tile_neighbour_table = tile_neighbour_lut_build();
+
+inline const tile_neighbours& tile_neighbours_of(uint8_t tile)
+{
+	return tile_neighbour_table.entries[tile & 0xF];
+}
+
+constexpr uint32_t path_log2(uint32_t value)
+{
+	return value > 1 ? 1 + path_log2(value >> 1) : 0;
+}
+
+// Index of the lowest set bit, bits must not be zero
+inline uint32_t path_bit_scan(uint64_t bits)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return (uint32_t)index;
+#else
+	return (uint32_t)__builtin_ctzll(bits);
+#endif
+}
+
+/*
+	Grid policies
+*/
+template<int32_t Width, int32_t Height>
+struct grid_static
+{
+	static constexpr int32_t	width = Width;
+	static constexpr int32_t	height = Height;
+	static constexpr bool		pow2_width = (Width & (Width - 1)) == 0;
+	static constexpr uint32_t	width_shift = path_log2(Width);
+
+	const uint8_t* tiles;
+
+	explicit grid_static(const tile_grid* grid) : tiles(grid->tiles)
+	{
+		assert(grid->width == Width && grid->height == Height);
+	}
+
+	static constexpr uint32_t index(tile_pos pos)
+	{
+		if constexpr (pow2_width)
+			return ((uint32_t)pos.y << width_shift) | (uint32_t)pos.x;
+		else
+			return (uint32_t)((pos.y * Width) + pos.x);
+	}
+
+	static constexpr tile_pos pos(uint32_t index)
+	{
+		if constexpr (pow2_width)
+			return {(int32_t)(index & (Width - 1)), (int32_t)(index >> width_shift)};
+		else
+			return {(int32_t)(index % Width), (int32_t)(index / Width)};
+	}
+
+	static constexpr int32_t offset(uint32_t direction)
+	{
+		constexpr int32_t offsets[4] = {-Width, Width, -1, 1};
+		return offsets[direction];
+	}
+
+	static constexpr uint32_t neighbour(uint32_t index, uint32_t direction)
+	{
+		return index + offset(direction);
+	}
+};
+
+struct grid_dynamic
+{
+	const uint8_t*	tiles;
+	int32_t			width;
+	int32_t			offsets[4];
+
+	explicit grid_dynamic(const tile_grid* grid) : tiles(grid->tiles), width(grid->width), offsets{-grid->width, grid->width, -1, 1}
+	{
+	}
+
+	uint32_t index(tile_pos pos) const
+	{
+		return (uint32_t)((pos.y * width) + pos.x);
+	}
+
+	tile_pos pos(uint32_t index) const
+	{
+		return {(int32_t)(index % width), (int32_t)(index / width)};
+	}
+
+	int32_t offset(uint32_t direction) const
+	{
+		return offsets[direction];
+	}
+
+	uint32_t neighbour(uint32_t index, uint32_t direction) const
+	{
+		return index + offsets[direction];
+	}
+};
+
+// Open directions of a tile as a search sees them, policies that hide moves overload this
+template<typename Grid>
+inline uint8_t grid_moves(const Grid& grid, uint32_t index)
+{
+	return grid.tiles[index];
+}
+
+/*
+	Heuristic policies
+*/
+struct heuristic_zero
+{
+	uint32_t operator()(uint32_t, tile_pos) const
+	{
+		return 0;
+	}
+};
+
+struct heuristic_manhattan
+{
+	tile_pos target;
+
+	uint32_t operator()(uint32_t, tile_pos pos) const
+	{
+		return manhattan_distance(pos, target);
+	}
+};
+
+struct heuristic_landmarks
+{
+	tile_pos				target;
+	uint32_t				target_index;
+	const path_landmarks*	landmarks;
+
+	uint32_t operator()(uint32_t index, tile_pos pos) const
+	{
+		return std::max((uint32_t)manhattan_distance(pos, target), path_landmarks_estimate(landmarks, index, target_index));
+	}
+};
+
+/*
+	Scales another estimate by a weight, for weighted A*. The weight is 16.16 fixed point so there
+	is no divide per tile, see path_weight_scale. Both round down, so the path found is at most the
+	weight times the shortest.
+*/
+constexpr uint32_t path_weight_scale(uint32_t weight_hundredths)
+{
+	return (weight_hundredths << 16) / 100;
+}
+
+template<typename Heuristic>
+struct heuristic_weighted
+{
+	Heuristic	heuristic;
+	uint32_t	scale;
+
+	uint32_t operator()(uint32_t index, tile_pos pos) const
+	{
+		return (uint32_t)(((uint64_t)heuristic(index, pos) * scale) >> 16);
+	}
+};
+
+/*
+	Cost policies
+*/
+struct cost_uniform
+{
+	static constexpr uint32_t min_step = 1;
+
+	uint32_t step(uint32_t) const
+	{
+		return 1;
+	}
+};
+
+// Per tile entry cost, for example to make ghosts avoid tiles near pathman. Weights must be >= 1
+struct cost_tile_weights
+{
+	static constexpr uint32_t min_step = 1;
+
+	const uint8_t* weights;
+
+	uint32_t step(uint32_t index) const
+	{
+		return weights[index];
+	}
+};
+
+/*
+	Goal policies, deciding whether an expanded tile ends the search
+*/
+struct goal_tile
+{
+	uint32_t index;
+
+	bool operator()(uint32_t tile) const
+	{
+		return tile == index;
+	}
+};
+
+/*
+	Open list helpers shared by all searches. std heaps keep the largest element on top so an entry
+	counts as "less" when it should be expanded later: higher f first, then lower g. Preferring the
+	highest g among equal f values pushes the search deeper and avoids expanding whole plateaus of
+	ties.
+*/
+inline bool path_open_later(const path_open_entry& a, const path_open_entry& b)
+{
+	return (a.f > b.f) || (a.f == b.f && a.g < b.g);
+}
+
+inline void path_open_push(std::vector<path_open_entry>* open, uint32_t f, uint32_t g, uint32_t index)
+{
+	open->push_back({f, g, index});
+	std::push_heap(open->begin(), open->end(), path_open_later);
+}
+
+inline path_open_entry path_open_pop(std::vector<path_open_entry>* open)
+{
+	std::pop_heap(open->begin(), open->end(), path_open_later);
+	const path_open_entry entry = open->back();
+	open->pop_back();
+
+	return entry;
+}
+
+/*
+	An open list entry is stale if its tile has since been closed or reached more cheaply, as the
+	heap is never searched to update entries in place.
+*/
+inline bool path_open_stale(const path_open_entry& entry, const path_node* nodes)
+{
+	const path_node* node = &nodes[entry.index];
+	return node->closed || node->g != entry.g;
+}
+
+/*
+	Appends the tiles from the origin of one search side to the given tile, following the stored
+	parent directions back and reversing them into walking order.
+*/
+template<typename Grid>
+void path_append_from_origin(const Grid& grid, const path_node* nodes, uint32_t origin, uint32_t index, std::vector<tile_pos>* path)
+{
+	const size_t first = path->size();
+
+	for (;;)
+	{
+		path->push_back(grid.pos(index));
+		if (index == origin)
+			break;
+		index = grid.neighbour(index, nodes[index].parent);
+	}
+
+	std::reverse(path->begin() + first, path->end());
+}
+
+/*
+	Number of moves from the origin of one search side to the given tile along the stored parents.
+	Searches that reopen tiles can make this fewer than the tile's g, as a tile's parents may have
+	been reached more cheaply after the tile itself.
+*/
+template<typename Grid>
+uint32_t path_length_from_origin(const Grid& grid, const path_node* nodes, uint32_t origin, uint32_t index)
+{
+	uint32_t length = 0;
+	for (; index != origin; length++)
+		index = grid.neighbour(index, nodes[index].parent);
+
+	return length;
+}
+
+// Appends the tile reached by one move in the given direction
+template<typename Grid>
+void path_append_step(const Grid& grid, uint32_t, uint32_t index, std::vector<tile_pos>* path)
+{
+	path->push_back(grid.pos(index));
+}
+
+/*
+	A* over the finder's forward node array, split so a search can be run a slice at a time. The
+	finder must already have been prepared with path_finder_begin_query, then
+	path_search_astar_begin seeds the open list and each path_search_astar_step expands at most
+	max_expansions tiles. All progress lives in the finder, so the grid, heuristic, cost and goal
+	passed to each step must match the ones the search was begun with. The search ends at the first
+	expanded tile the goal policy accepts, which for the heuristic to be admissible must estimate
+	the distance to the nearest tile the goal accepts. The path can be a std::vector of tiles or a
+	path_packed.
+
+	Closed tiles are never reopened. With a consistent estimate a tile is closed at its shortest
+	distance so there is nothing to reopen, and with an estimate scaled by a weight for weighted A*
+	skipping them still keeps the path within the weight of the shortest while saving the repeated
+	expansions reopening causes.
+*/
+template<typename Grid, typename Heuristic, typename Cost>
+void path_search_astar_begin(path_finder* pf, const Grid& grid, const Heuristic& heuristic, const Cost&, path_stats* stats)
+{
+	const uint32_t start = grid.index(pf->query.start);
+
+	pf->nodes[0][start] = {pf->search, 0, 0, 0};
+	path_open_push(&pf->open[0], heuristic(start, pf->query.start) * Cost::min_step, 0, start);
+	stats->nodes_generated++;
+}
+
+template<typename Grid, typename Heuristic, typename Cost, typename Goal, typename Path>
+path_status path_search_astar_step(path_finder* pf, const Grid& grid, const Heuristic& heuristic, const Cost& cost, const Goal& goal, uint32_t max_expansions, Path* path, path_stats* stats)
+{
+	const uint32_t search = pf->search;
+	const uint32_t start = grid.index(pf->query.start);
+	path_node* nodes = pf->nodes[0];
+	std::vector<path_open_entry>* open = &pf->open[0];
+
+	for (uint32_t expanded = 0; !open->empty();)
+	{
+		// Stale entries are dropped before the budget check so a resumed search starts on real work
+		if (path_open_stale(open->front(), nodes))
+		{
+			path_open_pop(open);
+			continue;
+		}
+
+		if (expanded++ == max_expansions)
+			return path_status_searching;
+
+		const path_open_entry current = path_open_pop(open);
+		nodes[current.index].closed = 1;
+		stats->nodes_expanded++;
+
+		if (goal(current.index))
+		{
+			path_append_from_origin(grid, nodes, start, current.index, path);
+			stats->cost = current.g;
+			return path_status_found;
+		}
+
+		const tile_pos pos = grid.pos(current.index);
+		const tile_neighbours& neighbours = tile_neighbours_of(grid_moves(grid, current.index));
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t direction = neighbours.directions[i];
+			const uint32_t index = grid.neighbour(current.index, direction);
+			const uint32_t g = current.g + cost.step(index);
+
+			// Closed tiles are never reopened, see above
+			path_node* next = &nodes[index];
+			if (next->search == search && (next->closed || next->g <= g))
+				continue;
+
+			*next = {search, g, 0, direction ^ 1};
+
+			const tile_pos next_pos = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+			path_open_push(open, g + (heuristic(index, next_pos) * Cost::min_step), g, index);
+			stats->nodes_generated++;
+		}
+	}
+
+	return path_status_failed;
+}
+
+/*
+	Specialised A* for callers that know their map type at compile time, for example:
+
+		path_search(&pf, grid_static<28, 31>(&maze_grid), &query, heuristic_manhattan{query.goal}, &path, &stats);
+
+	The query mode is ignored. Returns true and the tiles from start to goal inclusive on success,
+	or the moves from start to goal for a path_packed. Stats are optional.
+*/
+template<typename Grid, typename Heuristic, typename Path, typename Cost = cost_uniform>
+bool path_search(path_finder* pf, const Grid& grid, const path_query* query, const Heuristic& heuristic, Path* path, path_stats* stats, const Cost& cost = Cost())
+{
+	path_stats local_stats;
+	if (!stats)
+		stats = &local_stats;
+
+	if (!path_finder_begin_query(pf, query, path, stats))
+		return false;
+
+	path_search_astar_begin(pf, grid, heuristic, cost, stats);
+	return path_search_astar_step(pf, grid, heuristic, cost, goal_tile{grid.index(query->goal)}, UINT32_MAX, path, stats) == path_status_found;
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+static uint64_t path_sparse_key(tile_pos pos)
+{
+	return ((uint64_t)(uint32_t)pos.y << 32) | (uint32_t)pos.x;
+}
+
+/*
+	Home slot of a tile. Hashing every tile on its own scatters a search's neighbouring tiles across
+	the whole table, so instead the 8x8 chunk holding the tile is hashed to a run of 64 slots and
+	tiles keep their place within the chunk, which keeps a search front inside a few cache lines of
+	the table much as grid_blocked does for dense state.
+*/
+static uint32_t path_sparse_home(uint64_t key, uint32_t mask)
+{
+	// Fibonacci hashing of the chunk, table sizes are always powers of two of at least 64
+	const uint64_t chunk = (key >> 3) & 0x1FFFFFFF1FFFFFFFull;
+	const uint32_t within = (uint32_t)(((key >> 29) & 0x38) | (key & 7));
+	return (((uint32_t)((chunk * 0x9E3779B97F4A7C15ull) >> 32) << 6) | within) & mask;
+}
+
+/*
+	Puts an entry known not to be in the table into it, starting from the given slot at the given
+	distance from the entry's home. Whenever the slot holds an entry closer to its own home the two
+	swap and the displaced entry carries on looking for a slot.
+*/
+static void path_sparse_place(path_sparse* ps, path_sparse_slot entry, uint32_t slot, uint32_t distance)
+{
+	const uint32_t mask = (uint32_t)ps->slots.size() - 1;
+
+	for (;; slot = (slot + 1) & mask, distance++)
+	{
+		path_sparse_slot* current = &ps->slots[slot];
+		if (current->stamp != ps->stamp)
+		{
+			*current = entry;
+			return;
+		}
+
+		const uint32_t current_distance = (slot - path_sparse_home(current->key, mask)) & mask;
+		if (current_distance < distance)
+		{
+			std::swap(*current, entry);
+			distance = current_distance;
+		}
+	}
+}
+
+// Doubles the table, reinserting every node of the current search from the pool
+static void path_sparse_grow(path_sparse* ps)
+{
+	ps->slots.assign(ps->slots.size() * 2, {0, 0, 0});
+
+	const uint32_t mask = (uint32_t)ps->slots.size() - 1;
+	for (uint32_t i = 0; i < ps->nodes.size(); i++)
+	{
+		const uint64_t key = path_sparse_key(ps->nodes[i].pos);
+		path_sparse_place(ps, {key, i, ps->stamp}, path_sparse_home(key, mask), 0);
+	}
+}
+
+void path_sparse_init(path_sparse* ps, uint32_t max_nodes)
+{
+	alloc_tag("path_sparse");
+
+	// Stamp 0 marks the empty slots of a new table
+	ps->slots.assign(1024, {0, 0, 0});
+	ps->stamp = 1;
+	ps->nodes.clear();
+	ps->open.clear();
+	ps->max_nodes = max_nodes;
+}
+
+void path_sparse_term(path_sparse* ps)
+{
+	std::vector<path_sparse_slot>().swap(ps->slots);
+	std::vector<path_sparse_node>().swap(ps->nodes);
+	std::vector<path_open_entry>().swap(ps->open);
+}
+
+void path_sparse_reset(path_sparse* ps)
+{
+	// Stamps wrap after ~4 billion searches, when they do every slot has to be emptied once
+	if (++ps->stamp == 0)
+	{
+		for (path_sparse_slot& slot : ps->slots)
+			slot.stamp = 0;
+		ps->stamp = 1;
+	}
+
+	ps->nodes.clear();
+	ps->open.clear();
+}
+
+uint32_t path_sparse_find(const path_sparse* ps, tile_pos pos)
+{
+	const uint64_t key = path_sparse_key(pos);
+	const uint32_t mask = (uint32_t)ps->slots.size() - 1;
+
+	for (uint32_t slot = path_sparse_home(key, mask), distance = 0;; slot = (slot + 1) & mask, distance++)
+	{
+		const path_sparse_slot& current = ps->slots[slot];
+		if (current.stamp != ps->stamp || ((slot - path_sparse_home(current.key, mask)) & mask) < distance)
+			return path_sparse_none;
+
+		if (current.key == key)
+			return current.node;
+	}
+}
+
+uint32_t path_sparse_node_at(path_sparse* ps, tile_pos pos)
+{
+	alloc_tag("path_sparse");
+
+	if ((ps->nodes.size() + 1) * 4 > ps->slots.size() * 3)
+		path_sparse_grow(ps);
+
+	const uint64_t key = path_sparse_key(pos);
+	const uint32_t mask = (uint32_t)ps->slots.size() - 1;
+
+	// The search for the key stops where the key would have been placed if it were there
+	uint32_t slot = path_sparse_home(key, mask);
+	uint32_t distance = 0;
+	for (;; slot = (slot + 1) & mask, distance++)
+	{
+		const path_sparse_slot& current = ps->slots[slot];
+		if (current.stamp != ps->stamp || ((slot - path_sparse_home(current.key, mask)) & mask) < distance)
+			break;
+
+		if (current.key == key)
+			return current.node;
+	}
+
+	const uint32_t node = (uint32_t)ps->nodes.size();
+	ps->nodes.push_back({pos, 0x7FFFFFFF, 0, path_sparse_none});
+	path_sparse_place(ps, {key, node, ps->stamp}, slot, distance);
+
+	return node;
+}
+
+size_t path_sparse_bytes(const path_sparse* ps)
+{
+	return (ps->slots.capacity() * sizeof(path_sparse_slot)) + (ps->nodes.capacity() * sizeof(path_sparse_node)) +
+		(ps->open.capacity() * sizeof(path_open_entry));
+}
\ No newline at end of file
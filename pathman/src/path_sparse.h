@@ -0,0 +1,152 @@
+/*
+	Sparse search state for huge or unbounded worlds.
+
+	path_finder keeps a node for every tile of its grid, which stops being practical once the world
+	is enormous or generated on demand and a query only ever touches a tiny part of it. path_sparse
+	keeps nodes only for the tiles a search reaches, in a pool in the order they were reached, and
+	finds them through an open addressing table keyed on the tile's 64 bit coordinates.
+
+	The table uses Robin Hood linear probing: an entry being inserted takes the slot of any entry
+	closer to its home slot and carries that one on instead, which keeps probe lengths short and
+	even at a 3/4 load and lets a lookup for a missing tile stop as soon as it passes entries closer
+	to home than it would be. Tiles are hashed by 8x8 chunk so nearby tiles land in nearby slots.
+	Each slot holds the key, the pool index and a stamp next to each other, so a probe reads one 16
+	byte slot at a time. Slots are only valid for the search whose stamp they carry, the same trick
+	as path_node::search, so resetting for the next query just bumps the stamp and empties the pool
+	without touching the table, and its cost never depends on how much earlier searches touched.
+	The table keeps the size of the largest search so far.
+
+	Coordinates may be anywhere in the int32 range as long as the ends of a query are less than 2^30
+	tiles apart each way. Worlds are supplied as a policy with tile(pos) returning the tile_flags of
+	any position, see world_grid. As the world may be unbounded a search gives up once max_nodes
+	tiles have been reached.
+*/
+constexpr uint32_t path_sparse_none = UINT32_MAX;
+
+struct path_sparse_slot
+{
+	uint64_t key;
+	uint32_t node;
+	uint32_t stamp;
+};
+
+struct path_sparse_node
+{
+	tile_pos pos;
+	uint32_t g		: 31;
+	uint32_t closed	: 1;		// Expanded with a final cost
+	uint32_t parent;			// Pool index of the node this one was reached from
+};
+
+struct path_sparse
+{
+	std::vector<path_sparse_slot>	slots;		// Power of two sized, slots with another stamp are empty
+	uint32_t						stamp;
+	std::vector<path_sparse_node>	nodes;		// Nodes reached by the current search
+	std::vector<path_open_entry>	open;		// Binary heap of pool indices ordered by lowest f then highest g
+	uint32_t						max_nodes;	// Nodes a search may reach before giving up
+};
+
+void path_sparse_init(path_sparse* ps, uint32_t max_nodes);
+void path_sparse_term(path_sparse* ps);
+
+// Starts a new search, in time that does not depend on the table size or the last search
+void path_sparse_reset(path_sparse* ps);
+
+// Pool index of the tile's node in the current search, or path_sparse_none
+uint32_t path_sparse_find(const path_sparse* ps, tile_pos pos);
+
+// Pool index of the tile's node in the current search, adding an unreached node if there is none
+uint32_t path_sparse_node_at(path_sparse* ps, tile_pos pos);
+
+// Bytes held by the table, pool and open list
+size_t path_sparse_bytes(const path_sparse* ps);
+
+// World policy over an ordinary tile_grid, everything outside it is wall
+struct world_grid
+{
+	const tile_grid* grid;
+
+	uint8_t tile(tile_pos pos) const
+	{
+		return tile_grid_get(grid, pos.x, pos.y);
+	}
+};
+
+/*
+	A* with Manhattan distance over a world policy, keeping its state in ps. Returns true and the
+	tiles from start to goal inclusive on success. Fails if either end is a wall, there is no path
+	or the search reaches max_nodes tiles first. The query mode is ignored. Stats are optional.
+*/
+template<typename World>
+bool path_sparse_search(path_sparse* ps, const World& world, const path_query* query, std::vector<tile_pos>* path, path_stats* stats)
+{
+	path_stats local_stats;
+	if (!stats)
+		stats = &local_stats;
+
+	*stats = {};
+	path->clear();
+
+	if (world.tile(query->start) == tile_flags_wall || world.tile(query->goal) == tile_flags_wall)
+		return false;
+
+	path_sparse_reset(ps);
+
+	const tile_pos goal = query->goal;
+	const uint32_t root = path_sparse_node_at(ps, query->start);
+	ps->nodes[root].g = 0;
+	path_open_push(&ps->open, manhattan_distance(query->start, goal), 0, root);
+	stats->nodes_generated++;
+
+	while (!ps->open.empty())
+	{
+		const path_open_entry current = path_open_pop(&ps->open);
+		path_sparse_node* node = &ps->nodes[current.index];
+		if (node->closed || node->g != current.g)
+			continue;
+
+		node->closed = 1;
+		stats->nodes_expanded++;
+
+		const tile_pos pos = node->pos;
+		if (pos.x == goal.x && pos.y == goal.y)
+		{
+			for (uint32_t index = current.index;; index = ps->nodes[index].parent)
+			{
+				path->push_back(ps->nodes[index].pos);
+				if (index == root)
+					break;
+			}
+			std::reverse(path->begin(), path->end());
+
+			stats->cost = current.g;
+			return true;
+		}
+
+		if (ps->nodes.size() + 4 > ps->max_nodes)
+			return false;
+
+		const tile_neighbours& neighbours = tile_neighbours_of(world.tile(pos));
+		const uint32_t g = current.g + 1;
+
+		for (uint32_t i = 0; i < neighbours.count; i++)
+		{
+			const uint32_t direction = neighbours.directions[i];
+			const tile_pos next_pos = {pos.x + tile_direction_dx[direction], pos.y + tile_direction_dy[direction]};
+
+			// Adding a node can move the pool, so nodes are only held by index across it
+			const uint32_t index = path_sparse_node_at(ps, next_pos);
+			path_sparse_node* next = &ps->nodes[index];
+			if (next->closed || next->g <= g)
+				continue;
+
+			next->g = g;
+			next->parent = current.index;
+			path_open_push(&ps->open, g + manhattan_distance(next_pos, goal), g, index);
+			stats->nodes_generated++;
+		}
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -1,344 +1,183 @@
-#include <vector>
-
-
-constexpr int32_t maze_width = 224;
-constexpr int32_t maze_height = 248;
-constexpr int32_t tile_map_width = maze_width / 8;
-constexpr int32_t tile_map_height = maze_height / 8;
 constexpr int32_t display_scale = 4;
 constexpr int32_t display_width = maze_width * display_scale;
 constexpr int32_t display_height = maze_height * display_scale;
 
-enum tile_flags : uint8_t
+/*
+	The simulation (pathfinding, movement and animation) runs on its own thread at a fixed tick
+	rate, so a slow tick does not hold up Present and vsync waits do not stall the simulation.
+	After each tick it publishes a snapshot of everything the renderer draws through a triple
+	buffer, and the render thread draws whichever snapshot is newest. Key presses go the other way
+	through an SPSC queue.
+*/
+constexpr double	sim_tick_us = 1000000.0 / 60.0;
+constexpr uint32_t	sim_max_sprites = 64;
+
+struct sim_sprite
 {
-	tile_flags_wall = 0x00,
-	tile_flags_open_up = 0x01,
-	tile_flags_open_down = 0x02,
-	tile_flags_open_left = 0x04,
-	tile_flags_open_right = 0x08,
+	int32_t		tile_x;
+	int32_t		tile_y;
+	sprite_id	sprite;
 };
 
-//28 x 31
-
-static uint8_t tile_map[tile_map_width * tile_map_height] = {
-	0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0xA,0xC,0xC,0xC,0xC,0xE,0xC,0xC,0xC,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0xC,0xC,0xC,0xE,0xC,0xC,0xC,0xC,0x6,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0xB,0xC,0xC,0xC,0xC,0xF,0xC,0xC,0xE,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0xE,0xC,0xC,0xF,0xC,0xC,0xC,0xC,0x7,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x9,0xC,0xC,0xC,0xC,0x7,0x0,0x0,0x9,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0x5,0x0,0x0,0xB,0xC,0xC,0xC,0xC,0x5,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0xA,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0x6,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0xB,0xC,0xC,0x6,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0xB,0xC,0xC,0x6,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0xB,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0x6,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,
-	0x0,0xA,0xC,0xC,0xC,0xC,0xF,0xC,0xC,0xD,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0xB,0xC,0xC,0xF,0xC,0xC,0xC,0xC,0x6,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x9,0xC,0x6,0x0,0x0,0xB,0xC,0xC,0xE,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0xE,0xC,0xC,0x7,0x0,0x0,0xA,0xC,0x5,0x0,
-	0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,
-	0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,
-	0x0,0xA,0xC,0xD,0xC,0xC,0x5,0x0,0x0,0x9,0xC,0xC,0x6,0x0,0x0,0xA,0xC,0xC,0x5,0x0,0x0,0x9,0xC,0xC,0xD,0xC,0xA,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,0x0,0x3,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x3,0x0,
-	0x0,0x9,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xD,0xC,0xC,0xD,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0xC,0x5,0x0,
-	0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0,0x0
+struct sim_snapshot
+{
+	uint32_t	tick;
+	uint32_t	sprite_count;
+	sim_sprite	sprites[sim_max_sprites];
 };
 
-static uint32_t	pathman_anim_counter;
-static uint32_t	ghost_anim_counter;
-static int32_t	pathman_tile_x = 1;
-static int32_t	pathman_tile_y = 1;
-static int32_t	ghost_tile_x = 13;
-static int32_t	ghost_tile_y = 17;
-
-struct customNode {
-	int x;
-	int y;
-	int gScore;
-	int hScore;
-	customNode* parent;
+struct sim_input
+{
+	uint32_t key;	// Virtual key code
 };
 
-struct Vector2 {
+static triple_buffer<sim_snapshot>		sim_snapshots;
+static spsc_queue<sim_input, 64>		sim_inputs;
+static std::atomic<bool>				sim_quit;
 
-	int x;
-	int y;
+// Simulation state, only touched by the simulation thread once it has started
+static entity_store	entities;
+static entity_handle	pathman_entity;
+static entity_handle	ghost_entity;
 
-	Vector2(int xp, int yp) {
-		x = xp;
-		y = yp;
-	}
+// Pathman steps one tile along its path every 20 ticks
+constexpr uint16_t	pathman_move_period = 20;
 
-};
+// Scratch memory for each thread, reset every frame or tick
+constexpr size_t	render_scratch_bytes = 4 * 1024 * 1024;
+constexpr size_t	sim_scratch_bytes = 1024 * 1024;
 
+// Pathfinding gets a fixed slice of each frame, searches that do not fit carry on next frame
+constexpr uint32_t	path_budget_expansions = 4096;
+constexpr double	path_budget_us = 500.0;
 
-void draw_sprite(sprite_batch* sb, texture* sprite_sheet, int32_t tile_x, int32_t tile_y, int32_t src_x, int32_t src_y)
+static path_schedule	pathman_schedule;
+static path_landmarks	pathman_landmarks;
+
+// Regions of the sprite sheet, registered when it is loaded and read only after that
+static sprite_atlas		sheet_atlas;
+static sprite_id		maze_sprite;
+static sprite_sequence	pathman_animation;
+static sprite_sequence	ghost_animation;
+
+// Character sprites are centred on their tile, overhanging it by 3 pixels each side
+sprite_instance tile_sprite(int32_t tile_x, int32_t tile_y, sprite_id sprite)
 {
 	const int32_t x = (tile_x * 8) - 3;
 	const int32_t y = (tile_y * 8) - 3;
 
-	sprite_batch_draw(sb, sprite_sheet, x * display_scale, y * display_scale, 14 * display_scale, 14 * display_scale, src_x, src_y, 14, 14);
+	return {x * display_scale, y * display_scale, sprite, (uint16_t)display_scale};
 }
 
-int manhattanFinder(Vector2 a, Vector2 b)
+// Sprite emission system, copies every entity with the frame picked by entity_update_animation
+void emit_sprites(const entity_store* es, sim_snapshot* snapshot)
 {
-	return abs(a.x - b.x) + abs(a.y - b.y);
+	snapshot->sprite_count = std::min(es->count, sim_max_sprites);
+	for (uint32_t i = 0; i < snapshot->sprite_count; i++)
+		snapshot->sprites[i] = {es->positions[i].x, es->positions[i].y, es->sprite_ids[i]};
 }
 
-customNode* getSquareLowestFScore(std::vector<customNode*> openlist) {
-
-	customNode* toReturn;
-	bool firstRun = true;
-	int fScoreRecord;
-	for (customNode* node : openlist) {
-		if (firstRun) {
-			fScoreRecord = node->gScore + node->hScore;
-			toReturn = node;
-			firstRun = false;
-		}
-		else {
-			int overall = node->gScore + node->hScore;
-			if (overall < fScoreRecord) {
-				toReturn = node;
-				fScoreRecord = overall;
-			}
-		}
-	}
+/*
+	Chases the ghost with pathman, who steps one tile along the shortest path every 20 frames. The
+	cross-maze chase is the long query bidirectional search is meant for, so use it here.
 
-	return toReturn;
-}
+	Searches are time sliced, so a new chase is only requested once the last one completes and in
+	the meantime, or after a chase fails, pathman keeps following the last path found, which may
+	have been planned from a tile pathman has since walked past. The path handed to pathman stops next to the ghost.
+*/
+void PathFind() {
 
-void removeFromVector(customNode* nodeToRemove, std::vector<customNode*>& openList) {
-	for (int i = 0; i < openList.size(); i++) {
-		if (openList.at(i)->x == nodeToRemove->x && openList.at(i)->y == nodeToRemove->y) {
-			openList.erase(openList.begin() + i);
+	if (!path_schedule_pending(&pathman_schedule, 0)) {
+		// The search wrote the packed path directly, dropping the last move leaves pathman next to the ghost
+		const path_agent* agent = &pathman_schedule.agents[0];
+		path_packed path = agent->path;
+		if (agent->status == path_status_found && path.length > 0) {
+			if (!path.truncated)
+				path.length--;
+			entity_set_path(&entities, pathman_entity, &path);
 		}
-	}
-}
 
-bool vectorContains(customNode* containNode, std::vector<customNode*>& nodeVector) {
-	bool contains = false;
-	for (customNode* node : nodeVector) {
-		if (node->x == containNode->x && node->y == containNode->y) {
-			contains = true;
-		}
+		const path_query query = {
+			entities.positions[entity_index(&entities, pathman_entity)],
+			entities.positions[entity_index(&entities, ghost_entity)],
+			path_mode_bidirectional
+		};
+		path_schedule_request(&pathman_schedule, 0, &query);
 	}
 
-	return contains;
-}
-
-uint8_t GetObjectAtWorldPos(int32_t x, int32_t y) {
-	if (x < 0 || x > 28) return 0x00;
-	if (y < 0 || y > 31) return 0x00;
-	int gridCalculation = (y * 28) + x;
-	return tile_map[gridCalculation];
+	path_schedule_update(&pathman_schedule, path_budget_expansions, path_budget_us);
 }
 
-//std::vector<customNode*> adjSquares;
-
-std::vector<customNode*> getAdjacentSquares(customNode* node, customNode* destination) {
-
-	std::vector<customNode*> adjSquares;
 
-	bool aboveBool = false;
-	bool belowBool = false;
-	bool leftBool = false;
-	bool rightBool = false;
-
-	//above
-	if (GetObjectAtWorldPos(node->x, node->y + 1) != 0x00) {
-		customNode* above = new customNode();
-		above->x = node->x;
-		above->y = node->y + 1;
-		above->gScore = node->gScore + 1;
-		above->hScore = manhattanFinder(Vector2(above->x, above->y), Vector2(destination->x, destination->y));
-		above->parent = node;
-		aboveBool = true;
-		adjSquares.push_back(above);
-	}
-	//below
-	if (GetObjectAtWorldPos(node->x, node->y - 1) != 0x00) {
-		customNode* below = new customNode();
-		below->x = node->x;
-		below->y = node->y - 1;
-		below->gScore = node->gScore + 1;
-		below->hScore = manhattanFinder(Vector2(below->x, below->y), Vector2(destination->x, destination->y));
-		below->parent = node;
-		belowBool = true;
-		adjSquares.push_back(below);
-	}
-
-	//left
-	if (GetObjectAtWorldPos(node->x - 1, node->y) != 0x00) {
-		customNode* left = new customNode();
-		left->x = node->x - 1;
-		left->y = node->y;
-		left->gScore = node->gScore + 1;
-		left->hScore = manhattanFinder(Vector2(left->x, left->y), Vector2(destination->x, destination->y));
-		left->parent = node;
-		leftBool = true;
-		adjSquares.push_back(left);
+// The arrow keys steer the ghost, one tile per press
+void handle_input(const sim_input* input)
+{
+	uint32_t direction;
+	switch (input->key)
+	{
+	case VK_UP:		direction = tile_direction_up; break;
+	case VK_DOWN:	direction = tile_direction_down; break;
+	case VK_LEFT:	direction = tile_direction_left; break;
+	case VK_RIGHT:	direction = tile_direction_right; break;
+	default:		return;
 	}
 
-	//right
-	if (GetObjectAtWorldPos(node->x + 1, node->y) != 0x00) {
-		customNode* right = new customNode();
-		right->x = node->x + 1;
-		right->y = node->y;
-		right->gScore = node->gScore + 1;
-		right->hScore = manhattanFinder(Vector2(right->x, right->y), Vector2(destination->x, destination->y));
-		right->parent = node;
-		rightBool = true;
-		adjSquares.push_back(right);
+	tile_pos* pos = &entities.positions[entity_index(&entities, ghost_entity)];
+	if (tile_grid_get(&maze_grid, pos->x, pos->y) & (1 << direction))
+	{
+		pos->x += tile_direction_dx[direction];
+		pos->y += tile_direction_dy[direction];
 	}
-
-
-	return adjSquares;
 }
 
-int count = 0;
-
-void PathFind() {
-
-	std::vector<customNode*> openList; // all considered squares/nodes to find the shortest path
-	std::vector<customNode*> closedList; // Squares/nodes not to consider again
-
-	std::vector<customNode*> complete; // List of the completed path
-
-	customNode* start = new customNode();
-	start->x = pathman_tile_x; // Initial Enemy Pos
-	start->y = pathman_tile_y; // Initial Enemy Pos
-	start->gScore = 0; // Distance from the start point - worked out by using parents value and adding 1 - Diagonals increment by 2 so there favoured
-	start->hScore = manhattanFinder(Vector2(start->x, start->y), Vector2(ghost_tile_x, ghost_tile_y)); // Get very aprox distance from the destination using the manhattan method
-	start->parent = nullptr; // Parent used for tracking route
-
-	customNode* destNode = new customNode();
-	destNode->x = ghost_tile_x;
-	destNode->y = ghost_tile_y;
-	destNode->gScore = 0;
-	destNode->hScore = 0;
-
-	openList.push_back(start); // Add the start point to the open list
-
-	do {
-
-		customNode* currentSquare = getSquareLowestFScore(openList); //Get the square with the lowest FScore
-
-		closedList.push_back(currentSquare); // Add the lowest fscored square to closed list
-		removeFromVector(currentSquare, openList); // Remove the current Square from the openList
-
-		if (vectorContains(destNode, closedList)) { // We are at the destination
-
-			customNode* tmp = currentSquare; // begin the tmp list from the current square
-
-			do {
-				complete.push_back(tmp); // Add node to completed list
-				tmp = tmp->parent; // Go backward finding path
-			} while (tmp != nullptr); // Loop untill the parent is nullptr
-
-			break;
-		}
-
-		std::vector<customNode*> adjacentSquares = getAdjacentSquares(currentSquare, destNode); // Get all the adjacent grid boxes - excluding walls
-
-
-		for (int index = 0; index < adjacentSquares.size(); index++) { // Loop through adjacent nodes/squares
-
-			if (vectorContains(adjacentSquares.at(index), closedList)) { // If the selected node/square is in the closedlist just ignore
-				continue;
-			}
-
-			if (!(vectorContains(adjacentSquares.at(index), openList))) { // if the square/node isnt in the open list then add it
-
-				openList.push_back(adjacentSquares.at(index));
-
-			}
-			else { // This is kinda optional but used to 'better' routes
-
-				if ((currentSquare->gScore + 1) < adjacentSquares.at(index)->gScore) { //Check if the adjacent square/node has a better gscore than the currentSquares
-
-					customNode* newOne = adjacentSquares.at(index); // Using that node we assign it to a new pointer
-					newOne->gScore = currentSquare->gScore + 1; // Add 1 to the score
-
-					removeFromVector(adjacentSquares.at(index), openList); // remove the old version with the old score from the open list 
-
-					openList.push_back(newOne); // re-add to list with new score
-
-				}
-
-			}
+void simulate()
+{
+	using namespace std::chrono;
 
-		}
+	frame_arena_thread_init("simulation", sim_scratch_bytes);
 
+	steady_clock::time_point next_tick = steady_clock::now();
+	for (uint32_t tick = 0; !sim_quit.load(std::memory_order_relaxed); tick++)
+	{
+		sim_input input;
+		while (spsc_queue_pop(&sim_inputs, &input))
+			handle_input(&input);
 
-	} while (!openList.empty()); // loop while the openList is not empty
+		sim_snapshot* snapshot = triple_buffer_back(&sim_snapshots);
+		snapshot->tick = tick;
+		emit_sprites(&entities, snapshot);
+		triple_buffer_publish(&sim_snapshots);
 
+		PathFind();
 
-	std::vector<Vector2> pathToReturn;
+		entity_update_movement(&entities);
+		entity_update_animation(&entities);
 
+		frame_arena_reset(frame_scratch());
 
-	for (int i = complete.size(); i != 0; i--) {
-		pathToReturn.push_back(Vector2(complete.at(i - 1)->x, complete.at(i - 1)->y));
+		// A tick that overran starts the next one straight away rather than trying to catch up
+		next_tick = std::max(next_tick + duration_cast<steady_clock::duration>(duration<double, std::micro>(sim_tick_us)), steady_clock::now());
+		std::this_thread::sleep_until(next_tick);
 	}
 
-	//Releasing
-	for (customNode* node : openList) {
-		delete node;
-	}
-	openList.empty();
-	for (customNode* node : closedList) {
-		delete node;
-	}
-	closedList.empty();
-	complete.empty();
-
-	//return pathToReturn;
-	if (count == 20) {
-		if (pathToReturn.size() > 2) {
-			pathman_tile_x = pathToReturn[1].x;
-			pathman_tile_y = pathToReturn[1].y;
-		}
-		count = 0;
-	}
-	count++;
+	frame_arena_report(frame_scratch());
+	frame_arena_thread_term();
 }
 
-
-void render(d3d_context* d3d, sprite_batch* sb, texture* sprite_sheet)
+// The maze is in the batch's static layer, so only the characters are submitted each frame
+void render(d3d_context* d3d, sprite_batch* sb, const sprite_atlas* atlas)
 {
 	sprite_batch_begin(sb);
 
-	sprite_batch_draw(sb, sprite_sheet, 0, 0, 224 * display_scale, 248 * display_scale, 228, 0, 224, 248);
-
-	if (ghost_anim_counter < 8)
-		draw_sprite(sb, sprite_sheet, ghost_tile_x, ghost_tile_y, 585, 65);
-	else
-		draw_sprite(sb, sprite_sheet, ghost_tile_x, ghost_tile_y, 601, 65);
-
-	if (++ghost_anim_counter == 16)
-		ghost_anim_counter = 0;
-
-	if (pathman_anim_counter < 8)
-		draw_sprite(sb, sprite_sheet, pathman_tile_x, pathman_tile_y, 457, 1);
-	else if (pathman_anim_counter < 16)
-		draw_sprite(sb, sprite_sheet, pathman_tile_x, pathman_tile_y, 473, 1);
-	else
-		draw_sprite(sb, sprite_sheet, pathman_tile_x, pathman_tile_y, 489, 1);
-
-	PathFind();
+	const sim_snapshot* snapshot = triple_buffer_read(&sim_snapshots);
+	sprite_instance sprites[sim_max_sprites];
+	for (uint32_t i = 0; i < snapshot->sprite_count; i++)
+	{
+		const sim_sprite& sprite = snapshot->sprites[i];
+		sprites[i] = tile_sprite(sprite.tile_x, sprite.tile_y, sprite.sprite);
+	}
 
-	if (++pathman_anim_counter == 24)
-		pathman_anim_counter = 0;
+	sprite_batch_compose(sb, atlas, sprites, snapshot->sprite_count);
 
 	sprite_batch_end(sb);
 }
@@ -349,6 +188,12 @@ void load_sprite_sheet(texture* sprite_sheet, d3d_context* d3d)
 	void* image_file_data = read_entire_file("asset/pacman.png", &image_file_size);
 	load_png(d3d, sprite_sheet, image_file_data, image_file_size);
 	free(image_file_data);
+
+	// Both characters animate through 14 pixel frames 16 pixels apart
+	sprite_atlas_init(&sheet_atlas, sprite_sheet, sprite_sheet->width, sprite_sheet->height);
+	maze_sprite = sprite_atlas_add(&sheet_atlas, "maze", 228, 0, 224, 248);
+	pathman_animation = sprite_atlas_add_sequence(&sheet_atlas, "pathman", 457, 1, 14, 14, 3, 16);
+	ghost_animation = sprite_atlas_add_sequence(&sheet_atlas, "ghost", 585, 65, 14, 14, 2, 16);
 }
 
 int main(void)
@@ -365,9 +210,28 @@ int main(void)
 	sprite_batch sb;
 	sprite_batch_init(&sb, &d3d);
 
+	frame_arena_thread_init("render", render_scratch_bytes);
+
 	// Load assets
 	texture sprite_sheet;
 	load_sprite_sheet(&sprite_sheet, &d3d);
+	sprite_layer_add(&sb.static_layer, maze_sprite, 0, 0, display_scale);
+
+	// Ghost first so pathman is drawn on top
+	entity_store_init(&entities, 2);
+	const entity_desc ghost = {{13, 17}, ghost_animation, 8, UINT16_MAX};
+	const entity_desc pathman = {{1, 1}, pathman_animation, 8, pathman_move_period};
+	ghost_entity = entity_create(&entities, &ghost);
+	pathman_entity = entity_create(&entities, &pathman);
+
+	// Initialise pathfinding state for the maze, with landmarks so the estimate knows about walls
+	path_landmarks_build(&pathman_landmarks, &maze_grid, path_landmark_max);
+	path_schedule_init(&pathman_schedule, &maze_grid, &pathman_landmarks, 1, 1, 256);
+
+	// Once running the frame loop should not need to allocate, report any frame that does
+	alloc_profile_set_budget(0, 0, false);
+
+	std::thread sim_thread(simulate);
 
 	// Main loop
 	bool quit = false;
@@ -377,6 +241,10 @@ int main(void)
 		MSG msg;
 		while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
 		{
+			// Key presses are passed on to the simulation, a full queue drops the press
+			if (msg.message == WM_KEYDOWN)
+				spsc_queue_push(&sim_inputs, {(uint32_t)msg.wParam});
+
 			switch (msg.message)
 			{
 			case WM_QUIT:
@@ -391,17 +259,31 @@ int main(void)
 		begin_frame(&d3d);
 
 		// Rendering code goes here
-		render(&d3d, &sb, &sprite_sheet);
+		render(&d3d, &sb, &sheet_atlas);
 
 		end_frame(&d3d);
+
+		alloc_profile_frame_end();
 	}
 
+	sim_quit = true;
+	sim_thread.join();
+
+	path_schedule_term(&pathman_schedule);
+	path_landmarks_term(&pathman_landmarks);
+	entity_store_term(&entities);
+
 	// Release D3D objects in order to shut down cleanly
 	sprite_sheet.buffer->Release();
 	sprite_sheet.srv->Release();
 	sprite_batch_term(&sb);
 	term_d3d(&d3d);
 
+	frame_arena_report(frame_scratch());
+	frame_arena_thread_term();
+
+	alloc_profile_report_leaks();
+
 	// Tell windows to terminate the application process and return a successful error code
 	ExitProcess(0);
 }
\ No newline at end of file
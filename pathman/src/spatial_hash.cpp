@@ -0,0 +1,207 @@
+static uint32_t spatial_hash_cell(const spatial_hash* sh, tile_pos pos)
+{
+	assert(pos.x >= 0 && pos.y >= 0 && (pos.x >> sh->cell_shift) < sh->columns && (pos.y >> sh->cell_shift) < sh->rows);
+	return (uint32_t)(((pos.y >> sh->cell_shift) * sh->columns) + (pos.x >> sh->cell_shift));
+}
+
+static void spatial_hash_unlink(spatial_hash* sh, uint32_t id)
+{
+	const uint32_t next = sh->overflow_next[id];
+	const uint32_t prev = sh->overflow_prev[id];
+
+	if (prev != spatial_hash_none)
+		sh->overflow_next[prev] = next;
+	else
+		sh->overflow_head[sh->cells[id]] = next;
+
+	if (next != spatial_hash_none)
+		sh->overflow_prev[next] = prev;
+
+	sh->moved--;
+}
+
+static void spatial_hash_link(spatial_hash* sh, uint32_t id, uint32_t cell)
+{
+	const uint32_t head = sh->overflow_head[cell];
+
+	sh->overflow_next[id] = head;
+	sh->overflow_prev[id] = spatial_hash_none;
+	if (head != spatial_hash_none)
+		sh->overflow_prev[head] = id;
+	sh->overflow_head[cell] = id;
+
+	sh->moved++;
+}
+
+// An entity is on its bucket's overflow list whenever its bucket differs from the sorted one
+static bool spatial_hash_overflowed(const spatial_hash* sh, uint32_t id)
+{
+	return sh->cells[id] != spatial_hash_none && sh->cells[id] != sh->sorted_cells[id];
+}
+
+void spatial_hash_init(spatial_hash* sh, int32_t width, int32_t height, uint32_t cell_shift, uint32_t max_entities)
+{
+	alloc_tag("spatial_hash");
+
+	const int32_t cell_size = 1 << cell_shift;
+
+	sh->columns = (width + cell_size - 1) >> cell_shift;
+	sh->rows = (height + cell_size - 1) >> cell_shift;
+	sh->cell_shift = cell_shift;
+	sh->moved = 0;
+
+	const size_t cell_count = (size_t)sh->columns * sh->rows;
+	sh->cell_first.assign(cell_count + 1, 0);
+	sh->cell_entities.clear();
+	sh->cell_entities.reserve(max_entities);
+	sh->overflow_head.assign(cell_count, spatial_hash_none);
+
+	sh->positions.assign(max_entities, {0, 0});
+	sh->cells.assign(max_entities, spatial_hash_none);
+	sh->sorted_cells.assign(max_entities, spatial_hash_none);
+	sh->overflow_next.assign(max_entities, spatial_hash_none);
+	sh->overflow_prev.assign(max_entities, spatial_hash_none);
+}
+
+void spatial_hash_term(spatial_hash* sh)
+{
+	std::vector<uint32_t>().swap(sh->cell_first);
+	std::vector<uint32_t>().swap(sh->cell_entities);
+	std::vector<uint32_t>().swap(sh->overflow_head);
+	std::vector<tile_pos>().swap(sh->positions);
+	std::vector<uint32_t>().swap(sh->cells);
+	std::vector<uint32_t>().swap(sh->sorted_cells);
+	std::vector<uint32_t>().swap(sh->overflow_next);
+	std::vector<uint32_t>().swap(sh->overflow_prev);
+}
+
+void spatial_hash_insert(spatial_hash* sh, uint32_t id, tile_pos pos)
+{
+	assert(id < sh->cells.size() && sh->cells[id] == spatial_hash_none);
+
+	sh->positions[id] = pos;
+	sh->cells[id] = spatial_hash_cell(sh, pos);
+
+	// Ids removed and inserted again may still be in the sorted bucket they had before
+	if (sh->cells[id] != sh->sorted_cells[id])
+		spatial_hash_link(sh, id, sh->cells[id]);
+}
+
+void spatial_hash_move(spatial_hash* sh, uint32_t id, tile_pos pos)
+{
+	assert(spatial_hash_contains(sh, id));
+
+	sh->positions[id] = pos;
+
+	const uint32_t cell = spatial_hash_cell(sh, pos);
+	if (cell == sh->cells[id])
+		return;
+
+	if (spatial_hash_overflowed(sh, id))
+		spatial_hash_unlink(sh, id);
+
+	sh->cells[id] = cell;
+	if (cell != sh->sorted_cells[id])
+		spatial_hash_link(sh, id, cell);
+}
+
+void spatial_hash_remove(spatial_hash* sh, uint32_t id)
+{
+	assert(spatial_hash_contains(sh, id));
+
+	if (spatial_hash_overflowed(sh, id))
+		spatial_hash_unlink(sh, id);
+
+	// Any stale copy in the sorted buckets is skipped by queries until the next rebuild
+	sh->cells[id] = spatial_hash_none;
+}
+
+void spatial_hash_rebuild(spatial_hash* sh)
+{
+	alloc_tag("spatial_hash");
+
+	const uint32_t entity_count = (uint32_t)sh->cells.size();
+	const size_t cell_count = sh->overflow_head.size();
+	uint32_t* first = sh->cell_first.data();
+
+	// Counting sort: bucket sizes, then a prefix sum, then scatter in id order
+	std::fill(sh->cell_first.begin(), sh->cell_first.end(), 0);
+	for (uint32_t id = 0; id < entity_count; id++)
+	{
+		if (sh->cells[id] != spatial_hash_none)
+			first[sh->cells[id] + 1]++;
+	}
+
+	for (size_t cell = 0; cell < cell_count; cell++)
+		first[cell + 1] += first[cell];
+
+	sh->cell_entities.resize(first[cell_count]);
+	for (uint32_t id = 0; id < entity_count; id++)
+	{
+		const uint32_t cell = sh->cells[id];
+		if (cell != spatial_hash_none)
+			sh->cell_entities[first[cell]++] = id;
+		sh->sorted_cells[id] = cell;
+	}
+
+	// The scatter advanced each start to the next bucket's, shift them back down
+	for (size_t cell = cell_count; cell > 0; cell--)
+		first[cell] = first[cell - 1];
+	first[0] = 0;
+
+	if (sh->moved)
+	{
+		std::fill(sh->overflow_head.begin(), sh->overflow_head.end(), spatial_hash_none);
+		sh->moved = 0;
+	}
+}
+
+/*
+	Calls visit for every entity in the bucket, first the sorted entries still in it and then those
+	that moved in since the last rebuild.
+*/
+template<typename Visit>
+static void spatial_hash_visit_cell(const spatial_hash* sh, uint32_t cell, const Visit& visit)
+{
+	const uint32_t* cells = sh->cells.data();
+
+	for (uint32_t i = sh->cell_first[cell], end = sh->cell_first[cell + 1]; i < end; i++)
+	{
+		const uint32_t id = sh->cell_entities[i];
+		if (cells[id] == cell)
+			visit(id);
+	}
+
+	for (uint32_t id = sh->overflow_head[cell]; id != spatial_hash_none; id = sh->overflow_next[id])
+		visit(id);
+}
+
+void spatial_hash_query_tile(const spatial_hash* sh, tile_pos pos, std::vector<uint32_t>* ids)
+{
+	spatial_hash_visit_cell(sh, spatial_hash_cell(sh, pos), [&](uint32_t id)
+	{
+		if (sh->positions[id].x == pos.x && sh->positions[id].y == pos.y)
+			ids->push_back(id);
+	});
+}
+
+void spatial_hash_query_radius(const spatial_hash* sh, tile_pos center, int32_t radius, std::vector<uint32_t>* ids)
+{
+	// Clamp the bounding square of the diamond to the buckets, the map edge may cut it off
+	const int32_t min_column = std::max(center.x - radius, 0) >> sh->cell_shift;
+	const int32_t min_row = std::max(center.y - radius, 0) >> sh->cell_shift;
+	const int32_t max_column = std::min((center.x + radius) >> sh->cell_shift, sh->columns - 1);
+	const int32_t max_row = std::min((center.y + radius) >> sh->cell_shift, sh->rows - 1);
+
+	for (int32_t row = min_row; row <= max_row; row++)
+	{
+		for (int32_t column = min_column; column <= max_column; column++)
+		{
+			spatial_hash_visit_cell(sh, (uint32_t)((row * sh->columns) + column), [&](uint32_t id)
+			{
+				if (manhattan_distance(sh->positions[id], center) <= radius)
+					ids->push_back(id);
+			});
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+	Uniform grid of buckets over the tile map for "who is on or near this tile" queries between
+	entities such as ghosts, pellets and players.
+
+	Each bucket covers a square of (1 << cell_shift) tiles on a side. Entity ids are small integers
+	chosen by the caller, and their positions live in the hash.
+
+	Buckets are stored contiguously. spatial_hash_rebuild counting sorts every entity by bucket into
+	one array, normally once per tick. Between rebuilds entities can still be inserted, moved and
+	removed one at a time. An entity that leaves the bucket it was sorted into is skipped there and
+	linked onto a short per-bucket overflow list instead, so queries stay exact without a rebuild
+	and the array only needs sorting again once enough entities have moved.
+*/
+constexpr uint32_t spatial_hash_none = UINT32_MAX;
+
+struct spatial_hash
+{
+	int32_t					columns;			// Buckets across and down
+	int32_t					rows;
+	uint32_t				cell_shift;
+	uint32_t				moved;				// Entities on overflow lists since the last rebuild
+
+	// Contiguous buckets from the last rebuild, cell_first has an end entry
+	std::vector<uint32_t>	cell_first;
+	std::vector<uint32_t>	cell_entities;
+
+	// Entities moved into a bucket since the last rebuild, doubly linked through the entity arrays
+	std::vector<uint32_t>	overflow_head;
+
+	// Per entity, indexed by id
+	std::vector<tile_pos>	positions;
+	std::vector<uint32_t>	cells;				// Current bucket, spatial_hash_none if not in the hash
+	std::vector<uint32_t>	sorted_cells;		// Bucket it was sorted into by the last rebuild
+	std::vector<uint32_t>	overflow_next;
+	std::vector<uint32_t>	overflow_prev;
+};
+
+void spatial_hash_init(spatial_hash* sh, int32_t width, int32_t height, uint32_t cell_shift, uint32_t max_entities);
+void spatial_hash_term(spatial_hash* sh);
+
+// Positions must be on the map given to spatial_hash_init
+void spatial_hash_insert(spatial_hash* sh, uint32_t id, tile_pos pos);
+void spatial_hash_move(spatial_hash* sh, uint32_t id, tile_pos pos);
+void spatial_hash_remove(spatial_hash* sh, uint32_t id);
+
+// Sorts every entity back into the contiguous buckets and empties the overflow lists
+void spatial_hash_rebuild(spatial_hash* sh);
+
+// Append the ids of entities on the tile, or within radius moves of center ignoring walls
+void spatial_hash_query_tile(const spatial_hash* sh, tile_pos pos, std::vector<uint32_t>* ids);
+void spatial_hash_query_radius(const spatial_hash* sh, tile_pos center, int32_t radius, std::vector<uint32_t>* ids);
+
+inline bool spatial_hash_contains(const spatial_hash* sh, uint32_t id)
+{
+	return sh->cells[id] != spatial_hash_none;
+}
\ No newline at end of file
@@ -0,0 +1,2 @@
+#!/bin/sh
+../../common/build/build_linux.sh pathserver release
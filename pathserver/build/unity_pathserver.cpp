@@ -0,0 +1,29 @@
+#include "../../common/src/headless.h"
+
+// Pathfinding headers shared with pathman
+#include "../../pathman/src/path_find.h"
+#include "../../pathman/src/path_packed.h"
+#include "../../pathman/src/path_landmarks.h"
+#include "../../pathman/src/path_search.h"
+#include "../../pathman/src/path_prune.h"
+#include "../../pathman/src/path_first_moves.h"
+#include "../../pathman/src/path_bounds.h"
+#include "../../pathman/src/maze.h"
+#include "../../pathman/src/maze_gen.h"
+
+// Server headers
+#include "../../pathserver/src/path_protocol.h"
+#include "../../pathserver/src/path_client.h"
+#include "../../pathserver/src/path_server.h"
+
+// Our cpp files to be compiled
+#include "../../pathman/src/path_find.cpp"
+#include "../../pathman/src/path_packed.cpp"
+#include "../../pathman/src/path_landmarks.cpp"
+#include "../../pathman/src/path_prune.cpp"
+#include "../../pathman/src/path_first_moves.cpp"
+#include "../../pathman/src/path_bounds.cpp"
+#include "../../pathman/src/maze_gen.cpp"
+#include "../../pathserver/src/path_client.cpp"
+#include "../../pathserver/src/path_server.cpp"
+#include "../../pathserver/src/pathserver.cpp"
\ No newline at end of file
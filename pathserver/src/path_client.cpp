@@ -0,0 +1,110 @@
+bool path_client_connect(path_client* client, const char* socket_path)
+{
+	client->fd = -1;
+	client->next_id = 0;
+	client->send_buffer.clear();
+	client->receive_buffer.resize(64 * 1024);
+	client->receive_used = 0;
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (strlen(socket_path) >= sizeof(address.sun_path))
+		return false;
+	strcpy(address.sun_path, socket_path);
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return false;
+
+	if (connect(fd, (const sockaddr*)&address, sizeof(address)) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	client->fd = fd;
+	return true;
+}
+
+void path_client_close(path_client* client)
+{
+	if (client->fd >= 0)
+		close(client->fd);
+	client->fd = -1;
+}
+
+uint32_t path_client_send(path_client* client, const path_query* query, bool want_path)
+{
+	path_request_msg request = {};
+	request.id = client->next_id++;
+	request.start_x = (uint16_t)query->start.x;
+	request.start_y = (uint16_t)query->start.y;
+	request.goal_x = (uint16_t)query->goal.x;
+	request.goal_y = (uint16_t)query->goal.y;
+	request.mode = query->mode;
+	request.flags = want_path ? path_request_want_path : 0;
+	request.weight = query->weight;
+
+	const uint8_t* bytes = (const uint8_t*)&request;
+	client->send_buffer.insert(client->send_buffer.end(), bytes, bytes + sizeof(request));
+
+	return request.id;
+}
+
+bool path_client_flush(path_client* client)
+{
+	size_t sent = 0;
+	while (sent < client->send_buffer.size())
+	{
+		const ssize_t result = send(client->fd, client->send_buffer.data() + sent, client->send_buffer.size() - sent, MSG_NOSIGNAL);
+		if (result <= 0)
+			return false;
+		sent += (size_t)result;
+	}
+
+	client->send_buffer.clear();
+	return true;
+}
+
+// Blocks until at least count bytes have been received
+static bool path_client_fill(path_client* client, size_t count)
+{
+	if (client->receive_buffer.size() < count)
+		client->receive_buffer.resize(count);
+
+	while (client->receive_used < count)
+	{
+		const ssize_t result = recv(client->fd, client->receive_buffer.data() + client->receive_used, client->receive_buffer.size() - client->receive_used, 0);
+		if (result <= 0)
+			return false;
+		client->receive_used += (size_t)result;
+	}
+
+	return true;
+}
+
+bool path_client_receive(path_client* client, path_client_result* result)
+{
+	if (!path_client_fill(client, sizeof(path_response_msg)))
+		return false;
+
+	path_response_msg response;
+	memcpy(&response, client->receive_buffer.data(), sizeof(response));
+
+	const size_t packed_bytes = path_protocol_moves_bytes(response.moves);
+	const size_t total = sizeof(response) + packed_bytes;
+	if (!path_client_fill(client, total))
+		return false;
+
+	result->id = response.id;
+	result->status = (path_response_status)response.status;
+	result->cost = response.cost;
+	result->moves = response.moves;
+	result->packed_moves.assign(client->receive_buffer.data() + sizeof(response), client->receive_buffer.data() + total);
+
+	// Keep any bytes of following responses that arrived in the same read
+	memmove(client->receive_buffer.data(), client->receive_buffer.data() + total, client->receive_used - total);
+	client->receive_used -= total;
+
+	return true;
+}
\ No newline at end of file
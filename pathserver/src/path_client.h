@@ -0,0 +1,36 @@
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*
+	Client side of the pathserver protocol. Requests are queued with path_client_send, written
+	with path_client_flush and answered in any order by path_client_receive, so a client can keep
+	many queries in flight on one connection. Calls block, so use one client per thread.
+*/
+struct path_client
+{
+	int						fd;
+	uint32_t				next_id;
+	std::vector<uint8_t>	send_buffer;
+	std::vector<uint8_t>	receive_buffer;
+	size_t					receive_used;		// Bytes of receive_buffer holding data
+};
+
+struct path_client_result
+{
+	uint32_t				id;
+	path_response_status	status;
+	uint32_t				cost;
+	uint32_t				moves;
+	std::vector<uint8_t>	packed_moves;		// Unpack with path_protocol_unpack_moves
+};
+
+bool path_client_connect(path_client* client, const char* socket_path);
+void path_client_close(path_client* client);
+
+// Queues a request and returns its id, nothing is sent until path_client_flush
+uint32_t path_client_send(path_client* client, const path_query* query, bool want_path);
+bool path_client_flush(path_client* client);
+
+// Waits for the next response. Returns false if the connection was closed or failed
+bool path_client_receive(path_client* client, path_client_result* result);
\ No newline at end of file
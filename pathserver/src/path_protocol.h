@@ -0,0 +1,83 @@
+/*
+	Binary protocol spoken by pathserver over a Unix domain stream socket.
+
+	Clients send fixed size path_request_msg records and may send any number of them without
+	waiting for answers. Each request gets one path_response_msg, followed when a path was asked
+	for by the moves packed four to a byte as 2 bit tile_direction values, first move in the low
+	bits. The server batches requests, so responses to one client can come back in a different
+	order to its requests and are matched up by id. All fields are little endian.
+*/
+constexpr const char* path_protocol_default_socket = "/tmp/pathserver.sock";
+
+enum path_request_flags : uint8_t
+{
+	path_request_want_path = 0x01	// Send the moves, otherwise only the cost
+};
+
+enum path_response_status : uint8_t
+{
+	path_response_found,
+	path_response_no_path,
+	path_response_invalid		// An end of the query is off the map
+};
+
+#pragma pack(push, 1)
+struct path_request_msg
+{
+	uint32_t	id;
+	uint16_t	start_x;
+	uint16_t	start_y;
+	uint16_t	goal_x;
+	uint16_t	goal_y;
+	uint8_t		mode;		// path_mode
+	uint8_t		flags;		// path_request_flags
+	uint16_t	weight;		// path_query weight for the suboptimal modes, 0 for the default
+};
+
+struct path_response_msg
+{
+	uint32_t	id;
+	uint8_t		status;		// path_response_status
+	uint8_t		reserved[3];
+	uint32_t	cost;
+	uint32_t	moves;		// Number of packed moves following, zero when no path was asked for
+};
+#pragma pack(pop)
+
+static_assert(sizeof(path_request_msg) == 16, "request layout changed");
+static_assert(sizeof(path_response_msg) == 16, "response layout changed");
+
+inline size_t path_protocol_moves_bytes(uint32_t moves)
+{
+	return (moves + 3) / 4;
+}
+
+// Appends the moves between consecutive path tiles, packed four to a byte
+inline void path_protocol_pack_moves(const std::vector<tile_pos>& path, std::vector<uint8_t>* out)
+{
+	const size_t first = out->size();
+	const uint32_t moves = path.empty() ? 0 : (uint32_t)path.size() - 1;
+	out->resize(first + path_protocol_moves_bytes(moves), 0);
+
+	for (uint32_t i = 0; i < moves; i++)
+	{
+		const int32_t dx = path[i + 1].x - path[i].x;
+		const int32_t dy = path[i + 1].y - path[i].y;
+		const uint8_t direction = dy < 0 ? tile_direction_up : dy > 0 ? tile_direction_down : dx < 0 ? tile_direction_left : tile_direction_right;
+		(*out)[first + (i / 4)] |= direction << ((i % 4) * 2);
+	}
+}
+
+// Rebuilds the tiles of a path from its start and packed moves
+inline void path_protocol_unpack_moves(tile_pos start, const uint8_t* packed, uint32_t moves, std::vector<tile_pos>* path)
+{
+	path->clear();
+	path->push_back(start);
+
+	for (uint32_t i = 0; i < moves; i++)
+	{
+		const uint32_t direction = (packed[i / 4] >> ((i % 4) * 2)) & 3;
+		const tile_pos last = path->back();
+		path->push_back({last.x + tile_direction_dx[direction], last.y + tile_direction_dy[direction]});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,396 @@
+static const uint64_t path_server_listen_tag = UINT64_MAX;
+static const uint64_t path_server_timer_tag = UINT64_MAX - 1;
+
+static void path_server_watch(path_server* server, int op, int fd, uint32_t events, uint64_t tag)
+{
+	epoll_event event = {};
+	event.events = events;
+	event.data.u64 = tag;
+	epoll_ctl(server->epoll_fd, op, fd, &event);
+}
+
+static void path_server_close(path_server* server, uint32_t index)
+{
+	path_server_connection* connection = &server->connections[index];
+
+	epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr);
+	close(connection->fd);
+
+	connection->fd = -1;
+	connection->generation++;
+	connection->in.clear();
+	connection->in_read = 0;
+	connection->out.clear();
+	connection->out_sent = 0;
+	connection->events = 0;
+}
+
+// Reads while the unsent responses are under the high water mark, and watches for writability while any are left
+static void path_server_update_events(path_server* server, uint32_t index)
+{
+	path_server_connection* connection = &server->connections[index];
+	const size_t unsent = connection->out.size() - connection->out_sent;
+
+	uint32_t events = 0;
+	if (unsent < path_server_out_high_water)
+		events |= EPOLLIN | EPOLLRDHUP;
+	if (unsent)
+		events |= EPOLLOUT;
+
+	if (events != connection->events)
+	{
+		connection->events = events;
+		path_server_watch(server, EPOLL_CTL_MOD, connection->fd, events, index);
+	}
+}
+
+static void path_server_accept(path_server* server)
+{
+	for (;;)
+	{
+		const int fd = accept4(server->listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+			return;
+
+		// Reuse a closed slot so indices held by the epoll registrations stay small and stable
+		uint32_t index = 0;
+		while (index < server->connections.size() && server->connections[index].fd >= 0)
+			index++;
+		if (index == server->connections.size())
+			server->connections.push_back({-1, 0, {}, 0, {}, 0, 0, 0});
+
+		path_server_connection* connection = &server->connections[index];
+		connection->fd = fd;
+		connection->events = EPOLLIN | EPOLLRDHUP;
+		server->stats.connections++;
+
+		path_server_watch(server, EPOLL_CTL_ADD, fd, connection->events, index);
+	}
+}
+
+// Sends as much queued output as the socket takes, then updates what the connection waits for
+static void path_server_flush(path_server* server, uint32_t index)
+{
+	path_server_connection* connection = &server->connections[index];
+
+	while (connection->out_sent < connection->out.size())
+	{
+		const ssize_t result = send(connection->fd, connection->out.data() + connection->out_sent, connection->out.size() - connection->out_sent, MSG_NOSIGNAL);
+		if (result < 0)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				break;
+
+			path_server_close(server, index);
+			return;
+		}
+		connection->out_sent += (size_t)result;
+	}
+
+	if (connection->out_sent == connection->out.size())
+	{
+		connection->out.clear();
+		connection->out_sent = 0;
+	}
+	else if (connection->out_sent >= path_server_compact_bytes)
+	{
+		connection->out.erase(connection->out.begin(), connection->out.begin() + connection->out_sent);
+		connection->out_sent = 0;
+	}
+
+	path_server_update_events(server, index);
+}
+
+static void path_server_arm_timer(path_server* server)
+{
+	itimerspec timer = {};
+	timer.it_value.tv_sec = server->config.batch_window_us / 1000000;
+	timer.it_value.tv_nsec = (long)(server->config.batch_window_us % 1000000) * 1000;
+	timerfd_settime(server->timer_fd, 0, &timer, nullptr);
+	server->timer_armed = true;
+}
+
+static void path_server_disarm_timer(path_server* server)
+{
+	const itimerspec timer = {};
+	timerfd_settime(server->timer_fd, 0, &timer, nullptr);
+	server->timer_armed = false;
+}
+
+/*
+	Reads what is available, up to path_server_read_max so one busy client cannot hold up the
+	loop, and queues each whole request into the batch. Anything left in the socket wakes the
+	loop again.
+*/
+static void path_server_read(path_server* server, uint32_t index)
+{
+	path_server_connection* connection = &server->connections[index];
+	uint8_t buffer[16 * 1024];
+
+	for (size_t received = 0; received < path_server_read_max;)
+	{
+		const ssize_t result = recv(connection->fd, buffer, sizeof(buffer), 0);
+		if (result == 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+		{
+			path_server_close(server, index);
+			return;
+		}
+		if (result < 0)
+			break;
+
+		connection->in.insert(connection->in.end(), buffer, buffer + result);
+		received += (size_t)result;
+	}
+
+	const size_t count = (connection->in.size() - connection->in_read) / sizeof(path_request_msg);
+	for (size_t i = 0; i < count; i++)
+	{
+		path_server_pending pending;
+		pending.connection = index;
+		pending.generation = connection->generation;
+		memcpy(&pending.request, connection->in.data() + connection->in_read, sizeof(path_request_msg));
+		connection->in_read += sizeof(path_request_msg);
+		server->batch.push_back(pending);
+	}
+	server->stats.requests += count;
+
+	// Moving a partial request to the front is left until enough has been consumed to be worth it
+	if (connection->in_read == connection->in.size())
+	{
+		connection->in.clear();
+		connection->in_read = 0;
+	}
+	else if (connection->in_read >= path_server_compact_bytes)
+	{
+		connection->in.erase(connection->in.begin(), connection->in.begin() + connection->in_read);
+		connection->in_read = 0;
+	}
+
+	if (count && server->config.batch_window_us && !server->timer_armed)
+		path_server_arm_timer(server);
+}
+
+static bool path_server_pending_before(const path_server_pending& a, const path_server_pending& b)
+{
+	if (a.request.goal_y != b.request.goal_y)
+		return a.request.goal_y < b.request.goal_y;
+	if (a.request.goal_x != b.request.goal_x)
+		return a.request.goal_x < b.request.goal_x;
+	if (a.request.start_y != b.request.start_y)
+		return a.request.start_y < b.request.start_y;
+	return a.request.start_x < b.request.start_x;
+}
+
+static void path_server_process_batch(path_server* server)
+{
+	if (server->timer_armed)
+		path_server_disarm_timer(server);
+
+	if (server->batch.empty())
+		return;
+
+	std::sort(server->batch.begin(), server->batch.end(), path_server_pending_before);
+	server->touched.clear();
+
+	for (const path_server_pending& pending : server->batch)
+	{
+		path_server_connection* connection = &server->connections[pending.connection];
+		if (connection->fd < 0 || connection->generation != pending.generation)
+			continue;
+
+		const path_request_msg& request = pending.request;
+		const path_query query = {{request.start_x, request.start_y}, {request.goal_x, request.goal_y}, (path_mode)request.mode, request.weight};
+
+		path_response_msg response = {};
+		response.id = request.id;
+
+		const bool valid =
+			query.start.x < server->grid->width && query.start.y < server->grid->height &&
+			query.goal.x < server->grid->width && query.goal.y < server->grid->height &&
+			request.mode <= path_mode_anytime;
+
+		path_stats stats;
+		if (!valid)
+			response.status = path_response_invalid;
+		else if (!path_find(&server->finder, &query, &server->path, &stats))
+			response.status = path_response_no_path;
+		else
+		{
+			response.status = path_response_found;
+			response.cost = stats.cost;
+			if (request.flags & path_request_want_path)
+				response.moves = stats.cost;
+		}
+
+		if (connection->batch != server->stats.batches + 1)
+		{
+			connection->batch = server->stats.batches + 1;
+			server->touched.push_back(pending.connection);
+		}
+
+		const uint8_t* bytes = (const uint8_t*)&response;
+		connection->out.insert(connection->out.end(), bytes, bytes + sizeof(response));
+		if (response.moves)
+			path_protocol_pack_moves(server->path, &connection->out);
+	}
+
+	server->batch.clear();
+	server->stats.batches++;
+
+	// A connection already waiting for writability is flushed when it comes, but may now be past the high water mark
+	for (uint32_t index : server->touched)
+	{
+		if (server->connections[index].fd < 0)
+			continue;
+
+		if (server->connections[index].events & EPOLLOUT)
+			path_server_update_events(server, index);
+		else
+			path_server_flush(server, index);
+	}
+}
+
+static void path_server_close_fds(path_server* server)
+{
+	if (server->timer_fd >= 0)
+		close(server->timer_fd);
+	if (server->epoll_fd >= 0)
+		close(server->epoll_fd);
+	if (server->listen_fd >= 0)
+		close(server->listen_fd);
+
+	server->timer_fd = -1;
+	server->epoll_fd = -1;
+	server->listen_fd = -1;
+}
+
+/*
+	Removes a socket file left by a server that did not shut down cleanly, which would block the
+	bind. Only a refused connection shows nobody is listening; false if a server answers.
+*/
+static bool path_server_clear_stale(const sockaddr_un* address)
+{
+	const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (probe < 0)
+		return false;
+
+	// Non-blocking, so a listener with a full backlog gives EAGAIN rather than blocking
+	const int result = connect(probe, (const sockaddr*)address, sizeof(*address));
+	const int error = errno;
+	close(probe);
+
+	if (result == 0 || error == EAGAIN)
+		return false;
+	if (error == ECONNREFUSED)
+		unlink(address->sun_path);
+
+	return true;
+}
+
+bool path_server_init(path_server* server, const tile_grid* grid, const path_landmarks* landmarks, const path_server_config* config)
+{
+	server->config = *config;
+	server->grid = grid;
+	server->listen_fd = -1;
+	server->epoll_fd = -1;
+	server->timer_fd = -1;
+	server->timer_armed = false;
+	server->stats = {};
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (strlen(config->socket_path) >= sizeof(address.sun_path))
+		return false;
+	strcpy(address.sun_path, config->socket_path);
+
+	if (!path_server_clear_stale(&address))
+		return false;
+
+	server->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	server->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+	if (server->listen_fd < 0 || server->epoll_fd < 0 || server->timer_fd < 0 ||
+		bind(server->listen_fd, (const sockaddr*)&address, sizeof(address)) != 0)
+	{
+		path_server_close_fds(server);
+		return false;
+	}
+
+	if (listen(server->listen_fd, 128) != 0)
+	{
+		path_server_close_fds(server);
+		unlink(config->socket_path);
+		return false;
+	}
+
+	path_server_watch(server, EPOLL_CTL_ADD, server->listen_fd, EPOLLIN, path_server_listen_tag);
+	path_server_watch(server, EPOLL_CTL_ADD, server->timer_fd, EPOLLIN, path_server_timer_tag);
+
+	path_finder_init(&server->finder, grid);
+	server->finder.landmarks = landmarks;
+
+	return true;
+}
+
+void path_server_term(path_server* server)
+{
+	for (uint32_t i = 0; i < server->connections.size(); i++)
+	{
+		if (server->connections[i].fd >= 0)
+			path_server_close(server, i);
+	}
+
+	path_server_close_fds(server);
+	unlink(server->config.socket_path);
+
+	path_finder_term(&server->finder);
+}
+
+void path_server_run(path_server* server, const volatile sig_atomic_t* stop)
+{
+	epoll_event events[64];
+
+	while (!*stop)
+	{
+		// Wake up now and then to notice stop even with no traffic
+		const int count = epoll_wait(server->epoll_fd, events, 64, 100);
+
+		bool window_closed = false;
+		for (int i = 0; i < count; i++)
+		{
+			const uint64_t tag = events[i].data.u64;
+			if (tag == path_server_listen_tag)
+				path_server_accept(server);
+			else if (tag == path_server_timer_tag)
+			{
+				uint64_t expirations;
+				if (read(server->timer_fd, &expirations, sizeof(expirations)) > 0)
+					window_closed = true;
+			}
+			else
+			{
+				const uint32_t index = (uint32_t)tag;
+				if (server->connections[index].fd < 0)
+					continue;
+
+				if (events[i].events & EPOLLOUT)
+					path_server_flush(server, index);
+				if (server->connections[index].fd < 0)
+					continue;
+
+				// A connection past the high water mark is not read, but one that hung up is still closed
+				if (server->connections[index].events & EPOLLIN)
+				{
+					if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+						path_server_read(server, index);
+				}
+				else if (events[i].events & (EPOLLHUP | EPOLLERR))
+					path_server_close(server, index);
+			}
+		}
+
+		if (window_closed || server->config.batch_window_us == 0 || server->batch.size() >= server->config.batch_max)
+			path_server_process_batch(server);
+	}
+}
\ No newline at end of file
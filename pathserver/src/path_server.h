@@ -0,0 +1,83 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+/*
+	Path query server. One process holds a warmed up finder and landmark tables for a map and
+	answers path_request_msg records from any number of clients over a Unix domain socket.
+
+	The server is a single threaded epoll loop. Requests are not searched as they are read but
+	gathered into a batch, which is processed once batch_window_us has passed since its first
+	request or it reaches batch_max requests. A batch is sorted by goal so queries toward the same
+	area run back to back with warm caches, and each connection's responses from the batch go out
+	in a single send.
+
+	A client that sends requests but does not read the responses stops being read from once its
+	unsent responses pass path_server_out_high_water, so its requests wait in the socket and the
+	client blocks in send rather than the server buffering without limit.
+*/
+constexpr size_t path_server_out_high_water = 1024 * 1024;
+constexpr size_t path_server_read_max = 64 * 1024;		// Bytes read from one connection per wakeup
+constexpr size_t path_server_compact_bytes = 64 * 1024;	// Consumed bytes at the front of a buffer before it is compacted
+
+struct path_server_config
+{
+	const char*	socket_path;
+	uint32_t	batch_window_us;	// Zero processes whatever each wakeup read straight away
+	uint32_t	batch_max;
+};
+
+struct path_server_connection
+{
+	int						fd;				// -1 for a free slot
+	uint32_t				generation;		// Bumped on close so batched requests for a dead connection are dropped
+	std::vector<uint8_t>	in;				// Received bytes, whole requests before in_read already batched
+	size_t					in_read;
+	std::vector<uint8_t>	out;			// Responses, those before out_sent already sent
+	size_t					out_sent;
+	uint32_t				events;			// Registered epoll events, EPOLLOUT while the socket is full and no EPOLLIN past the high water mark
+	uint64_t				batch;			// Last batch to queue responses, counting from one, so it is listed in touched once
+};
+
+struct path_server_pending
+{
+	uint32_t			connection;
+	uint32_t			generation;
+	path_request_msg	request;
+};
+
+struct path_server_stats
+{
+	uint64_t connections;
+	uint64_t requests;
+	uint64_t batches;
+};
+
+struct path_server
+{
+	path_server_config					config;
+	const tile_grid*					grid;
+	path_finder							finder;
+	int									listen_fd;
+	int									epoll_fd;
+	int									timer_fd;		// Fires when the current batch window closes
+	bool								timer_armed;
+	std::vector<path_server_connection>	connections;
+	std::vector<path_server_pending>	batch;
+	std::vector<uint32_t>				touched;		// Connections with responses from the current batch
+	std::vector<tile_pos>				path;
+	path_server_stats					stats;
+};
+
+/*
+	Landmarks are optional and must outlive the server. Fails without leaving anything to clean
+	up when the socket cannot be bound, including when another server is listening on the path.
+	A socket file left by a server that did not shut down cleanly is replaced.
+*/
+bool path_server_init(path_server* server, const tile_grid* grid, const path_landmarks* landmarks, const path_server_config* config);
+void path_server_term(path_server* server);
+
+// Serves requests until stop becomes non-zero, for example from a signal handler
+void path_server_run(path_server* server, const volatile sig_atomic_t* stop);
\ No newline at end of file
@@ -0,0 +1,490 @@
+#include <chrono>
+#include <thread>
+#include <sys/wait.h>
+
+/*
+	Path query server and load generator.
+
+		pathserver serve [--socket path] [--map spec] [--batch-us n] [--batch-max n]
+		pathserver load  [--socket path] [--map spec] [--clients n] [--depth n] [--seconds n] [--mode m] [--weight n]
+		pathserver bench [--map spec] [--depth n] [--seconds n]
+
+	A map spec is "shipped" for the Path-Man maze, "maze:<kind>:<size>[:seed]" for a generated
+	maze, or the name of a text file holding the width and height followed by one tile_flags value
+	per tile in the hex form used by tile_map. The load generator must be given the same map as the
+	server so it picks open tiles.
+
+	bench starts a server in a child process and runs the load generator against it with 1, 8 and
+	64 clients, once with batching and once answering each read straight away.
+*/
+
+struct server_map
+{
+	tile_grid				grid;
+	std::vector<uint8_t>	tiles;
+};
+
+struct server_options
+{
+	const char*	socket_path = path_protocol_default_socket;
+	const char*	map = "shipped";
+	uint32_t	batch_us = 200;
+	uint32_t	batch_max = 256;
+	uint32_t	clients = 0;		// Zero runs 1, 8 and 64 clients in turn
+	uint32_t	depth = 16;
+	double		seconds = 3.0;
+	path_mode	mode = path_mode_astar;
+	uint16_t	weight = 0;
+};
+
+// Indexed by path_mode
+static const char* const server_mode_names[] = {"astar", "bidirectional", "weighted", "focal", "anytime"};
+
+static volatile sig_atomic_t server_stop;
+
+static void server_handle_signal(int)
+{
+	server_stop = 1;
+}
+
+static double server_time_us()
+{
+	using namespace std::chrono;
+	return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool server_load_map(server_map* map, const char* spec)
+{
+	if (strcmp(spec, "shipped") == 0)
+	{
+		map->tiles.assign(tile_map, tile_map + (tile_map_width * tile_map_height));
+		map->grid = {tile_map_width, tile_map_height, map->tiles.data()};
+		return true;
+	}
+
+	if (strncmp(spec, "maze:", 5) == 0)
+	{
+		char kind_name[32] = {};
+		int32_t size = 0;
+		unsigned long long seed = 1;
+		if (sscanf(spec + 5, "%31[^:]:%d:%llu", kind_name, &size, &seed) < 2 || size < 8)
+			return false;
+
+		for (uint32_t kind = 0; kind < maze_kind_count; kind++)
+		{
+			if (strcmp(kind_name, maze_kind_names[kind]) == 0)
+			{
+				maze_generate(&map->tiles, size, size, (maze_kind)kind, seed);
+				map->grid = {size, size, map->tiles.data()};
+				return true;
+			}
+		}
+		return false;
+	}
+
+	FILE* file = fopen(spec, "r");
+	if (!file)
+		return false;
+
+	int32_t width = 0;
+	int32_t height = 0;
+	bool valid = fscanf(file, "%d %d", &width, &height) == 2 && width > 0 && height > 0 && width <= 0xFFFF && height <= 0xFFFF;
+
+	map->tiles.resize(valid ? (size_t)width * height : 0);
+	for (size_t i = 0; valid && i < map->tiles.size(); i++)
+	{
+		// Values may be separated by commas as in tile_map
+		unsigned int value;
+		valid = fscanf(file, " %x ,", &value) == 1 && value <= 0xF;
+		map->tiles[i] = (uint8_t)(valid ? value : 0);
+	}
+	fclose(file);
+
+	map->grid = {width, height, map->tiles.data()};
+	return valid;
+}
+
+static bool server_parse_options(server_options* options, int argc, char** argv, int first)
+{
+	for (int i = first; i < argc; i++)
+	{
+		const char* name = argv[i];
+		const char* value = i + 1 < argc ? argv[++i] : nullptr;
+		if (!value)
+			return false;
+
+		if (strcmp(name, "--socket") == 0)
+			options->socket_path = value;
+		else if (strcmp(name, "--map") == 0)
+			options->map = value;
+		else if (strcmp(name, "--batch-us") == 0)
+			options->batch_us = (uint32_t)atoi(value);
+		else if (strcmp(name, "--batch-max") == 0)
+			options->batch_max = (uint32_t)std::max(1, atoi(value));
+		else if (strcmp(name, "--clients") == 0)
+			options->clients = (uint32_t)atoi(value);
+		else if (strcmp(name, "--depth") == 0)
+			options->depth = (uint32_t)std::max(1, atoi(value));
+		else if (strcmp(name, "--seconds") == 0)
+			options->seconds = atof(value);
+		else if (strcmp(name, "--mode") == 0)
+		{
+			options->mode = path_mode_astar;
+			for (uint32_t mode = 0; mode < sizeof(server_mode_names) / sizeof(server_mode_names[0]); mode++)
+			{
+				if (strcmp(value, server_mode_names[mode]) == 0)
+					options->mode = (path_mode)mode;
+			}
+		}
+		else if (strcmp(name, "--weight") == 0)
+			options->weight = (uint16_t)atoi(value);
+		else
+			return false;
+	}
+
+	return true;
+}
+
+static int server_serve(const server_options* options)
+{
+	server_map map;
+	if (!server_load_map(&map, options->map))
+	{
+		fprintf(stderr, "pathserver: cannot load map '%s'\n", options->map);
+		return 1;
+	}
+
+	path_landmarks landmarks;
+	path_landmarks_build(&landmarks, &map.grid, path_landmark_max);
+
+	const path_server_config config = {options->socket_path, options->batch_us, options->batch_max};
+	path_server server;
+	if (!path_server_init(&server, &map.grid, &landmarks, &config))
+	{
+		fprintf(stderr, "pathserver: cannot listen on '%s'\n", options->socket_path);
+		path_landmarks_term(&landmarks);
+		return 1;
+	}
+
+	// No SA_RESTART, so the signal also wakes epoll_wait
+	struct sigaction action = {};
+	action.sa_handler = server_handle_signal;
+	sigaction(SIGINT, &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+
+	printf("pathserver: %dx%d map on %s, batch window %u us, batch max %u\n", map.grid.width, map.grid.height, options->socket_path, options->batch_us, options->batch_max);
+	fflush(stdout);
+
+	path_server_run(&server, &server_stop);
+
+	printf("pathserver: %llu connections, %llu requests in %llu batches\n",
+		(unsigned long long)server.stats.connections, (unsigned long long)server.stats.requests, (unsigned long long)server.stats.batches);
+
+	path_server_term(&server);
+	path_landmarks_term(&landmarks);
+	return 0;
+}
+
+struct load_client_result
+{
+	std::vector<double>	latencies_us;
+	uint64_t			failed;			// Requests not answered with a path
+	bool				connected;
+};
+
+/*
+	One load generator thread. Keeps depth requests in flight on its own connection, sending a
+	new request for each response, until the time runs out and then waits for the rest.
+*/
+static void load_client_run(const server_options* options, const std::vector<tile_pos>* open_tiles, uint32_t seed, double end_us, load_client_result* result)
+{
+	path_client client;
+	result->connected = path_client_connect(&client, options->socket_path);
+	result->failed = 0;
+	if (!result->connected)
+		return;
+
+	maze_random rng;
+	maze_random_seed(&rng, seed);
+
+	// Requests ids are handed out in order, so send times are indexed by id
+	std::vector<double> send_us;
+	path_client_result response;
+	uint32_t in_flight = 0;
+
+	auto send_one = [&]()
+	{
+		const path_query query = {
+			(*open_tiles)[maze_random_next(&rng, (uint32_t)open_tiles->size())],
+			(*open_tiles)[maze_random_next(&rng, (uint32_t)open_tiles->size())],
+			options->mode,
+			options->weight
+		};
+		path_client_send(&client, &query, false);
+		send_us.push_back(server_time_us());
+		in_flight++;
+	};
+
+	for (uint32_t i = 0; i < options->depth; i++)
+		send_one();
+
+	bool ok = path_client_flush(&client);
+	while (ok && in_flight)
+	{
+		ok = path_client_receive(&client, &response);
+		if (!ok)
+			break;
+
+		const double now = server_time_us();
+		result->latencies_us.push_back(now - send_us[response.id]);
+		result->failed += response.status != path_response_found;
+		in_flight--;
+
+		if (now < end_us)
+		{
+			send_one();
+			ok = path_client_flush(&client);
+		}
+	}
+
+	path_client_close(&client);
+}
+
+static void server_print_load(uint32_t clients, const std::vector<load_client_result>& results, double elapsed_us)
+{
+	std::vector<double> latencies;
+	uint64_t failed = 0;
+	for (const load_client_result& result : results)
+	{
+		latencies.insert(latencies.end(), result.latencies_us.begin(), result.latencies_us.end());
+		failed += result.failed;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double fraction)
+	{
+		return latencies.empty() ? 0.0 : latencies[std::min((size_t)(fraction * latencies.size()), latencies.size() - 1)];
+	};
+
+	printf("  %3u clients  %9.0f req/s  p50 %8.1f us  p99 %8.1f us  p99.9 %8.1f us  (%zu requests, %llu unanswered)\n",
+		clients, latencies.size() / (elapsed_us / 1000000.0), percentile(0.5), percentile(0.99), percentile(0.999),
+		latencies.size(), (unsigned long long)failed);
+}
+
+static bool server_run_load(const server_options* options, const std::vector<tile_pos>& open_tiles, uint32_t clients)
+{
+	std::vector<load_client_result> results(clients);
+	std::vector<std::thread> threads;
+
+	const double start_us = server_time_us();
+	const double end_us = start_us + (options->seconds * 1000000.0);
+	for (uint32_t i = 0; i < clients; i++)
+		threads.emplace_back(load_client_run, options, &open_tiles, i + 1, end_us, &results[i]);
+	for (std::thread& thread : threads)
+		thread.join();
+	const double elapsed_us = server_time_us() - start_us;
+
+	for (const load_client_result& result : results)
+	{
+		if (!result.connected)
+		{
+			fprintf(stderr, "pathserver: cannot connect to '%s'\n", options->socket_path);
+			return false;
+		}
+	}
+
+	server_print_load(clients, results, elapsed_us);
+	return true;
+}
+
+static std::vector<tile_pos> server_open_tiles(const tile_grid* grid)
+{
+	std::vector<tile_pos> open_tiles;
+	for (int32_t y = 0; y < grid->height; y++)
+	{
+		for (int32_t x = 0; x < grid->width; x++)
+		{
+			if (tile_grid_get(grid, x, y) != tile_flags_wall)
+				open_tiles.push_back({x, y});
+		}
+	}
+
+	return open_tiles;
+}
+
+static int server_load(const server_options* options)
+{
+	server_map map;
+	if (!server_load_map(&map, options->map))
+	{
+		fprintf(stderr, "pathserver: cannot load map '%s'\n", options->map);
+		return 1;
+	}
+
+	const std::vector<tile_pos> open_tiles = server_open_tiles(&map.grid);
+	const uint32_t client_counts[3] = {1, 8, 64};
+
+	printf("load: %dx%d map, %u requests in flight per client, %.1f s per run\n", map.grid.width, map.grid.height, options->depth, options->seconds);
+	for (uint32_t counts = 0; counts < 3; counts++)
+	{
+		const uint32_t clients = options->clients ? options->clients : client_counts[counts];
+		if (!server_run_load(options, open_tiles, clients))
+			return 1;
+		if (options->clients)
+			break;
+	}
+
+	return 0;
+}
+
+/*
+	Asks for full paths between random tiles and checks each one against a local search: the
+	moves must stay on open tiles, end at the goal and be as short as the local path.
+*/
+static bool server_verify(const server_options* options, const server_map* map, uint32_t count)
+{
+	path_client client;
+	if (!path_client_connect(&client, options->socket_path))
+		return false;
+
+	const std::vector<tile_pos> open_tiles = server_open_tiles(&map->grid);
+	maze_random rng;
+	maze_random_seed(&rng, 99);
+
+	std::vector<path_query> queries(count);
+	for (path_query& query : queries)
+	{
+		query = {open_tiles[maze_random_next(&rng, (uint32_t)open_tiles.size())], open_tiles[maze_random_next(&rng, (uint32_t)open_tiles.size())], path_mode_astar};
+		path_client_send(&client, &query, true);
+	}
+
+	// One off the map, which must come back invalid
+	const path_query off_map = {{0, 0}, {map->grid.width, 0}, path_mode_astar};
+	path_client_send(&client, &off_map, true);
+
+	path_finder pf;
+	path_finder_init(&pf, &map->grid);
+
+	std::vector<tile_pos> path;
+	path_client_result response;
+	uint32_t mismatches = 0;
+	bool ok = path_client_flush(&client);
+	for (uint32_t i = 0; ok && i <= count; i++)
+	{
+		ok = path_client_receive(&client, &response);
+		if (!ok)
+			break;
+
+		if (response.id == count)
+		{
+			mismatches += response.status != path_response_invalid;
+			continue;
+		}
+
+		const path_query& query = queries[response.id];
+		path_stats stats;
+		const bool found = path_find(&pf, &query, &path, &stats);
+		if (!found || response.status != path_response_found || response.cost != stats.cost || response.moves != stats.cost)
+		{
+			mismatches++;
+			continue;
+		}
+
+		path_protocol_unpack_moves(query.start, response.packed_moves.data(), response.moves, &path);
+		for (const tile_pos& pos : path)
+			mismatches += tile_grid_get(&map->grid, pos.x, pos.y) == tile_flags_wall;
+		mismatches += path.back().x != query.goal.x || path.back().y != query.goal.y;
+	}
+
+	path_finder_term(&pf);
+	path_client_close(&client);
+
+	printf("verify: %u paths checked, %u mismatches\n", count, mismatches);
+	return ok && mismatches == 0;
+}
+
+static int server_bench(server_options* options)
+{
+	server_map map;
+	if (!server_load_map(&map, options->map))
+	{
+		fprintf(stderr, "pathserver: cannot load map '%s'\n", options->map);
+		return 1;
+	}
+
+	const std::vector<tile_pos> open_tiles = server_open_tiles(&map.grid);
+	const uint32_t batch_windows[2] = {options->batch_us, 0};
+	const uint32_t client_counts[3] = {1, 8, 64};
+
+	for (uint32_t batch_us : batch_windows)
+	{
+		options->batch_us = batch_us;
+
+		fflush(stdout);
+		const pid_t child = fork();
+		if (child == 0)
+		{
+			const int result = server_serve(options);
+			fflush(stdout);
+			_exit(result);
+		}
+
+		// Wait for the server to build its landmarks and start listening
+		bool listening = false;
+		for (uint32_t attempt = 0; attempt < 500 && !listening; attempt++)
+		{
+			path_client probe;
+			listening = path_client_connect(&probe, options->socket_path);
+			path_client_close(&probe);
+			if (!listening)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		bool ok = listening && (batch_us == 0 || server_verify(options, &map, 2000));
+		printf("load: batch window %u us, %u requests in flight per client, %.1f s per run\n", batch_us, options->depth, options->seconds);
+		for (uint32_t i = 0; ok && i < 3; i++)
+			ok = server_run_load(options, open_tiles, client_counts[i]);
+
+		kill(child, SIGTERM);
+		waitpid(child, nullptr, 0);
+
+		if (!ok)
+			return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	const char* command = argc > 1 ? argv[1] : "";
+
+	server_options options;
+	if (!server_parse_options(&options, argc, argv, 2))
+		command = "";
+
+	int result;
+	if (strcmp(command, "serve") == 0)
+		result = server_serve(&options);
+	else if (strcmp(command, "load") == 0)
+		result = server_load(&options);
+	else if (strcmp(command, "bench") == 0)
+		result = server_bench(&options);
+	else
+	{
+		printf("usage: pathserver <serve|load|bench> [options]\n");
+		printf("  --socket path     socket to listen on or connect to (%s)\n", path_protocol_default_socket);
+		printf("  --map spec        shipped, maze:<kind>:<size>[:seed] or a text map file (shipped)\n");
+		printf("  --batch-us n      serve: microseconds to gather a batch, 0 to answer at once (200)\n");
+		printf("  --batch-max n     serve: requests that end a batch early (256)\n");
+		printf("  --clients n       load: client threads, runs 1, 8 and 64 when not given\n");
+		printf("  --depth n         load: requests each client keeps in flight (16)\n");
+		printf("  --seconds n       load: length of each run (3)\n");
+		printf("  --mode m          load: astar, bidirectional, weighted, focal or anytime (astar)\n");
+		printf("  --weight n        load: path length bound of the suboptimal modes in hundredths (150)\n");
+		return 1;
+	}
+
+	alloc_profile_report_leaks();
+	return result;
+}
\ No newline at end of file